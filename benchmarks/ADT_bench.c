@@ -0,0 +1,457 @@
+///////////////////////////////////////////////////////////////////
+//
+// Benchmarks για τα ADTs
+//
+// Κάθε ADT γεμίζει με size στοιχεία (ακέραιοι 0..size-1, με τυχαία ή
+// αύξουσα σειρά ανάλογα με το --dates) και μετά γίνονται αναζητήσεις
+// με την κατανομή του --dist.
+//
+// Τα hash_* benchmarks γεμίζουν ένα map με κλειδιά διαφόρων μορφών (αύξοντες
+// ακεραίους, ακεραίους με βήμα, pointers, strings) και μετά από τις αναζητήσεις
+// τυπώνουν τα στατιστικά του (map_stats), ώστε να φαίνεται αν κάποια συνάρτηση
+// κατακερματισμού συγκεντρώνει τα κλειδιά σε λίγα buckets.
+//
+///////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "ADTVector.h"
+#include "ADTList.h"
+#include "ADTMap.h"
+#include "ADTSet.h"
+#include "ADTPriorityQueue.h"
+#include "ADTGraph.h"
+
+
+static int compare_ints(Pointer a, Pointer b) {
+	return *(int*)a - *(int*)b;
+}
+
+static int compare_pointers(Pointer a, Pointer b) {
+	return a != b;
+}
+
+// Πίνακας με τους ακεραίους 0..n-1, ανακατεμένους αν δεν ζητήθηκε αύξουσα σειρά
+
+static int* create_keys(BenchConfig* config, int n) {
+	int* keys = malloc(n * sizeof(int));
+	for (int i = 0; i < n; i++)
+		keys[i] = i;
+
+	if (!config->sorted_dates) {
+		for (int i = n - 1; i > 0; i--) {
+			int j = bench_random_int(i + 1);
+			int t = keys[i];
+			keys[i] = keys[j];
+			keys[j] = t;
+		}
+	}
+	return keys;
+}
+
+static void bench_vector(BenchConfig* config, int* keys, Sampler sampler) {
+	int n = config->size;
+	Vector vector = vector_create(0, NULL);
+	Bench bench;
+
+	bench_begin(&bench, "vector_insert_last", n);
+	for (int i = 0; i < n; i++) {
+		bench_op_begin(&bench);
+		vector_insert_last(vector, &keys[i]);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, "vector_get_at", n);
+	for (int i = 0; i < n; i++) {
+		int pos = sampler_next(sampler);
+		bench_op_begin(&bench);
+		vector_get_at(vector, pos);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, "vector_remove_last", n);
+	for (int i = 0; i < n; i++) {
+		bench_op_begin(&bench);
+		vector_remove_last(vector);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	vector_destroy(vector);
+}
+
+static void bench_list(BenchConfig* config, int* keys, Sampler sampler) {
+	int n = config->size;
+	List list = list_create(NULL);
+	Bench bench;
+
+	bench_begin(&bench, "list_insert_next", n);
+	for (int i = 0; i < n; i++) {
+		bench_op_begin(&bench);
+		list_insert_next(list, LIST_BOF, &keys[i]);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	// Η list_find είναι O(n), οπότε περιορίζουμε το πλήθος των αναζητήσεων
+	// ώστε το σύνολο να μένει γύρω στις 10^8 συγκρίσεις.
+	int finds = 100000000 / n;
+	if (finds > n)
+		finds = n;
+	if (finds < 10)
+		finds = 10;
+
+	bench_begin(&bench, "list_find", finds);
+	for (int i = 0; i < finds; i++) {
+		int key = sampler_next(sampler);
+		bench_op_begin(&bench);
+		list_find(list, &key, compare_ints);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, "list_remove_next", n);
+	for (int i = 0; i < n; i++) {
+		bench_op_begin(&bench);
+		list_remove_next(list, LIST_BOF);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	list_destroy(list);
+}
+
+// Τα ονόματα των benchmarks ενός map: map_<op> ή map_pow2_<op> ανάλογα με το sizing
+
+static String map_bench_name(char* buffer, MapSizing sizing, String op) {
+	sprintf(buffer, "map_%s%s", sizing == MAP_SIZING_POW2 ? "pow2_" : "", op);
+	return buffer;
+}
+
+static void bench_map(BenchConfig* config, int* keys, Sampler sampler, MapSizing sizing) {
+	int n = config->size;
+	Map map = map_create(compare_ints, NULL, NULL);
+	map_set_hash_function(map, hash_int);
+	map_set_sizing(map, sizing);
+	Bench bench;
+	char name[64];
+
+	bench_begin(&bench, map_bench_name(name, sizing, "insert"), n);
+	for (int i = 0; i < n; i++) {
+		bench_op_begin(&bench);
+		map_insert(map, &keys[i], &keys[i]);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, map_bench_name(name, sizing, "find"), n);
+	for (int i = 0; i < n; i++) {
+		int key = sampler_next(sampler);
+		bench_op_begin(&bench);
+		map_find(map, &key);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	// Αναζητήσεις κλειδιών που δεν υπάρχουν
+	bench_begin(&bench, map_bench_name(name, sizing, "find_missing"), n);
+	for (int i = 0; i < n; i++) {
+		int key = n + sampler_next(sampler);
+		bench_op_begin(&bench);
+		map_find(map, &key);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, map_bench_name(name, sizing, "remove"), n);
+	for (int i = 0; i < n; i++) {
+		bench_op_begin(&bench);
+		map_remove(map, &keys[i]);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	// "Αναζήτηση, και προσθήκη αν δεν υπάρχει" σε κενό map, με τα κλειδιά του sampler (που
+	// επαναλαμβάνονται, οπότε πολλά υπάρχουν ήδη), με find + insert και με την map_find_or_insert
+	int* values = malloc(n * sizeof(int));
+	for (int i = 0; i < n; i++)
+		values[i] = sampler_next(sampler);
+
+	bench_begin(&bench, map_bench_name(name, sizing, "find_then_insert"), n);
+	for (int i = 0; i < n; i++) {
+		bench_op_begin(&bench);
+		if (map_find(map, &values[i]) == NULL)
+			map_insert(map, &values[i], &values[i]);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	for (int i = 0; i < n; i++)
+		map_remove(map, &values[i]);
+
+	bench_begin(&bench, map_bench_name(name, sizing, "find_or_insert"), n);
+	for (int i = 0; i < n; i++) {
+		bench_op_begin(&bench);
+		map_find_or_insert(map, &values[i], NULL, NULL);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	map_destroy(map);
+	free(values);
+}
+
+static uint hash_identity(Pointer value) {
+	return *(int*)value;
+}
+
+// Γεμίζει ένα map με τα n κλειδιά, μετράει n αναζητήσεις και τυπώνει τα στατιστικά του
+
+static void bench_hash_sizing(String scenario, Pointer* keys, int n, CompareFunc compare, HashFunc hash,
+	Sampler sampler, MapSizing sizing) {
+
+	Map map = map_create(compare, NULL, NULL);
+	map_set_hash_function(map, hash);
+	map_set_sizing(map, sizing);
+	for (int i = 0; i < n; i++)
+		map_insert(map, keys[i], keys[i]);
+
+	String suffix = sizing == MAP_SIZING_POW2 ? "_pow2" : "";
+	char name[64];
+	snprintf(name, sizeof(name), "hash_%s%s_find", scenario, suffix);
+
+	Bench bench;
+	bench_begin(&bench, name, n);
+	for (int i = 0; i < n; i++) {
+		Pointer key = keys[sampler_next(sampler)];
+		bench_op_begin(&bench);
+		map_find(map, key);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	snprintf(name, sizeof(name), "hash_%s%s_stats", scenario, suffix);
+	bench_map_stats(name, map);
+
+	map_destroy(map);
+}
+
+// Κάθε σενάριο εκτελείται και με τα δύο είδη μεγέθους του hash table
+
+static void bench_hash(String scenario, Pointer* keys, int n, CompareFunc compare, HashFunc hash, Sampler sampler) {
+	bench_hash_sizing(scenario, keys, n, compare, hash, sampler, MAP_SIZING_PRIME);
+	bench_hash_sizing(scenario, keys, n, compare, hash, sampler, MAP_SIZING_POW2);
+}
+
+// Ακέραιοι i * stride (τα κλειδιά μένουν κάτω από 2^30 ώστε η compare_ints να μην υπερχειλίζει)
+
+static void bench_hash_ints(String scenario, int n, int stride, HashFunc hash, Sampler sampler) {
+	int* values = malloc(n * sizeof(int));
+	Pointer* keys = malloc(n * sizeof(Pointer));
+	for (int i = 0; i < n; i++) {
+		values[i] = stride > 0 ? ((uint)i * stride) & 0x3FFFFFFF : bench_random() >> 2;
+		keys[i] = &values[i];
+	}
+
+	bench_hash(scenario, keys, n, compare_ints, hash, sampler);
+	free(keys);
+	free(values);
+}
+
+static void bench_hash_all(BenchConfig* config, Sampler sampler) {
+	int n = config->size;
+
+	bench_hash_ints("int_sequential", n, 1, hash_int, sampler);
+	bench_hash_ints("int_stride_64", n, 64, hash_int, sampler);
+	bench_hash_ints("int_stride_1024", n, 1024, hash_int, sampler);
+	bench_hash_ints("int_random", n, 0, hash_int, sampler);
+
+	// Η τιμή του ακεραίου ως hash (όπως έκανε παλιά η hash_int): με MAP_SIZING_POW2 και
+	// βήμα 1024 χρησιμοποιούνται μόνο τα buckets που είναι πολλαπλάσια του 1024
+	bench_hash_ints("int_identity_stride_1024", n, 1024, hash_identity, sampler);
+
+	// Pointers σε ξεχωριστές δεσμεύσεις, όπως πχ οι κορυφές ενός γράφου
+	Pointer* keys = malloc(n * sizeof(Pointer));
+	for (int i = 0; i < n; i++)
+		keys[i] = malloc(16);
+	bench_hash("pointer", keys, n, compare_pointers, hash_pointer, sampler);
+	for (int i = 0; i < n; i++)
+		free(keys[i]);
+
+	// Strings με κοινό πρόθεμα, όπως πχ ονόματα ή κωδικοί
+	for (int i = 0; i < n; i++) {
+		keys[i] = malloc(24);
+		snprintf(keys[i], 24, "key-%08d", i);
+	}
+	bench_hash("string", keys, n, (CompareFunc) strcmp, hash_string, sampler);
+	for (int i = 0; i < n; i++)
+		free(keys[i]);
+	free(keys);
+}
+
+static void bench_set(BenchConfig* config, int* keys, Sampler sampler) {
+	int n = config->size;
+	Set set = set_create(compare_ints, NULL);
+	Bench bench;
+
+	bench_begin(&bench, "set_insert", n);
+	for (int i = 0; i < n; i++) {
+		bench_op_begin(&bench);
+		set_insert(set, &keys[i]);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, "set_find", n);
+	for (int i = 0; i < n; i++) {
+		int key = sampler_next(sampler);
+		bench_op_begin(&bench);
+		set_find(set, &key);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, "set_range_count", n);
+	for (int i = 0; i < n; i++) {
+		int from = sampler_next(sampler);
+		int to = from + bench_random_int(n - from);
+		bench_op_begin(&bench);
+		set_range_count(set, &from, &to);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	// Πλήρης διάσχιση, μία πράξη ανά κόμβο
+	bench_begin(&bench, "set_next", n);
+	for (SetNode node = set_first(set); node != SET_EOF; ) {
+		bench_op_begin(&bench);
+		node = set_next(set, node);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, "set_remove", n);
+	for (int i = 0; i < n; i++) {
+		bench_op_begin(&bench);
+		set_remove(set, &keys[i]);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	set_destroy(set);
+}
+
+static void bench_pqueue(BenchConfig* config, int* keys, Sampler sampler) {
+	int n = config->size;
+	PriorityQueue pqueue = pqueue_create(compare_ints, NULL, NULL);
+	Bench bench;
+
+	bench_begin(&bench, "pqueue_insert", n);
+	for (int i = 0; i < n; i++) {
+		bench_op_begin(&bench);
+		pqueue_insert(pqueue, &keys[i]);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	int top_k = n < 10000 ? n : 10000;
+	bench_begin(&bench, "pqueue_top_k", top_k);
+	for (int i = 0; i < top_k; i++) {
+		bench_op_begin(&bench);
+		List list = pqueue_top_k(pqueue, 10);
+		bench_op_end(&bench);
+		list_destroy(list);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, "pqueue_remove_max", n);
+	for (int i = 0; i < n; i++) {
+		bench_op_begin(&bench);
+		pqueue_remove_max(pqueue);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	pqueue_destroy(pqueue);
+}
+
+// Ο γράφος έχει το πολύ 10000 κορυφές (η graph_shortest_path είναι O(E logV) για κάθε
+// κλήση). Κάθε κορυφή i συνδέεται με τις i+1, i+17 και i+131 (mod V) με τυχαία βάρη, οπότε
+// ο γράφος είναι συνεκτικός και δεν υπάρχουν διπλές ακμές (το V είναι τουλάχιστον 300).
+
+#define GRAPH_MAX_VERTICES 10000
+#define GRAPH_PATHS 100
+
+static void bench_graph(BenchConfig* config) {
+	int n = config->size < GRAPH_MAX_VERTICES ? config->size : GRAPH_MAX_VERTICES;
+	if (n < 300)
+		n = 300;
+
+	int* vertices = malloc(n * sizeof(int));
+	Graph graph = graph_create(compare_pointers, NULL);
+	graph_set_hash_function(graph, hash_pointer);
+	Bench bench;
+
+	bench_begin(&bench, "graph_insert_vertex", n);
+	for (int i = 0; i < n; i++) {
+		vertices[i] = i;
+		bench_op_begin(&bench);
+		graph_insert_vertex(graph, &vertices[i]);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	int offsets[] = { 1, 17, 131 };
+	bench_begin(&bench, "graph_insert_edge", 3 * n);
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < 3; j++) {
+			uint weight = 1 + bench_random_int(100);
+			bench_op_begin(&bench);
+			graph_insert_edge(graph, &vertices[i], &vertices[(i + offsets[j]) % n], weight);
+			bench_op_end(&bench);
+		}
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, "graph_shortest_path", GRAPH_PATHS);
+	for (int i = 0; i < GRAPH_PATHS; i++) {
+		Pointer source = &vertices[bench_random_int(n)];
+		Pointer target = &vertices[bench_random_int(n)];
+		bench_op_begin(&bench);
+		List path = graph_shortest_path(graph, source, target);
+		bench_op_end(&bench);
+		list_destroy(path);
+	}
+	bench_end(&bench);
+
+	graph_destroy(graph);
+	free(vertices);
+}
+
+int main(int argc, char* argv[]) {
+	BenchConfig config;
+	bench_parse_args(&config, argc, argv);
+
+	int* keys = create_keys(&config, config.size);
+	Sampler sampler = sampler_create(&config, config.size);
+
+	bench_output_begin("ADT_bench", &config);
+	bench_vector(&config, keys, sampler);
+	bench_list(&config, keys, sampler);
+	bench_map(&config, keys, sampler, MAP_SIZING_PRIME);
+	bench_map(&config, keys, sampler, MAP_SIZING_POW2);
+	bench_hash_all(&config, sampler);
+	bench_set(&config, keys, sampler);
+	bench_pqueue(&config, keys, sampler);
+	bench_graph(&config);
+	bench_output_end();
+
+	sampler_destroy(sampler);
+	free(keys);
+	return 0;
+}
@@ -0,0 +1,201 @@
+///////////////////////////////////////////////////////////////////
+//
+// Benchmarks για το ADTConcurrentMap
+//
+// Ενα map με size ακεραίους δέχεται πράξεις από 1, 2, 4 και 8 threads
+// ταυτόχρονα, σε κλειδιά ομοιόμορφα στο [0, 2*size). Στο read_only όλες
+// οι πράξεις είναι αναζητήσεις, στο read_mostly το 10% είναι προσθήκες ή
+// αφαιρέσεις. Για σύγκριση, οι ίδιες πράξεις γίνονται σε ένα ADTMap που
+// προστατεύεται από ένα rwlock. Κάθε αποτέλεσμα έχει το συνολικό throughput
+// και το speedup ως προς το 1 thread.
+//
+// Τα threads δεν χρησιμοποιούν τον Sampler (δεν είναι thread-safe), αλλά
+// δική τους γεννήτρια, οπότε το --dist δεν επηρεάζει τα benchmarks αυτά.
+//
+///////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+
+#include "bench.h"
+#include "ADTConcurrentMap.h"
+#include "ADTMap.h"
+
+#define MAX_THREADS 8
+#define OPS_PER_THREAD 1000000
+
+static int compare_ints(Pointer a, Pointer b) {
+	return *(int*)a - *(int*)b;
+}
+
+// Τα κλειδιά 0..2*size-1. Οι πράξεις δεν δεσμεύουν μνήμη, το map δείχνει σε αυτόν τον πίνακα.
+
+static int* keys;
+static int key_no;
+
+typedef enum {
+	MIX_READ_ONLY,
+	MIX_READ_MOSTLY
+} Mix;
+
+struct worker {
+	uint64_t random;			// Κατάσταση της γεννήτριας (xorshift)
+	Mix mix;
+	ConcurrentMap cmap;
+	Map map;
+	pthread_rwlock_t* lock;
+	pthread_barrier_t* start;
+	long found;					// Ωστε να μην αφαιρεθούν οι αναζητήσεις από τον compiler
+};
+
+static uint worker_random(struct worker* worker) {
+	uint64_t x = worker->random;
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	worker->random = x;
+	return x >> 32;
+}
+
+// Ενα στα 10 (read_mostly): προσθήκη ή αφαίρεση, αλλιώς αναζήτηση
+
+static bool worker_writes(struct worker* worker, uint r) {
+	return worker->mix == MIX_READ_MOSTLY && (r >> 24) % 10 == 0;
+}
+
+static void* cmap_worker(void* arg) {
+	struct worker* worker = arg;
+	cmap_thread_register();
+	pthread_barrier_wait(worker->start);
+
+	for (int i = 0; i < OPS_PER_THREAD; i++) {
+		uint r = worker_random(worker);
+		int* key = &keys[r % key_no];
+
+		if (worker_writes(worker, r)) {
+			if (r & 1)
+				cmap_insert(worker->cmap, key, key);
+			else
+				cmap_remove(worker->cmap, key);
+		} else {
+			worker->found += cmap_find(worker->cmap, key) != NULL;
+		}
+	}
+
+	cmap_thread_unregister();
+	return NULL;
+}
+
+static void* map_worker(void* arg) {
+	struct worker* worker = arg;
+	pthread_barrier_wait(worker->start);
+
+	for (int i = 0; i < OPS_PER_THREAD; i++) {
+		uint r = worker_random(worker);
+		int* key = &keys[r % key_no];
+
+		if (worker_writes(worker, r)) {
+			pthread_rwlock_wrlock(worker->lock);
+			if (r & 1)
+				map_insert(worker->map, key, key);
+			else
+				map_remove(worker->map, key);
+		} else {
+			pthread_rwlock_rdlock(worker->lock);
+			worker->found += map_find(worker->map, key) != NULL;
+		}
+		pthread_rwlock_unlock(worker->lock);
+	}
+	return NULL;
+}
+
+// Εκτελεί τον benchmark με threads threads και επιστρέφει το throughput
+
+static double run(String name, Mix mix, bool concurrent, int threads, double base_ops_per_sec) {
+	ConcurrentMap cmap = NULL;
+	Map map = NULL;
+	pthread_rwlock_t lock;
+
+	// Τα μισά κλειδιά υπάρχουν αρχικά
+	if (concurrent) {
+		cmap = cmap_create(compare_ints, hash_int, NULL, NULL);
+		for (int i = 0; i < key_no; i += 2)
+			cmap_insert(cmap, &keys[i], &keys[i]);
+	} else {
+		map = map_create(compare_ints, NULL, NULL);
+		map_set_hash_function(map, hash_int);
+		map_set_sizing(map, MAP_SIZING_POW2);
+		for (int i = 0; i < key_no; i += 2)
+			map_insert(map, &keys[i], &keys[i]);
+		pthread_rwlock_init(&lock, NULL);
+	}
+
+	pthread_barrier_t start;
+	pthread_barrier_init(&start, NULL, threads + 1);
+
+	struct worker workers[MAX_THREADS];
+	pthread_t ids[MAX_THREADS];
+	for (int i = 0; i < threads; i++) {
+		workers[i] = (struct worker){
+			.random = 0x9E3779B97F4A7C15ULL * (i + 1) + bench_random(),
+			.mix = mix,
+			.cmap = cmap,
+			.map = map,
+			.lock = &lock,
+			.start = &start,
+		};
+		pthread_create(&ids[i], NULL, concurrent ? cmap_worker : map_worker, &workers[i]);
+	}
+
+	pthread_barrier_wait(&start);
+	uint64_t begin = bench_now();
+	for (int i = 0; i < threads; i++)
+		pthread_join(ids[i], NULL);
+	uint64_t elapsed = bench_now() - begin;
+
+	double ops_per_sec = bench_throughput(name, threads, (long)threads * OPS_PER_THREAD, elapsed, base_ops_per_sec);
+
+	pthread_barrier_destroy(&start);
+	if (concurrent) {
+		cmap_destroy(cmap);
+	} else {
+		map_destroy(map);
+		pthread_rwlock_destroy(&lock);
+	}
+	return ops_per_sec;
+}
+
+static void bench_scaling(String name, Mix mix, bool concurrent) {
+	double base = 0;
+	for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+		double ops_per_sec = run(name, mix, concurrent, threads, base);
+		if (threads == 1)
+			base = ops_per_sec;
+	}
+}
+
+
+int main(int argc, char* argv[]) {
+	BenchConfig config;
+	bench_parse_args(&config, argc, argv);
+
+	key_no = 2 * config.size;
+	keys = malloc(key_no * sizeof(int));
+	for (int i = 0; i < key_no; i++)
+		keys[i] = i;
+
+	// Το main thread δημιουργεί και καταστρέφει τα concurrent maps
+	cmap_thread_register();
+
+	bench_output_begin("ConcurrentMap_bench", &config);
+	bench_scaling("cmap_read_only", MIX_READ_ONLY, true);
+	bench_scaling("cmap_read_mostly", MIX_READ_MOSTLY, true);
+	bench_scaling("rwlock_map_read_only", MIX_READ_ONLY, false);
+	bench_scaling("rwlock_map_read_mostly", MIX_READ_MOSTLY, false);
+	bench_output_end();
+
+	cmap_thread_unregister();
+	free(keys);
+	return 0;
+}
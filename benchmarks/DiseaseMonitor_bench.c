@@ -0,0 +1,319 @@
+///////////////////////////////////////////////////////////////////
+//
+// Benchmarks για το DiseaseMonitor
+//
+// Δημιουργούνται size εγγραφές σε COUNTRY_NO χώρες, DISEASE_NO ασθένειες
+// και DAY_NO ημέρες. Οι χώρες και οι ασθένειες επιλέγονται με την κατανομή
+// του --dist (με Zipf λίγες χώρες/ασθένειες έχουν τις περισσότερες εγγραφές),
+// και οι ημερομηνίες είναι τυχαίες ή σε αύξουσα σειρά (--dates).
+//
+///////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "bench.h"
+#include "DiseaseMonitor.h"
+
+#define COUNTRY_NO 200
+#define DISEASE_NO 50
+#define DAY_NO 1096			// 2020-01-01 μέχρι 2022-12-31
+
+static char countries[COUNTRY_NO][16];
+static char diseases[DISEASE_NO][16];
+static char dates[DAY_NO][11];
+
+// Τα queries ενός benchmark επιλέγουν χώρα/ασθένεια με την ίδια κατανομή με τις
+// εγγραφές (άρα με Zipf ρωτάμε κυρίως για τις μεγάλες χώρες/ασθένειες).
+
+static Sampler country_sampler;
+static Sampler disease_sampler;
+
+static void create_names() {
+	for (int i = 0; i < COUNTRY_NO; i++)
+		sprintf(countries[i], "Country%03d", i);
+	for (int i = 0; i < DISEASE_NO; i++)
+		sprintf(diseases[i], "Disease%02d", i);
+
+	int days_in_month[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	int year = 2020, month = 0, day = 1;
+	for (int i = 0; i < DAY_NO; i++) {
+		sprintf(dates[i], "%04d-%02d-%02d", year, month + 1, day);
+
+		bool leap = year % 4 == 0;
+		if (++day > days_in_month[month] + (month == 1 && leap)) {
+			day = 1;
+			if (++month == 12) {
+				month = 0;
+				year++;
+			}
+		}
+	}
+}
+
+static Record create_records(BenchConfig* config) {
+	int n = config->size;
+	Record records = malloc(n * sizeof(*records));
+
+	for (int i = 0; i < n; i++) {
+		records[i].id = i;
+		records[i].name = "Name";
+		records[i].country = countries[sampler_next(country_sampler)];
+		records[i].disease = diseases[sampler_next(disease_sampler)];
+		records[i].date = dates[config->sorted_dates ? (long)i * DAY_NO / n : bench_random_int(DAY_NO)];
+	}
+	return records;
+}
+
+// Τυχαίο εύρος ημερομηνιών με μήκος το πολύ max_days
+
+static void random_range(int max_days, Date* date_from, Date* date_to) {
+	int from = bench_random_int(DAY_NO);
+	int to = from + bench_random_int(max_days);
+	*date_from = dates[from];
+	*date_to = dates[to < DAY_NO ? to : DAY_NO - 1];
+}
+
+// Πλήθος πράξεων για ένα query που κοστίζει O(n): ώστε το σύνολο να μένει γύρω στις 10^8 εγγραφές
+
+static int linear_ops(int n) {
+	int ops = 100000000 / n;
+	return ops < 10 ? 10 : ops > 1000 ? 1000 : ops;
+}
+
+static void bench_insert(BenchConfig* config, Record records) {
+	Bench bench;
+	bench_begin(&bench, "dm_insert_record", config->size);
+	for (int i = 0; i < config->size; i++) {
+		bench_op_begin(&bench);
+		dm_insert_record(&records[i]);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+}
+
+static void bench_queries(BenchConfig* config) {
+	int n = config->size;
+	Bench bench;
+	Date date_from, date_to;
+
+	bench_begin(&bench, "dm_count_records_range", n);
+	for (int i = 0; i < n; i++) {
+		random_range(90, &date_from, &date_to);
+		bench_op_begin(&bench);
+		dm_count_records(NULL, NULL, date_from, date_to);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, "dm_count_records_country", n);
+	for (int i = 0; i < n; i++) {
+		String country = countries[sampler_next(country_sampler)];
+		random_range(90, &date_from, &date_to);
+		bench_op_begin(&bench);
+		dm_count_records(NULL, country, date_from, date_to);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, "dm_count_records_pair", n);
+	for (int i = 0; i < n; i++) {
+		String country = countries[sampler_next(country_sampler)];
+		String disease = diseases[sampler_next(disease_sampler)];
+		random_range(90, &date_from, &date_to);
+		bench_op_begin(&bench);
+		dm_count_records(disease, country, date_from, date_to);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	int list_ops = n < 10000 ? n : 10000;
+	bench_begin(&bench, "dm_get_records", list_ops);
+	for (int i = 0; i < list_ops; i++) {
+		String country = countries[sampler_next(country_sampler)];
+		String disease = diseases[sampler_next(disease_sampler)];
+		random_range(30, &date_from, &date_to);
+		bench_op_begin(&bench);
+		List list = dm_get_records(disease, country, date_from, date_to);
+		bench_op_end(&bench);
+		list_destroy(list);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, "dm_records_cursor", list_ops);
+	for (int i = 0; i < list_ops; i++) {
+		String country = countries[sampler_next(country_sampler)];
+		String disease = diseases[sampler_next(disease_sampler)];
+		random_range(30, &date_from, &date_to);
+		bench_op_begin(&bench);
+		DmCursor cursor;
+		dm_records_cursor(&cursor, disease, country, date_from, date_to);
+		while (dm_cursor_next(&cursor) != NULL)
+			;
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, "dm_top_diseases", n);
+	for (int i = 0; i < n; i++) {
+		// Μία στις 10 φορές για όλες τις χώρες
+		String country = i % 10 == 0 ? NULL : countries[sampler_next(country_sampler)];
+		bench_op_begin(&bench);
+		List list = dm_top_diseases(10, country);
+		bench_op_end(&bench);
+		list_destroy(list);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, "dm_top_diseases_range", list_ops);
+	for (int i = 0; i < list_ops; i++) {
+		String country = countries[sampler_next(country_sampler)];
+		random_range(90, &date_from, &date_to);
+		bench_op_begin(&bench);
+		List list = dm_top_diseases_range(10, country, date_from, date_to);
+		bench_op_end(&bench);
+		list_destroy(list);
+	}
+	bench_end(&bench);
+
+	bench_begin(&bench, "dm_percentile_date", n);
+	for (int i = 0; i < n; i++) {
+		String country = countries[sampler_next(country_sampler)];
+		random_range(365, &date_from, &date_to);
+		bench_op_begin(&bench);
+		dm_percentile_date(NULL, country, date_from, date_to, 50);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+
+	// Φίλτρο με 3 χώρες και 2 ασθένειες. Η πρώτη κλήση φτιάχνει τις στήλες και μετράει ξεχωριστά.
+	int ops = linear_ops(n);
+	for (int round = 0; round < 2; round++) {
+		bench_begin(&bench, round == 0 ? "dm_count_where_first" : "dm_count_where", round == 0 ? 1 : ops);
+		for (int i = 0; i < (round == 0 ? 1 : ops); i++) {
+			String filter_countries[3], filter_diseases[2];
+			for (int j = 0; j < 3; j++)
+				filter_countries[j] = countries[sampler_next(country_sampler)];
+			for (int j = 0; j < 2; j++)
+				filter_diseases[j] = diseases[sampler_next(disease_sampler)];
+			random_range(365, &date_from, &date_to);
+
+			DmFilter filter = { filter_countries, 3, filter_diseases, 2, date_from, date_to };
+			bench_op_begin(&bench);
+			dm_count_where(&filter);
+			bench_op_end(&bench);
+		}
+		bench_end(&bench);
+	}
+}
+
+#define SNAPSHOT_OPS 10
+#define FILE_OPS 5
+
+static void bench_snapshot() {
+	Bench bench;
+	bench_begin(&bench, "dm_snapshot", SNAPSHOT_OPS);
+	for (int i = 0; i < SNAPSHOT_OPS; i++) {
+		bench_op_begin(&bench);
+		DiseaseMonitor snapshot = dm_snapshot();
+		bench_op_end(&bench);
+		dm_free(snapshot);
+	}
+	bench_end(&bench);
+}
+
+static void bench_save(String path) {
+	Bench bench;
+	bench_begin(&bench, "dm_save", FILE_OPS);
+	for (int i = 0; i < FILE_OPS; i++) {
+		bench_op_begin(&bench);
+		dm_save(path);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+}
+
+static void bench_load(String path) {
+	Bench bench;
+	bench_begin(&bench, "dm_load", FILE_OPS);
+	for (int i = 0; i < FILE_OPS; i++) {
+		bench_op_begin(&bench);
+		dm_load(path);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+}
+
+static void bench_remove(BenchConfig* config) {
+	Bench bench;
+	bench_begin(&bench, "dm_remove_record", config->size);
+	for (int i = 0; i < config->size; i++) {
+		bench_op_begin(&bench);
+		dm_remove_record(i);
+		bench_op_end(&bench);
+	}
+	bench_end(&bench);
+}
+
+static void bench_ingest(BenchConfig* config, Record records, String path) {
+	FILE* file = fopen(path, "w");
+	fprintf(file, "id,name,disease,country,date\n");
+	for (int i = 0; i < config->size; i++)
+		fprintf(file, "%d,%s,%s,%s,%s\n",
+			records[i].id, records[i].name, records[i].disease, records[i].country, records[i].date);
+	fclose(file);
+
+	Bench bench;
+	bench_begin(&bench, "dm_ingest_csv", FILE_OPS);
+	for (int i = 0; i < FILE_OPS; i++) {
+		dm_init();
+		int fd = open(path, O_RDONLY);
+		bench_op_begin(&bench);
+		dm_ingest_csv(fd, NULL);
+		bench_op_end(&bench);
+		close(fd);
+	}
+	bench_end(&bench);
+}
+
+int main(int argc, char* argv[]) {
+	BenchConfig config;
+	bench_parse_args(&config, argc, argv);
+
+	create_names();
+	country_sampler = sampler_create(&config, COUNTRY_NO);
+	disease_sampler = sampler_create(&config, DISEASE_NO);
+	Record records = create_records(&config);
+
+	char path[] = "/tmp/dm_bench_XXXXXX";
+	close(mkstemp(path));
+
+	bench_output_begin("DiseaseMonitor_bench", &config);
+
+	dm_init();
+	bench_insert(&config, records);
+	bench_queries(&config);
+	bench_snapshot();
+	bench_save(path);
+	bench_remove(&config);
+	bench_load(path);
+	bench_ingest(&config, records, path);
+
+	Bench bench;
+	bench_begin(&bench, "dm_destroy", 1);
+	bench_op_begin(&bench);
+	dm_destroy();
+	bench_op_end(&bench);
+	bench_end(&bench);
+
+	bench_output_end();
+
+	unlink(path);
+	free(records);
+	sampler_destroy(country_sampler);
+	sampler_destroy(disease_sampler);
+	return 0;
+}
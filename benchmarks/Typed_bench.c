@@ -0,0 +1,245 @@
+///////////////////////////////////////////////////////////////////
+//
+// Benchmarks για τα typed ADTs, σε σύγκριση με τα generic
+//
+// Οι ίδιες πράξεις γίνονται σε ένα generic ADT (τιμές Pointer, σύγκριση
+// και hash μέσω pointers σε συναρτήσεις) και στο αντίστοιχο typed (DEFINE_*,
+// τιμές by value, inline σύγκριση), με τα ίδια κλειδιά και τις ίδιες
+// αναζητήσεις. Οι πράξεις είναι λίγα ns, οπότε μετράται μόνο ο συνολικός
+// χρόνος (bench_end_batch). Τα generic_* παίρνουν pointers σε έναν έτοιμο
+// πίνακα ακεραίων, οπότε η διαφορά δεν οφείλεται σε malloc (εκτός από το
+// map_count, όπου κάθε μετρητής του generic map είναι ένας int* με malloc).
+//
+///////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "bench.h"
+#include "ADTVector.h"
+#include "ADTMap.h"
+#include "ADTSet.h"
+#include "ADTPriorityQueue.h"
+#include "ADTTypedVector.h"
+#include "ADTTypedMap.h"
+#include "ADTTypedSet.h"
+#include "ADTTypedPriorityQueue.h"
+
+
+static int compare_ints(Pointer a, Pointer b) {
+	return *(int*)a - *(int*)b;
+}
+
+static int compare_int_values(int a, int b) {
+	return a - b;
+}
+
+DEFINE_VECTOR(int)
+DEFINE_MAP(uint32_t, int, hash_u32, eq_u32)
+DEFINE_SET(int, compare_int_values)
+DEFINE_PQUEUE(int, compare_int_values)
+
+// Τα αποτελέσματα των αναζητήσεων, ώστε να μην αφαιρεθούν από τον compiler
+static volatile long sink;
+
+// Οι ακέραιοι 0..n-1, ανακατεμένοι αν δεν ζητήθηκε αύξουσα σειρά
+
+static int* create_keys(BenchConfig* config, int n) {
+	int* keys = malloc(n * sizeof(int));
+	for (int i = 0; i < n; i++)
+		keys[i] = i;
+
+	if (!config->sorted_dates) {
+		for (int i = n - 1; i > 0; i--) {
+			int j = bench_random_int(i + 1);
+			int t = keys[i];
+			keys[i] = keys[j];
+			keys[j] = t;
+		}
+	}
+	return keys;
+}
+
+// Οι αναζητήσεις υπολογίζονται από πριν, ώστε ο Sampler να μην μετράει στον χρόνο
+
+static int* create_queries(Sampler sampler, int n) {
+	int* queries = malloc(n * sizeof(int));
+	for (int i = 0; i < n; i++)
+		queries[i] = sampler_next(sampler);
+	return queries;
+}
+
+static Pointer create_counter(Pointer key) {
+	return calloc(1, sizeof(int));
+}
+
+
+static void bench_vector(int n, int* keys, int* queries) {
+	Bench bench;
+	long sum = 0;
+
+	Vector vector = vector_create(0, NULL);
+	bench_begin(&bench, "generic_vector_insert_last", n);
+	for (int i = 0; i < n; i++)
+		vector_insert_last(vector, &keys[i]);
+	bench_end_batch(&bench);
+
+	bench_begin(&bench, "generic_vector_get_at", n);
+	for (int i = 0; i < n; i++)
+		sum += *(int*)vector_get_at(vector, queries[i]);
+	bench_end_batch(&bench);
+	vector_destroy(vector);
+
+	Vector_int typed = vector_int_create(0);
+	bench_begin(&bench, "typed_vector_insert_last", n);
+	for (int i = 0; i < n; i++)
+		vector_int_insert_last(typed, keys[i]);
+	bench_end_batch(&bench);
+
+	bench_begin(&bench, "typed_vector_get_at", n);
+	for (int i = 0; i < n; i++)
+		sum += vector_int_get_at(typed, queries[i]);
+	bench_end_batch(&bench);
+	vector_int_destroy(typed);
+
+	sink = sum;
+}
+
+static void bench_map(int n, int* keys, int* queries) {
+	Bench bench;
+	long sum = 0;
+
+	Map map = map_create(compare_ints, NULL, NULL);
+	map_set_hash_function(map, hash_int);
+	map_set_sizing(map, MAP_SIZING_POW2);
+	bench_begin(&bench, "generic_map_insert", n);
+	for (int i = 0; i < n; i++)
+		map_insert(map, &keys[i], &keys[i]);
+	bench_end_batch(&bench);
+
+	bench_begin(&bench, "generic_map_find", n);
+	for (int i = 0; i < n; i++)
+		sum += *(int*)map_find(map, &queries[i]);
+	bench_end_batch(&bench);
+	map_destroy(map);
+
+	// Πλήθος εμφανίσεων κάθε τιμής των queries
+	map = map_create(compare_ints, NULL, free);
+	map_set_hash_function(map, hash_int);
+	map_set_sizing(map, MAP_SIZING_POW2);
+	bench_begin(&bench, "generic_map_count", n);
+	for (int i = 0; i < n; i++)
+		(*(int*)map_node_value(map, map_find_or_insert(map, &queries[i], create_counter, NULL)))++;
+	bench_end_batch(&bench);
+	map_destroy(map);
+
+	Map_uint32_t_int typed = map_uint32_t_int_create();
+	bench_begin(&bench, "typed_map_insert", n);
+	for (int i = 0; i < n; i++)
+		map_uint32_t_int_insert(typed, keys[i], keys[i]);
+	bench_end_batch(&bench);
+
+	bench_begin(&bench, "typed_map_find", n);
+	for (int i = 0; i < n; i++)
+		sum += *map_uint32_t_int_find(typed, queries[i]);
+	bench_end_batch(&bench);
+	map_uint32_t_int_destroy(typed);
+
+	typed = map_uint32_t_int_create();
+	bench_begin(&bench, "typed_map_count", n);
+	for (int i = 0; i < n; i++)
+		(*map_uint32_t_int_find_or_insert(typed, queries[i], NULL))++;
+	bench_end_batch(&bench);
+	map_uint32_t_int_destroy(typed);
+
+	sink = sum;
+}
+
+static void bench_set(int n, int* keys, int* queries) {
+	Bench bench;
+	long sum = 0;
+
+	Set set = set_create(compare_ints, NULL);
+	bench_begin(&bench, "generic_set_insert", n);
+	for (int i = 0; i < n; i++)
+		set_insert(set, &keys[i]);
+	bench_end_batch(&bench);
+
+	bench_begin(&bench, "generic_set_find", n);
+	for (int i = 0; i < n; i++)
+		sum += *(int*)set_find(set, &queries[i]);
+	bench_end_batch(&bench);
+	set_destroy(set);
+
+	Set_int typed = set_int_create();
+	bench_begin(&bench, "typed_set_insert", n);
+	for (int i = 0; i < n; i++)
+		set_int_insert(typed, keys[i]);
+	bench_end_batch(&bench);
+
+	bench_begin(&bench, "typed_set_find", n);
+	for (int i = 0; i < n; i++)
+		sum += *set_int_find(typed, queries[i]);
+	bench_end_batch(&bench);
+	set_int_destroy(typed);
+
+	sink = sum;
+}
+
+static void bench_pqueue(int n, int* keys) {
+	Bench bench;
+	long sum = 0;
+
+	PriorityQueue pqueue = pqueue_create(compare_ints, NULL, NULL);
+	bench_begin(&bench, "generic_pqueue_insert", n);
+	for (int i = 0; i < n; i++)
+		pqueue_insert(pqueue, &keys[i]);
+	bench_end_batch(&bench);
+
+	bench_begin(&bench, "generic_pqueue_remove_max", n);
+	for (int i = 0; i < n; i++) {
+		sum += *(int*)pqueue_max(pqueue);
+		pqueue_remove_max(pqueue);
+	}
+	bench_end_batch(&bench);
+	pqueue_destroy(pqueue);
+
+	PriorityQueue_int typed = pqueue_int_create(NULL, 0);
+	bench_begin(&bench, "typed_pqueue_insert", n);
+	for (int i = 0; i < n; i++)
+		pqueue_int_insert(typed, keys[i]);
+	bench_end_batch(&bench);
+
+	bench_begin(&bench, "typed_pqueue_remove_max", n);
+	for (int i = 0; i < n; i++) {
+		sum += pqueue_int_max(typed);
+		pqueue_int_remove_max(typed);
+	}
+	bench_end_batch(&bench);
+	pqueue_int_destroy(typed);
+
+	sink = sum;
+}
+
+
+int main(int argc, char* argv[]) {
+	BenchConfig config;
+	bench_parse_args(&config, argc, argv);
+
+	int n = config.size;
+	int* keys = create_keys(&config, n);
+	Sampler sampler = sampler_create(&config, n);
+	int* queries = create_queries(sampler, n);
+
+	bench_output_begin("Typed_bench", &config);
+	bench_vector(n, keys, queries);
+	bench_map(n, keys, queries);
+	bench_set(n, keys, queries);
+	bench_pqueue(n, keys);
+	bench_output_end();
+
+	sampler_destroy(sampler);
+	free(queries);
+	free(keys);
+	return 0;
+}
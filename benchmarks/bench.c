@@ -0,0 +1,281 @@
+///////////////////////////////////////////////////////////////////
+//
+// Benchmark harness
+//
+///////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "bench.h"
+#include "AdtAlloc.h"
+
+
+// Παράμετροι ///////////////////////////////////////////////////////////////////
+
+static void usage(String program) {
+	fprintf(stderr,
+		"Usage: %s [--size=N] [--dist=uniform|zipf] [--zipf=S] [--dates=random|sorted] [--seed=N]\n",
+		program);
+	exit(EXIT_FAILURE);
+}
+
+static uint64_t random_state;
+
+void bench_parse_args(BenchConfig* config, int argc, char* argv[]) {
+	config->size = 100000;
+	config->dist = DIST_UNIFORM;
+	config->zipf_s = 1.0;
+	config->sorted_dates = false;
+	config->seed = 1;
+
+	for (int i = 1; i < argc; i++) {
+		String arg = argv[i];
+		String value = strchr(arg, '=');
+		if (value == NULL)
+			usage(argv[0]);
+		value++;
+
+		if (strncmp(arg, "--size=", 7) == 0)
+			config->size = atoi(value);
+		else if (strncmp(arg, "--zipf=", 7) == 0)
+			config->zipf_s = atof(value);
+		else if (strncmp(arg, "--seed=", 7) == 0)
+			config->seed = atoi(value);
+		else if (strcmp(arg, "--dist=uniform") == 0)
+			config->dist = DIST_UNIFORM;
+		else if (strcmp(arg, "--dist=zipf") == 0)
+			config->dist = DIST_ZIPF;
+		else if (strcmp(arg, "--dates=random") == 0)
+			config->sorted_dates = false;
+		else if (strcmp(arg, "--dates=sorted") == 0)
+			config->sorted_dates = true;
+		else
+			usage(argv[0]);
+	}
+
+	if (config->size <= 0 || config->zipf_s <= 0)
+		usage(argv[0]);
+
+	// Το state του xorshift δεν πρέπει να είναι 0
+	random_state = 0x9E3779B97F4A7C15ULL ^ config->seed;
+}
+
+
+// Γεννήτριες ///////////////////////////////////////////////////////////////////
+
+uint bench_random() {
+	// xorshift64*
+	random_state ^= random_state >> 12;
+	random_state ^= random_state << 25;
+	random_state ^= random_state >> 27;
+	return (random_state * 0x2545F4914F6CDD1DULL) >> 32;
+}
+
+int bench_random_int(int n) {
+	return ((uint64_t)bench_random() * n) >> 32;
+}
+
+// Για την Zipf κρατάμε την αθροιστική κατανομή (cdf[i] = P(τιμή <= i)) και κάθε
+// τιμή βρίσκεται με δυαδική αναζήτηση, σε O(logn).
+
+struct sampler {
+	int n;
+	double* cdf;		// NULL για ομοιόμορφη κατανομή
+};
+
+Sampler sampler_create(BenchConfig* config, int n) {
+	Sampler sampler = malloc(sizeof(*sampler));
+	sampler->n = n;
+	sampler->cdf = NULL;
+
+	if (config->dist == DIST_ZIPF) {
+		sampler->cdf = malloc(n * sizeof(double));
+
+		double sum = 0;
+		for (int i = 0; i < n; i++) {
+			sum += 1 / pow(i + 1, config->zipf_s);
+			sampler->cdf[i] = sum;
+		}
+		for (int i = 0; i < n; i++)
+			sampler->cdf[i] /= sum;
+	}
+	return sampler;
+}
+
+int sampler_next(Sampler sampler) {
+	if (sampler->cdf == NULL)
+		return bench_random_int(sampler->n);
+
+	double u = bench_random() / 4294967296.0;
+
+	// Η πρώτη θέση με cdf > u
+	int low = 0, high = sampler->n - 1;
+	while (low < high) {
+		int mid = (low + high) / 2;
+		if (sampler->cdf[mid] > u)
+			high = mid;
+		else
+			low = mid + 1;
+	}
+	return low;
+}
+
+void sampler_destroy(Sampler sampler) {
+	free(sampler->cdf);
+	free(sampler);
+}
+
+
+// Μέτρηση /////////////////////////////////////////////////////////////////////
+
+static bool first_result;
+
+void bench_output_begin(String program, BenchConfig* config) {
+	printf("{\n");
+	printf("  \"program\": \"%s\",\n", program);
+	printf("  \"config\": {\"size\": %d, \"dist\": \"%s\", \"zipf\": %g, \"dates\": \"%s\", \"seed\": %u},\n",
+		config->size,
+		config->dist == DIST_ZIPF ? "zipf" : "uniform",
+		config->zipf_s,
+		config->sorted_dates ? "sorted" : "random",
+		config->seed);
+	printf("  \"results\": [");
+	first_result = true;
+}
+
+void bench_output_end() {
+	printf("\n  ]\n}\n");
+}
+
+void bench_begin(Bench* bench, String name, int ops) {
+	bench->name = name;
+	bench->ops = ops;
+	bench->done = 0;
+	bench->latencies = malloc((ops > 0 ? ops : 1) * sizeof(uint64_t));
+	bench->allocs = adt_alloc_stats(ADT_MODULE_NO).allocs;
+	bench->start = bench_now();
+}
+
+static int compare_latencies(const void* a, const void* b) {
+	uint64_t x = *(uint64_t*)a, y = *(uint64_t*)b;
+	return (x > y) - (x < y);
+}
+
+// Το percentile με τη μέθοδο nearest-rank, σε ήδη ταξινομημένο πίνακα
+
+static uint64_t percentile(uint64_t* sorted, int n, double percent) {
+	if (n == 0)
+		return 0;
+	int rank = (int)ceil(percent / 100 * n);
+	return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+void bench_end(Bench* bench) {
+	uint64_t elapsed = bench_now() - bench->start;
+	long allocs = adt_alloc_stats(ADT_MODULE_NO).allocs - bench->allocs;
+	int n = bench->done;
+
+	qsort(bench->latencies, n, sizeof(uint64_t), compare_latencies);
+
+	double ns_per_op = n > 0 ? (double)elapsed / n : 0;
+
+	printf("%s\n    {\"name\": \"%s\", \"ops\": %d, \"ns_per_op\": %.1f, \"ops_per_sec\": %.0f, "
+		"\"p50_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu",
+		first_result ? "" : ",",
+		bench->name,
+		n,
+		ns_per_op,
+		ns_per_op > 0 ? 1e9 / ns_per_op : 0,
+		(unsigned long long)percentile(bench->latencies, n, 50),
+		(unsigned long long)percentile(bench->latencies, n, 99),
+		(unsigned long long)percentile(bench->latencies, n, 99.9));
+#ifdef ADT_ALLOC_STATS
+	printf(", \"allocs_per_op\": %.2f}", n > 0 ? (double)allocs / n : 0);
+#else
+	printf("}");
+	(void)allocs;
+#endif
+	fflush(stdout);
+	first_result = false;
+
+	free(bench->latencies);
+}
+
+
+void bench_end_batch(Bench* bench) {
+	uint64_t elapsed = bench_now() - bench->start;
+	long allocs = adt_alloc_stats(ADT_MODULE_NO).allocs - bench->allocs;
+	int n = bench->ops;
+
+	double ns_per_op = n > 0 ? (double)elapsed / n : 0;
+
+	printf("%s\n    {\"name\": \"%s\", \"ops\": %d, \"ns_per_op\": %.1f, \"ops_per_sec\": %.0f",
+		first_result ? "" : ",",
+		bench->name,
+		n,
+		ns_per_op,
+		ns_per_op > 0 ? 1e9 / ns_per_op : 0);
+#ifdef ADT_ALLOC_STATS
+	printf(", \"allocs_per_op\": %.2f}", n > 0 ? (double)allocs / n : 0);
+#else
+	printf("}");
+	(void)allocs;
+#endif
+	fflush(stdout);
+	first_result = false;
+
+	free(bench->latencies);
+}
+
+double bench_throughput(String name, int threads, long ops, uint64_t elapsed, double base_ops_per_sec) {
+	double ops_per_sec = elapsed > 0 ? ops * 1e9 / elapsed : 0;
+
+	printf("%s\n    {\"name\": \"%s\", \"threads\": %d, \"ops\": %ld, \"ops_per_sec\": %.0f",
+		first_result ? "" : ",",
+		name,
+		threads,
+		ops,
+		ops_per_sec);
+	if (base_ops_per_sec > 0)
+		printf(", \"speedup\": %.2f", ops_per_sec / base_ops_per_sec);
+	printf("}");
+	fflush(stdout);
+	first_result = false;
+
+	return ops_per_sec;
+}
+
+
+// Ποιότητα κατακερματισμού ///////////////////////////////////////////////////
+
+#define DEGENERATE_FACTOR 1.5
+
+void bench_map_stats(String name, Map map) {
+	MapStats stats = map_stats(map);
+	double expected = 1 + stats.load_factor / 2;
+	bool degenerate = stats.mean_probes > DEGENERATE_FACTOR * expected;
+
+	printf("%s\n    {\"name\": \"%s\", \"size\": %d, \"capacity\": %d, \"load_factor\": %.3f, "
+		"\"max_chain\": %d, \"mean_chain\": %.3f, \"mean_probes\": %.3f, \"expected_probes\": %.3f, \"chains\": [",
+		first_result ? "" : ",",
+		name,
+		stats.size,
+		stats.capacity,
+		stats.load_factor,
+		stats.max_chain,
+		stats.mean_chain,
+		stats.mean_probes,
+		expected);
+	for (int i = 0; i < MAP_STATS_CHAINS; i++)
+		printf("%s%d", i == 0 ? "" : ", ", stats.chains[i]);
+	printf("], \"degenerate\": %s}", degenerate ? "true" : "false");
+	fflush(stdout);
+	first_result = false;
+
+	if (degenerate)
+		fprintf(stderr, "warning: %s: %.2f probes per lookup, expected %.2f (max chain %d)\n",
+			name, stats.mean_probes, expected, stats.max_chain);
+}
@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////////////
+//
+// Benchmark harness
+//
+// Κοινός κώδικας για τα benchmarks: παράμετροι από τη γραμμή εντολών,
+// γεννήτριες τυχαίων τιμών (ομοιόμορφη / Zipf), μέτρηση του χρόνου κάθε
+// πράξης και εκτύπωση των αποτελεσμάτων σε JSON.
+//
+///////////////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include <stdint.h>
+#include <time.h>
+
+#include "common_types.h"
+#include "ADTMap.h"
+
+
+// Παράμετροι ενός benchmark, από τη γραμμή εντολών:
+//   --size=N               Πλήθος στοιχείων/εγγραφών (default 100000)
+//   --dist=uniform|zipf    Κατανομή των προσβάσεων (και των χωρών/ασθενειών στο DiseaseMonitor)
+//   --zipf=S               Εκθέτης της κατανομής Zipf (default 1.0)
+//   --dates=random|sorted  Σειρά των ημερομηνιών (και των keys κατά την εισαγωγή στα ADTs)
+//   --seed=N               Seed της γεννήτριας (ίδιο seed, ίδια δεδομένα)
+
+typedef enum {
+	DIST_UNIFORM,
+	DIST_ZIPF
+} Distribution;
+
+struct bench_config {
+	int size;
+	Distribution dist;
+	double zipf_s;
+	bool sorted_dates;
+	uint seed;
+};
+typedef struct bench_config BenchConfig;
+
+// Διαβάζει τις παραμέτρους στο config. Σε άγνωστη παράμετρο τυπώνει τις επιτρεπτές και τερματίζει.
+
+void bench_parse_args(BenchConfig* config, int argc, char* argv[]);
+
+
+// Γεννήτριες
+//
+// Η bench_random επιστρέφει τυχαίο ακέραιο (xorshift, αρχικοποιείται από την bench_parse_args).
+// Ο Sampler επιστρέφει τιμές στο [0, n) με την κατανομή του config: ομοιόμορφα, ή με Zipf όπου
+// η τιμή 0 είναι η πιο συχνή, η 1 η δεύτερη πιο συχνή κλπ.
+
+uint bench_random();
+
+int bench_random_int(int n);			// Ομοιόμορφα στο [0, n)
+
+typedef struct sampler* Sampler;
+
+Sampler sampler_create(BenchConfig* config, int n);
+
+int sampler_next(Sampler sampler);
+
+void sampler_destroy(Sampler sampler);
+
+
+// Μέτρηση
+//
+// Για κάθε benchmark: bench_begin με το πλήθος των πράξεων, και για κάθε πράξη
+// bench_op_begin / bench_op_end γύρω από την κλήση. Η bench_end τυπώνει ένα JSON object με
+// τον μέσο χρόνο (ns/op), τις πράξεις ανά δευτερόλεπτο και τα p50/p99/p999 των χρόνων
+// κάθε πράξης. Ο μέσος χρόνος μετράει από το bench_begin μέχρι το bench_end, οπότε
+// περιλαμβάνει και το κόστος της ίδιας της μέτρησης (~20ns ανά πράξη).
+//
+// Η έξοδος ενός προγράμματος είναι ένα JSON object με τις παραμέτρους και ένα πίνακα
+// "results", ανάμεσα σε bench_output_begin και bench_output_end.
+//
+// Αν τα modules έχουν γίνει compile με -DADT_ALLOC_STATS, κάθε αποτέλεσμα έχει και το
+// "allocs_per_op" (δεσμεύσεις μνήμης όλων των modules ανά πράξη, βλ. AdtAlloc.h).
+
+struct bench {
+	String name;
+	int ops;				// Πλήθος πράξεων
+	int done;				// Πράξεις που έχουν μετρηθεί
+	uint64_t* latencies;	// Χρόνος κάθε πράξης, σε ns
+	uint64_t start;			// Αρχή του benchmark
+	uint64_t op_start;		// Αρχή της τρέχουσας πράξης
+	long allocs;			// Δεσμεύσεις όλων των modules στην αρχή (ADT_ALLOC_STATS)
+};
+typedef struct bench Bench;
+
+void bench_output_begin(String program, BenchConfig* config);
+
+void bench_output_end();
+
+void bench_begin(Bench* bench, String name, int ops);
+
+void bench_end(Bench* bench);
+
+// Για πολύ γρήγορες πράξεις (λίγα ns) η μέτρηση κάθε πράξης κοστίζει περισσότερο από την
+// ίδια την πράξη. Τότε οι πράξεις γίνονται χωρίς bench_op_begin / bench_op_end, και η
+// bench_end_batch (αντί για bench_end) τυπώνει μόνο τον μέσο χρόνο και τις πράξεις ανά
+// δευτερόλεπτο, θεωρώντας ότι έγιναν και οι ops πράξεις του bench_begin.
+
+void bench_end_batch(Bench* bench);
+
+// Τρέχουσα χρονική στιγμή σε ns
+
+static inline uint64_t bench_now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static inline void bench_op_begin(Bench* bench) {
+	bench->op_start = bench_now();
+}
+
+static inline void bench_op_end(Bench* bench) {
+	if (bench->done < bench->ops)
+		bench->latencies[bench->done++] = bench_now() - bench->op_start;
+}
+
+
+// Ποιότητα κατακερματισμού
+//
+// Η bench_map_stats τυπώνει (ως ένα ακόμα αποτέλεσμα) τα στατιστικά της map_stats μαζί με
+// τον μέσο αριθμό probes που θα είχε μια ομοιόμορφη συνάρτηση κατακερματισμού (1 + a/2).
+// Αν οι probes είναι πάνω από 1.5 φορές περισσότερες, το αποτέλεσμα έχει "degenerate": true
+// και τυπώνεται προειδοποίηση στο stderr.
+
+void bench_map_stats(String name, Map map);
+
+
+// Throughput με πολλά threads
+//
+// Η bench_throughput τυπώνει (ως ένα ακόμα αποτέλεσμα) τις πράξεις ανά δευτερόλεπτο όλων
+// των threads μαζί, σε elapsed ns, και επιστρέφει την τιμή αυτή. Αν base_ops_per_sec > 0
+// (η τιμή του ίδιου benchmark με 1 thread), τυπώνεται και το "speedup" ως προς αυτή.
+
+double bench_throughput(String name, int threads, long ops, uint64_t elapsed, double base_ops_per_sec);
@@ -50,8 +50,9 @@ override CFLAGS += -g -Wall -MMD -I$(INCLUDE)
 
 # Linker options
 #   -lm        Link με τη math library
+#   -pthread   Link με τη pthreads (ShardedMonitor)
 #
-LDFLAGS += -lm
+LDFLAGS += -lm -pthread
 
 # Αν στα targets με τα οποία έχει κληθεί το make (μεταβλητή MAKECMDGOALS) υπάρχει κάποιο
 # coverage*, τότε προσθέτουμε το --coverage στα compile & link flags
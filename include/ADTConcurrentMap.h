@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////
+//
+// ADT ConcurrentMap
+//
+// Map που μπορεί να χρησιμοποιείται ταυτόχρονα από πολλά threads,
+// χωρίς locks: οι αναζητήσεις δεν γράφουν σε κοινή μνήμη, οπότε
+// κλιμακώνονται με τα threads, και οι αλλαγές γίνονται με CAS.
+//
+///////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include "common_types.h"
+#include "ADTMap.h"				// HashFunc, hash_*
+
+
+// Ενα concurrent map αναπαριστάται από τον τύπο ConcurrentMap
+
+typedef struct concurrent_map* ConcurrentMap;
+
+
+// Threads και epochs
+//
+// Κάθε thread που χρησιμοποιεί concurrent maps πρέπει πρώτα να καλέσει την
+// cmap_thread_register, και την cmap_thread_unregister πριν τερματίσει. Τα δύο αφορούν
+// όλα τα maps.
+//
+// Ενα στοιχείο που αφαιρείται δεν καταστρέφεται αμέσως (κάποιο άλλο thread μπορεί να το
+// διαβάζει), αλλά όταν κανένα thread δεν βρίσκεται πλέον σε critical section που ξεκίνησε
+// πριν την αφαίρεση. Οι destroy_key/destroy_value καλούνται τότε, από οποιοδήποτε thread.
+//
+// Κάθε cmap_* είναι από μόνη της ένα critical section. Για να παραμείνει έγκυρη η τιμή
+// που επιστρέφει η cmap_find ενώ άλλα threads μπορεί να αφαιρούν το κλειδί της, η κλήση
+// γίνεται ανάμεσα σε cmap_enter και cmap_leave (που μπορούν να φωλιάζουν), και η τιμή
+// χρησιμοποιείται μόνο μέχρι την cmap_leave.
+
+void cmap_thread_register();
+
+void cmap_thread_unregister();
+
+void cmap_enter();
+
+void cmap_leave();
+
+// Περιμένει μέχρι να τελειώσουν όλα τα critical sections που είχαν ξεκινήσει πριν την κλήση,
+// και καταστρέφει τα στοιχεία που έχει αφαιρέσει το τρέχον thread (και όσα είχαν αφαιρέσει
+// threads που έχουν κάνει unregister). Δεν πρέπει να καλείται μέσα σε critical section.
+
+void cmap_synchronize();
+
+
+// Δημιουργεί και επιστρέφει ένα map, με συνάρτηση κατακερματισμού hash και σύγκρισης compare.
+// Αν destroy_key ή/και destroy_value != NULL, τότε καλείται destroy_key(key) ή/και
+// destroy_value(value) για κάθε στοιχείο που αφαιρείται (βλ. παραπάνω) ή μένει στο destroy.
+
+ConcurrentMap cmap_create(CompareFunc compare, HashFunc hash, DestroyFunc destroy_key, DestroyFunc destroy_value);
+
+// Επιστρέφει τον αριθμό στοιχείων που περιέχει το map. Με ταυτόχρονες αλλαγές η τιμή
+// είναι προσεγγιστική.
+
+int cmap_size(ConcurrentMap map);
+
+// Προσθέτει το κλειδί key με τιμή value, αν δεν υπάρχει ήδη ισοδύναμο κλειδί, και επιστρέφει
+// true. Αλλιώς το map δεν αλλάζει, επιστρέφεται false, και τα key/value ανήκουν ακόμα στον καλούντα.
+//
+// ΠΡΟΣΟΧΗ: η τιμή ενός κλειδιού δεν αλλάζει ποτέ (για αλλαγή: cmap_remove και cmap_insert).
+
+bool cmap_insert(ConcurrentMap map, Pointer key, Pointer value);
+
+// Αφαιρεί το κλειδί που είναι ισοδύναμο με key από το map, αν υπάρχει.
+// Επιστρέφει true αν βρέθηκε τέτοιο κλειδί, διαφορετικά false.
+
+bool cmap_remove(ConcurrentMap map, Pointer key);
+
+// Επιστρέφει την τιμή που έχει αντιστοιχιστεί στο συγκεκριμένο key, ή NULL αν το key δεν υπάρχει στο map.
+
+Pointer cmap_find(ConcurrentMap map, Pointer key);
+
+// Ελευθερώνει όλη τη μνήμη που δεσμεύει το map. Δεν πρέπει να γίνεται καμία άλλη λειτουργία
+// πάνω στο map ταυτόχρονα ή μετά το destroy.
+
+void cmap_destroy(ConcurrentMap map);
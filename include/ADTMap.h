@@ -89,6 +89,19 @@ Pointer map_node_value(Map map, MapNode node);
 
 MapNode map_find_node(Map map, Pointer key);
 
+// Επιστρέφει τον κόμβο του key. Αν το key δεν υπάρχει προστίθεται με τιμή make(key) (ή NULL αν
+// make == NULL), και στο *inserted (αν δεν είναι NULL) γράφεται αν έγινε προσθήκη. Ετσι το
+// "αναζήτηση, και προσθήκη αν δεν βρέθηκε" γίνεται με ένα hash και ένα πέρασμα του bucket.
+//
+// Ο κόμβος μένει ο ίδιος (και μετά από rehash) μέχρι να αφαιρεθεί το key, οπότε μπορεί
+// να κρατηθεί και η τιμή του να αλλάξει αργότερα με την map_node_set_value.
+
+MapNode map_find_or_insert(Map map, Pointer key, Pointer (*make)(Pointer key), bool* inserted);
+
+// Αλλάζει την τιμή του κόμβου node σε value. Η παλιά τιμή _δεν_ καταστρέφεται.
+
+void map_node_set_value(Map map, MapNode node, Pointer value);
+
 
 //// Επιπλέον συναρτήσεις για υλοποιήσεις βασισμένες σε hashing ////////////////////////////
 
@@ -97,6 +110,7 @@ MapNode map_find_node(Map map, Pointer key);
 typedef uint (*HashFunc)(Pointer);
 
 // Υλοποιημένες συναρτήσεις κατακερματισμού για συχνούς τύπους δεδομένων
+// (βλ. AdtHash.h). Ολες αναμειγνύουν όλα τα bits, οπότε κάνουν και για MAP_SIZING_POW2.
 
 uint hash_string(Pointer value);		// Χρήση όταν το key είναι char*
 uint hash_int(Pointer value);			// Χρήση όταν το key είναι int*
@@ -109,4 +123,76 @@ void map_set_hash_function(Map map, HashFunc hash_func);
 
 HashFunc map_get_hash_function(Map map);
 
-CompareFunc map_get_compare(Map map);
\ No newline at end of file
+CompareFunc map_get_compare(Map map);
+
+// Μέγεθος του hash table. Με MAP_SIZING_PRIME (default) το μέγεθος είναι πάντα πρώτος
+// αριθμός και το bucket ενός κλειδιού είναι hash % capacity, οπότε και συναρτήσεις που δεν
+// αναμειγνύουν τα bits (πχ η ίδια η τιμή ενός id) κατανέμουν καλά τα κλειδιά. Με
+// MAP_SIZING_POW2 το μέγεθος είναι δύναμη του 2 και το bucket είναι hash & (capacity - 1),
+// που αποφεύγει μια διαίρεση σε κάθε πράξη, αλλά χρησιμοποιεί μόνο τα χαμηλά bits του hash.
+//
+// Πρέπει να κληθεί όσο το map είναι κενό. Υλοποιήσεις που έχουν πάντα μέγεθος δύναμη του 2
+// και αναμειγνύουν οι ίδιες το hash (πχ UsingSwissTable) την αγνοούν.
+
+typedef enum {
+	MAP_SIZING_PRIME,
+	MAP_SIZING_POW2
+} MapSizing;
+
+void map_set_sizing(Map map, MapSizing sizing);
+
+// Αναζήτηση με έτοιμο hash και "όψη" του κλειδιού (heterogeneous lookup) ///////////////////
+//
+// Οι παρακάτω συναρτήσεις δεν καλούν την hash function του map, αλλά παίρνουν το hash
+// (που πρέπει να είναι ίσο με hash_func(key) για το κλειδί που ψάχνουμε) και ένα probe, που
+// μπορεί να είναι οτιδήποτε (πχ ένα int* με το id, όταν τα κλειδιά είναι εγγραφές). Η eq
+// καλείται ως eq(key, probe) μόνο για κλειδιά με το ίδιο hash, και επιστρέφει 0 αν το key
+// αντιστοιχεί στο probe. Ετσι δεν χρειάζεται να κατασκευαστεί ένα ολόκληρο κλειδί για την
+// αναζήτηση, και το hash υπολογίζεται μία φορά για περισσότερες από μία πράξεις.
+
+MapNode map_find_node_with(Map map, uint hash, Pointer probe, CompareFunc eq);
+
+Pointer map_find_with(Map map, uint hash, Pointer probe, CompareFunc eq);
+
+bool map_remove_with(Map map, uint hash, Pointer probe, CompareFunc eq);
+
+// Προσθέτει το key (με hash ίσο με hash_func(key)) με τιμή value, και επιστρέφει τον κόμβο του.
+// Δεν ελέγχει αν υπάρχει ήδη ισοδύναμο κλειδί, οπότε πρέπει να έχει προηγηθεί μια αποτυχημένη
+// αναζήτηση. Μαζί με την map_find_node_with κάνουν ένα "insert-or-get" με ένα μόνο hash:
+//
+//   MapNode node = map_find_node_with(map, hash, probe, eq);
+//   if (node == MAP_EOF)
+//       node = map_insert_with(map, hash, create_key(probe), value);
+//
+// Ο κόμβος δεν αλλάζει με τα rehash, μέχρι να αφαιρεθεί το key.
+
+MapNode map_insert_with(Map map, uint hash, Pointer key, Pointer value);
+
+// Μεγαλώνει (αν χρειάζεται) το hash table ώστε να χωράει size στοιχεία χωρίς rehash.
+// Χρήσιμο όταν το πλήθος των στοιχείων είναι γνωστό πριν από τις προσθήκες.
+
+void map_reserve(Map map, int size);
+
+// Στατιστικά για την ποιότητα της συνάρτησης κατακερματισμού. Τα στοιχεία ενός bucket
+// σχηματίζουν μια αλυσίδα, και για να βρεθεί ένα κλειδί γίνονται τόσες συγκρίσεις (probes)
+// όσο η θέση του στην αλυσίδα. Με μια καλή συνάρτηση και load factor a, ο μέσος αριθμός
+// probes είναι περίπου 1 + a/2, και πολύ μεγαλύτερες τιμές σημαίνουν ότι τα κλειδιά
+// συγκεντρώνονται σε λίγα buckets. Σε υλοποιήσεις με open addressing (πχ UsingSwissTable) ως
+// bucket θεωρείται η αρχική θέση της αναζήτησης και ως probes οι θέσεις που εξετάζονται.
+
+#define MAP_STATS_CHAINS 8
+
+struct map_stats {
+	int size;
+	int capacity;					// Πλήθος buckets
+	float load_factor;				// size / capacity
+	int max_chain;					// Μήκος της μεγαλύτερης αλυσίδας
+	float mean_chain;				// Μέσο μήκος των μη κενών αλυσίδων
+	float mean_probes;				// Μέσος αριθμός συγκρίσεων για την εύρεση ενός κλειδιού του map
+	int chains[MAP_STATS_CHAINS];	// chains[i]: πλήθος buckets με i στοιχεία (το τελευταίο: τουλάχιστον τόσα)
+};
+typedef struct map_stats MapStats;
+
+// Υπολογίζει τα στατιστικά του map σε O(capacity)
+
+MapStats map_stats(Map map);
\ No newline at end of file
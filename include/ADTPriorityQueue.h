@@ -86,6 +86,7 @@ void pqueue_remove_node(PriorityQueue pqueue, PriorityQueueNode node);
 void pqueue_update_order(PriorityQueue pqueue, PriorityQueueNode node);
 
 // Επιστρέφει μια ταξινομημένη λίστα με τις max{k, pqueue_size} μέγιστες εγγραφές στην pqueue
-// με πολυπλοκότητα Ο(k*logn) σε αυτήν την υλοποίηση
+// με πολυπλοκότητα Ο(k*logk) σε αυτήν την υλοποίηση. Δεν τροποποιεί την pqueue, οπότε μπορεί
+// να καλείται ταυτόχρονα από πολλά threads (αρκεί να μη γίνονται ταυτόχρονα αλλαγές).
 
 List pqueue_top_k(PriorityQueue pqueue, int k);
\ No newline at end of file
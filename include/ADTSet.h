@@ -24,6 +24,12 @@ typedef struct set* Set;
 
 Set set_create(CompareFunc compare, DestroyFunc destroy_value);
 
+// Δημιουργεί ένα σύνολο με τις size τιμές του πίνακα values, οι οποίες πρέπει να είναι
+// ταξινομημένες σε γνησίως αύξουσα σειρά σύμφωνα με την compare. Πολυπλοκότητα O(n),
+// αντί για O(nlogn) με διαδοχικές set_insert.
+
+Set set_create_from_sorted(CompareFunc compare, DestroyFunc destroy_value, Pointer values[], int size);
+
 // Επιστρέφει τον αριθμό στοιχείων που περιέχει το σύνολο set.
 
 int set_size(Set set);
@@ -56,6 +62,17 @@ DestroyFunc set_set_destroy_value(Set set, DestroyFunc destroy_value);
 
 void set_destroy(Set set);
 
+// Επιστρέφει ένα νέο set με τα ίδια στοιχεία με το set, το οποίο δεν επηρεάζεται από
+// μεταγενέστερες αλλαγές του set (και αντίστροφα). Το snapshot δεν κατέχει τις τιμές
+// (destroy_value == NULL): αν το set έχει destroy_value, οι τιμές του snapshot παύουν
+// να ισχύουν όταν αφαιρεθούν από το set. Καταστρέφεται με set_destroy.
+//
+// Πολυπλοκότητα O(n) στο UsingAVL, O(1) στο UsingPersistentAVL όπου τα δύο sets μοιράζονται
+// τους κόμβους τους. Στο UsingPersistentAVL οι αλλαγές στο set μπορούν να γίνονται ενώ
+// άλλα threads διαβάζουν ένα snapshot του.
+
+Set set_snapshot(Set set);
+
 
 // Διάσχιση του set ////////////////////////////////////////////////////////////
 //
@@ -87,6 +104,12 @@ Pointer set_node_value(Set set, SetNode node);
 
 SetNode set_find_node(Set set, Pointer value);
 
+// Επιστρέφει τον κόμβο του μικρότερου στοιχείου που είναι >= value (σύμφωνα με την compare),
+// ή SET_EOF αν δεν υπάρχει τέτοιο. Μαζί με την set_next επιτρέπει τη διάσχιση ενός εύρους
+// τιμών χωρίς τη δημιουργία λίστας.
+
+SetNode set_lower_bound(Set set, Pointer value);
+
 
 
 
@@ -111,4 +134,24 @@ List set_return_from_to(Set set, Pointer from, Pointer to);
 
 int set_count_greater_than(Set set, Pointer max);
 
-int set_count_less_than(Set set, Pointer min);
\ No newline at end of file
+int set_count_less_than(Set set, Pointer min);
+
+//// Συναρτήσεις διάταξης (order statistics)
+//
+// Χρησιμοποιούν το μέγεθος υποδέντρου που αποθηκεύεται σε κάθε κόμβο, οπότε έχουν
+// πολυπλοκότητα O(logn) (σε αυτήν την υλοποίηση).
+
+// Επιστρέφει τον κόμβο του k-οστού μικρότερου στοιχείου του set (με k = 0 το μικρότερο),
+// ή SET_EOF αν k < 0 ή k >= set_size.
+
+SetNode set_select(Set set, int k);
+
+// Επιστρέφει τη θέση (στη σειρά διάταξης) που έχει ή θα είχε η value στο set, δηλαδή
+// το πλήθος των στοιχείων του set που είναι μικρότερα από value.
+
+int set_rank(Set set, Pointer value);
+
+// Μετράει τα στοιχεία από το from μέχρι το to (σύμφωνα με την compare), κάνοντας μία
+// μόνο κατάβαση από τη ρίζα. Αν from ή to είναι NULL δεν τίθεται κάτω ή πάνω όριο, αντίστοιχα.
+
+int set_range_count(Set set, Pointer from, Pointer to);
@@ -0,0 +1,212 @@
+///////////////////////////////////////////////////////////
+//
+// ADT TypedMap
+//
+// Map από κλειδιά τύπου K σε τιμές τύπου V, παραγόμενο με μακροεντολή.
+// Κλειδιά και τιμές αποθηκεύονται αυτούσια σε πίνακες (open addressing
+// με linear probing), οπότε πχ ένας μετρητής δεν χρειάζεται malloc, και
+// οι hash/eq είναι γνωστές στον compiler, οπότε γίνονται inline.
+//
+// Χρήση (μία φορά ανά ζεύγος τύπων, σε header ή .c):
+//   DEFINE_MAP(uint32_t, Record, hash_u32, eq_u32)
+//   Map_uint32_t_Record map = map_uint32_t_Record_create();
+//   map_uint32_t_Record_insert(map, record->id, record);
+//
+// Οι K, V πρέπει να είναι ονόματα (πχ int, uint32_t, Record), αφού γίνονται
+// μέρος των ονομάτων. Για σύνθετους τύπους χρησιμοποιείται typedef.
+//
+///////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common_types.h"
+#include "AdtHash.h"
+
+// hash/eq για συχνούς τύπους κλειδιών. Το map αναμειγνύει το hash με πολλαπλασιασμό
+// (Fibonacci hashing), οπότε για ακεραίους αρκεί η ίδια η τιμή.
+
+static inline uint hash_u32(uint32_t value) { return value; }
+static inline bool eq_u32(uint32_t a, uint32_t b) { return a == b; }
+
+static inline uint hash_u64(uint64_t value) { return value ^ (value >> 32); }
+static inline bool eq_u64(uint64_t a, uint64_t b) { return a == b; }
+
+static inline uint hash_str(String value) { return adt_hash_bytes(value, strlen(value), 0); }
+static inline bool eq_str(String a, String b) { return strcmp(a, b) == 0; }
+
+#define TYPED_MAP_MIN_CAPACITY 16
+
+// Παράγει τον τύπο Map_K_V και τις συναρτήσεις:
+//
+//   Map_K_V map_K_V_create()
+//   int map_K_V_size(Map_K_V map)
+//   bool map_K_V_insert(Map_K_V map, K key, V value)   true αν προστέθηκε, false αν άλλαξε η τιμή υπάρχοντος κλειδιού
+//   V* map_K_V_find(Map_K_V map, K key)                Η τιμή του key, ή NULL αν δεν υπάρχει
+//   V* map_K_V_find_or_insert(Map_K_V map, K key, bool* inserted)
+//                                                      Η τιμή του key, που προστίθεται με τιμή 0 αν δεν υπάρχει
+//   bool map_K_V_remove(Map_K_V map, K key)            true αν βρέθηκε το key
+//   void map_K_V_destroy(Map_K_V map)
+//
+// Διάσχιση, με θέσεις του πίνακα (με οποιαδήποτε σειρά):
+//   for (int pos = map_K_V_next(map, -1); pos != -1; pos = map_K_V_next(map, pos))
+//       ... map_K_V_key_at(map, pos), map_K_V_value_at(map, pos) ...
+//
+// Η hash(key) είναι uint hash(K key) και η eq(a, b) bool eq(K a, K b). Οι pointers σε τιμές
+// και οι θέσεις μένουν έγκυρα μόνο μέχρι την επόμενη προσθήκη ή αφαίρεση (τα στοιχεία
+// μετακινούνται). Οι αφαιρέσεις μετακινούν τα επόμενα κλειδιά μία θέση πίσω (backward shift),
+// οπότε δεν μένουν "σημαδεμένες" θέσεις και οι αναζητήσεις δεν χειροτερεύουν.
+
+#define DEFINE_MAP(K, V, hash, eq)																\
+																								\
+typedef struct map_##K##_##V {																	\
+	K* keys;																					\
+	V* values;																					\
+	bool* used;																					\
+	int size;																					\
+	int capacity;																				\
+	int shift;				/* 32 - log2(capacity) */											\
+}* Map_##K##_##V;																				\
+																								\
+static inline int map_##K##_##V##_home(Map_##K##_##V map, K key) {								\
+	return (uint)(hash(key) * 2654435769u) >> map->shift;										\
+}																								\
+																								\
+static inline void map_##K##_##V##_alloc(Map_##K##_##V map, int capacity) {					\
+	map->capacity = capacity;																	\
+	map->shift = 32 - __builtin_ctz(capacity);													\
+	map->keys = malloc(capacity * sizeof(K));													\
+	map->values = malloc(capacity * sizeof(V));													\
+	map->used = calloc(capacity, sizeof(bool));													\
+}																								\
+																								\
+static inline Map_##K##_##V map_##K##_##V##_create() {											\
+	Map_##K##_##V map = malloc(sizeof(*map));													\
+	map->size = 0;																				\
+	map_##K##_##V##_alloc(map, TYPED_MAP_MIN_CAPACITY);											\
+	return map;																					\
+}																								\
+																								\
+static inline int map_##K##_##V##_size(Map_##K##_##V map) {									\
+	return map->size;																			\
+}																								\
+																								\
+/* Η θέση του key, ή η κενή θέση όπου θα έμπαινε (*found == false) */						\
+static inline int map_##K##_##V##_slot(Map_##K##_##V map, K key, bool* found) {				\
+	int mask = map->capacity - 1;																\
+	for (int pos = map_##K##_##V##_home(map, key); ; pos = (pos + 1) & mask) {					\
+		if (!map->used[pos]) {																	\
+			*found = false;																		\
+			return pos;																			\
+		}																						\
+		if (eq(map->keys[pos], key)) {															\
+			*found = true;																		\
+			return pos;																			\
+		}																						\
+	}																							\
+}																								\
+																								\
+/* Διπλασιασμός όταν το load factor θα ξεπερνούσε το 3/4 */									\
+static inline void map_##K##_##V##_reserve_one(Map_##K##_##V map) {							\
+	if (4 * (map->size + 1) <= 3 * map->capacity)												\
+		return;																					\
+																								\
+	K* keys = map->keys;																		\
+	V* values = map->values;																	\
+	bool* used = map->used;																		\
+	int old_capacity = map->capacity;															\
+	map_##K##_##V##_alloc(map, 2 * old_capacity);												\
+																								\
+	int mask = map->capacity - 1;																\
+	for (int i = 0; i < old_capacity; i++) {													\
+		if (!used[i])																			\
+			continue;																			\
+		int pos = map_##K##_##V##_home(map, keys[i]);											\
+		while (map->used[pos])																	\
+			pos = (pos + 1) & mask;																\
+		map->keys[pos] = keys[i];																\
+		map->values[pos] = values[i];															\
+		map->used[pos] = true;																	\
+	}																							\
+	free(keys);																					\
+	free(values);																				\
+	free(used);																					\
+}																								\
+																								\
+static inline V* map_##K##_##V##_find_or_insert(Map_##K##_##V map, K key, bool* inserted) {	\
+	map_##K##_##V##_reserve_one(map);															\
+	bool found;																					\
+	int pos = map_##K##_##V##_slot(map, key, &found);											\
+	if (!found) {																				\
+		map->keys[pos] = key;																	\
+		memset(&map->values[pos], 0, sizeof(V));												\
+		map->used[pos] = true;																	\
+		map->size++;																			\
+	}																							\
+	if (inserted != NULL)																		\
+		*inserted = !found;																		\
+	return &map->values[pos];																	\
+}																								\
+																								\
+static inline bool map_##K##_##V##_insert(Map_##K##_##V map, K key, V value) {					\
+	bool inserted;																				\
+	*map_##K##_##V##_find_or_insert(map, key, &inserted) = value;								\
+	return inserted;																			\
+}																								\
+																								\
+static inline V* map_##K##_##V##_find(Map_##K##_##V map, K key) {								\
+	bool found;																					\
+	int pos = map_##K##_##V##_slot(map, key, &found);											\
+	return found ? &map->values[pos] : NULL;													\
+}																								\
+																								\
+static inline bool map_##K##_##V##_remove(Map_##K##_##V map, K key) {							\
+	bool found;																					\
+	int pos = map_##K##_##V##_slot(map, key, &found);											\
+	if (!found)																					\
+		return false;																			\
+																								\
+	/* Τα επόμενα κλειδιά της ίδιας ακολουθίας μετακινούνται στην κενή θέση, αν η αρχική		\
+	   τους θέση (home) δεν βρίσκεται κυκλικά ανάμεσα στην κενή θέση και τη θέση τους */		\
+	int mask = map->capacity - 1;																\
+	int next = pos;																				\
+	while (true) {																				\
+		next = (next + 1) & mask;																\
+		if (!map->used[next])																	\
+			break;																				\
+		int home = map_##K##_##V##_home(map, map->keys[next]);									\
+		if (((next - home) & mask) >= ((next - pos) & mask)) {									\
+			map->keys[pos] = map->keys[next];													\
+			map->values[pos] = map->values[next];												\
+			pos = next;																			\
+		}																						\
+	}																							\
+	map->used[pos] = false;																		\
+	map->size--;																				\
+	return true;																				\
+}																								\
+																								\
+static inline int map_##K##_##V##_next(Map_##K##_##V map, int pos) {							\
+	for (pos++; pos < map->capacity; pos++)														\
+		if (map->used[pos])																		\
+			return pos;																			\
+	return -1;																					\
+}																								\
+																								\
+static inline K map_##K##_##V##_key_at(Map_##K##_##V map, int pos) {							\
+	return map->keys[pos];																		\
+}																								\
+																								\
+static inline V* map_##K##_##V##_value_at(Map_##K##_##V map, int pos) {						\
+	return &map->values[pos];																	\
+}																								\
+																								\
+static inline void map_##K##_##V##_destroy(Map_##K##_##V map) {								\
+	free(map->keys);																			\
+	free(map->values);																			\
+	free(map->used);																			\
+	free(map);																					\
+}
@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////
+//
+// ADT TypedPriorityQueue
+//
+// Ουρά προτεραιότητας (σωρός) για έναν συγκεκριμένο τύπο T, παραγόμενη
+// με μακροεντολή. Οι τιμές αποθηκεύονται αυτούσιες στον πίνακα του σωρού,
+// και η compare είναι γνωστή στον compiler, οπότε γίνεται inline αντί για
+// κλήση μέσω pointer σε κάθε σύγκριση.
+//
+// Χρήση (μία φορά ανά τύπο, σε header ή .c):
+//   static int compare_ints(int a, int b) { return a - b; }
+//   DEFINE_PQUEUE(int, compare_ints)
+//   PriorityQueue_int pqueue = pqueue_int_create(NULL, 0);
+//
+// Ο T πρέπει να είναι ένα όνομα (πχ int, uint32_t, Record), αφού γίνεται
+// μέρος των ονομάτων. Για σύνθετους τύπους χρησιμοποιείται typedef.
+//
+///////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "common_types.h"
+
+#define TYPED_PQUEUE_MIN_CAPACITY 16
+
+// Παράγει τον τύπο PriorityQueue_T και τις συναρτήσεις:
+//
+//   PriorityQueue_T pqueue_T_create(const T values[], int size)   Με τις size τιμές (O(size)), ή κενή
+//   int pqueue_T_size(PriorityQueue_T pqueue)
+//   T pqueue_T_max(PriorityQueue_T pqueue)                         Η μεγαλύτερη τιμή σύμφωνα με την compare
+//   void pqueue_T_insert(PriorityQueue_T pqueue, T value)
+//   void pqueue_T_remove_max(PriorityQueue_T pqueue)
+//   void pqueue_T_destroy(PriorityQueue_T pqueue)
+//
+// Η compare(a, b) είναι int compare(T a, T b), < 0 αν a < b, όπως η CompareFunc. Σε αντίθεση
+// με το ADTPriorityQueue δεν υπάρχουν κόμβοι (οι τιμές μετακινούνται στον πίνακα), οπότε
+// για αλλαγή προτεραιότητας προστίθεται ξανά η τιμή και η παλιά αγνοείται όταν βγει.
+
+#define DEFINE_PQUEUE(T, compare)														\
+																						\
+typedef struct priority_queue_##T {														\
+	T* array;																			\
+	int size;																			\
+	int capacity;																		\
+}* PriorityQueue_##T;																	\
+																						\
+static inline void pqueue_##T##_bubble_up(PriorityQueue_##T pqueue, int pos) {			\
+	T value = pqueue->array[pos];														\
+	while (pos > 0) {																	\
+		int parent = (pos - 1) / 2;														\
+		if (compare(pqueue->array[parent], value) >= 0)									\
+			break;																		\
+		pqueue->array[pos] = pqueue->array[parent];										\
+		pos = parent;																	\
+	}																					\
+	pqueue->array[pos] = value;															\
+}																						\
+																						\
+static inline void pqueue_##T##_bubble_down(PriorityQueue_##T pqueue, int pos) {		\
+	T value = pqueue->array[pos];														\
+	while (true) {																		\
+		int child = 2 * pos + 1;														\
+		if (child >= pqueue->size)														\
+			break;																		\
+		if (child + 1 < pqueue->size && compare(pqueue->array[child + 1], pqueue->array[child]) > 0)	\
+			child++;																	\
+		if (compare(value, pqueue->array[child]) >= 0)									\
+			break;																		\
+		pqueue->array[pos] = pqueue->array[child];										\
+		pos = child;																	\
+	}																					\
+	pqueue->array[pos] = value;															\
+}																						\
+																						\
+static inline PriorityQueue_##T pqueue_##T##_create(const T values[], int size) {		\
+	PriorityQueue_##T pqueue = malloc(sizeof(*pqueue));									\
+	pqueue->size = size;																\
+	pqueue->capacity = size < TYPED_PQUEUE_MIN_CAPACITY ? TYPED_PQUEUE_MIN_CAPACITY : size;	\
+	pqueue->array = malloc(pqueue->capacity * sizeof(T));								\
+	if (size > 0)																		\
+		memcpy(pqueue->array, values, size * sizeof(T));								\
+	for (int i = size / 2 - 1; i >= 0; i--)												\
+		pqueue_##T##_bubble_down(pqueue, i);											\
+	return pqueue;																		\
+}																						\
+																						\
+static inline int pqueue_##T##_size(PriorityQueue_##T pqueue) {						\
+	return pqueue->size;																\
+}																						\
+																						\
+static inline T pqueue_##T##_max(PriorityQueue_##T pqueue) {							\
+	assert(pqueue->size != 0);															\
+	return pqueue->array[0];															\
+}																						\
+																						\
+static inline void pqueue_##T##_insert(PriorityQueue_##T pqueue, T value) {				\
+	if (pqueue->size == pqueue->capacity) {												\
+		pqueue->capacity *= 2;															\
+		pqueue->array = realloc(pqueue->array, pqueue->capacity * sizeof(T));			\
+	}																					\
+	pqueue->array[pqueue->size++] = value;												\
+	pqueue_##T##_bubble_up(pqueue, pqueue->size - 1);									\
+}																						\
+																						\
+static inline void pqueue_##T##_remove_max(PriorityQueue_##T pqueue) {					\
+	assert(pqueue->size != 0);															\
+	pqueue->array[0] = pqueue->array[--pqueue->size];									\
+	if (pqueue->size > 0)																\
+		pqueue_##T##_bubble_down(pqueue, 0);											\
+}																						\
+																						\
+static inline void pqueue_##T##_destroy(PriorityQueue_##T pqueue) {					\
+	free(pqueue->array);																\
+	free(pqueue);																		\
+}
@@ -0,0 +1,234 @@
+///////////////////////////////////////////////////////////
+//
+// ADT TypedSet
+//
+// Ταξινομημένο σύνολο (AVL) για έναν συγκεκριμένο τύπο T, παραγόμενο με
+// μακροεντολή. Κάθε τιμή αποθηκεύεται αυτούσια μέσα στον κόμβο της (ένα
+// malloc ανά στοιχείο αντί για δύο όταν η τιμή είναι boxed), και η compare
+// είναι γνωστή στον compiler, οπότε γίνεται inline σε κάθε κατάβαση.
+//
+// Χρήση (μία φορά ανά τύπο, σε header ή .c):
+//   static int compare_ints(int a, int b) { return a - b; }
+//   DEFINE_SET(int, compare_ints)
+//   Set_int set = set_int_create();
+//
+// Ο T πρέπει να είναι ένα όνομα (πχ int, uint32_t, Record), αφού γίνεται
+// μέρος των ονομάτων. Για σύνθετους τύπους χρησιμοποιείται typedef.
+//
+///////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include <stdlib.h>
+
+#include "common_types.h"
+
+// Παράγει τον τύπο Set_T και τις συναρτήσεις:
+//
+//   Set_T set_T_create()
+//   int set_T_size(Set_T set)
+//   bool set_T_insert(Set_T set, T value)      true αν προστέθηκε, false αν αντικατέστησε ισοδύναμη τιμή
+//   bool set_T_remove(Set_T set, T value)      true αν βρέθηκε ισοδύναμη τιμή
+//   T* set_T_find(Set_T set, T value)          Η ισοδύναμη τιμή, ή NULL
+//   T* set_T_first(Set_T set)                  Η μικρότερη τιμή, ή NULL αν το set είναι κενό
+//   T* set_T_lower_bound(Set_T set, T value)   Η μικρότερη τιμή >= value, ή NULL
+//   T* set_T_upper_bound(Set_T set, T value)   Η μικρότερη τιμή > value, ή NULL (επόμενη τιμή)
+//   void set_T_destroy(Set_T set)
+//
+// Η compare(a, b) είναι int compare(T a, T b), < 0 αν a < b, όπως η CompareFunc. Οι pointers
+// που επιστρέφονται δείχνουν μέσα στους κόμβους και μένουν έγκυροι μέχρι την αφαίρεση της
+// τιμής. Η διάσχιση γίνεται με set_T_first και set_T_upper_bound (O(logn) ανά βήμα).
+
+#define DEFINE_SET(T, compare)																\
+																							\
+typedef struct set_##T##_node {																\
+	struct set_##T##_node* left;															\
+	struct set_##T##_node* right;															\
+	int height;																				\
+	T value;																				\
+}* SetNode_##T;																				\
+																							\
+typedef struct set_##T {																	\
+	SetNode_##T root;																		\
+	int size;																				\
+}* Set_##T;																					\
+																							\
+static inline int set_##T##_height(SetNode_##T node) {										\
+	return node != NULL ? node->height : 0;													\
+}																							\
+																							\
+static inline void set_##T##_update_height(SetNode_##T node) {								\
+	int left = set_##T##_height(node->left), right = set_##T##_height(node->right);		\
+	node->height = 1 + (left > right ? left : right);										\
+}																							\
+																							\
+static inline SetNode_##T set_##T##_rotate_left(SetNode_##T node) {							\
+	SetNode_##T right = node->right;														\
+	node->right = right->left;																\
+	right->left = node;																		\
+	set_##T##_update_height(node);															\
+	set_##T##_update_height(right);															\
+	return right;																			\
+}																							\
+																							\
+static inline SetNode_##T set_##T##_rotate_right(SetNode_##T node) {						\
+	SetNode_##T left = node->left;															\
+	node->left = left->right;																\
+	left->right = node;																		\
+	set_##T##_update_height(node);															\
+	set_##T##_update_height(left);															\
+	return left;																			\
+}																							\
+																							\
+/* Αποκαθιστά την ισορροπία του node (αν χρειάζεται) και επιστρέφει τη νέα ρίζα */			\
+static inline SetNode_##T set_##T##_repair(SetNode_##T node) {								\
+	set_##T##_update_height(node);															\
+	int balance = set_##T##_height(node->left) - set_##T##_height(node->right);			\
+	if (balance > 1) {																		\
+		if (set_##T##_height(node->left->left) < set_##T##_height(node->left->right))		\
+			node->left = set_##T##_rotate_left(node->left);									\
+		return set_##T##_rotate_right(node);												\
+	}																						\
+	if (balance < -1) {																		\
+		if (set_##T##_height(node->right->right) < set_##T##_height(node->right->left))	\
+			node->right = set_##T##_rotate_right(node->right);								\
+		return set_##T##_rotate_left(node);													\
+	}																						\
+	return node;																			\
+}																							\
+																							\
+static inline SetNode_##T set_##T##_node_insert(SetNode_##T node, T value, bool* inserted) {		\
+	if (node == NULL) {																		\
+		node = malloc(sizeof(*node));														\
+		node->left = node->right = NULL;													\
+		node->height = 1;																	\
+		node->value = value;																\
+		*inserted = true;																	\
+		return node;																		\
+	}																						\
+	int diff = compare(value, node->value);													\
+	if (diff == 0) {																		\
+		node->value = value;																\
+		return node;																		\
+	}																						\
+	if (diff < 0)																			\
+		node->left = set_##T##_node_insert(node->left, value, inserted);					\
+	else																					\
+		node->right = set_##T##_node_insert(node->right, value, inserted);					\
+	return set_##T##_repair(node);															\
+}																							\
+																							\
+/* Αφαιρεί τον μικρότερο κόμβο του υποδέντρου, που επιστρέφεται στο *min */				\
+static inline SetNode_##T set_##T##_node_remove_min(SetNode_##T node, SetNode_##T* min) {		\
+	if (node->left == NULL) {																\
+		*min = node;																		\
+		return node->right;																	\
+	}																						\
+	node->left = set_##T##_node_remove_min(node->left, min);								\
+	return set_##T##_repair(node);															\
+}																							\
+																							\
+static inline SetNode_##T set_##T##_node_remove(SetNode_##T node, T value, bool* removed) {		\
+	if (node == NULL)																		\
+		return NULL;																		\
+	int diff = compare(value, node->value);													\
+	if (diff < 0) {																			\
+		node->left = set_##T##_node_remove(node->left, value, removed);					\
+	} else if (diff > 0) {																	\
+		node->right = set_##T##_node_remove(node->right, value, removed);					\
+	} else {																				\
+		*removed = true;																	\
+		SetNode_##T replacement;															\
+		if (node->right == NULL) {															\
+			replacement = node->left;														\
+		} else {																			\
+			SetNode_##T right = set_##T##_node_remove_min(node->right, &replacement);		\
+			replacement->left = node->left;													\
+			replacement->right = right;														\
+		}																					\
+		free(node);																			\
+		return replacement != NULL ? set_##T##_repair(replacement) : NULL;					\
+	}																						\
+	return set_##T##_repair(node);															\
+}																							\
+																							\
+static inline void set_##T##_node_destroy(SetNode_##T node) {										\
+	if (node == NULL)																		\
+		return;																				\
+	set_##T##_node_destroy(node->left);														\
+	set_##T##_node_destroy(node->right);													\
+	free(node);																				\
+}																							\
+																							\
+static inline Set_##T set_##T##_create() {													\
+	Set_##T set = malloc(sizeof(*set));														\
+	set->root = NULL;																		\
+	set->size = 0;																			\
+	return set;																				\
+}																							\
+																							\
+static inline int set_##T##_size(Set_##T set) {												\
+	return set->size;																		\
+}																							\
+																							\
+static inline bool set_##T##_insert(Set_##T set, T value) {									\
+	bool inserted = false;																	\
+	set->root = set_##T##_node_insert(set->root, value, &inserted);						\
+	set->size += inserted;																	\
+	return inserted;																		\
+}																							\
+																							\
+static inline bool set_##T##_remove(Set_##T set, T value) {									\
+	bool removed = false;																	\
+	set->root = set_##T##_node_remove(set->root, value, &removed);							\
+	set->size -= removed;																	\
+	return removed;																			\
+}																							\
+																							\
+static inline T* set_##T##_find(Set_##T set, T value) {										\
+	SetNode_##T node = set->root;															\
+	while (node != NULL) {																	\
+		int diff = compare(value, node->value);												\
+		if (diff == 0)																		\
+			return &node->value;															\
+		node = diff < 0 ? node->left : node->right;											\
+	}																						\
+	return NULL;																			\
+}																							\
+																							\
+static inline T* set_##T##_first(Set_##T set) {												\
+	SetNode_##T node = set->root;															\
+	if (node == NULL)																		\
+		return NULL;																		\
+	while (node->left != NULL)																\
+		node = node->left;																	\
+	return &node->value;																	\
+}																							\
+																							\
+/* Η μικρότερη τιμή >= value (strict == false) ή > value (strict == true) */				\
+static inline T* set_##T##_bound(Set_##T set, T value, bool strict) {						\
+	SetNode_##T node = set->root, found = NULL;												\
+	while (node != NULL) {																	\
+		int diff = compare(value, node->value);												\
+		if (diff < 0 || (diff == 0 && !strict)) {											\
+			found = node;																	\
+			node = node->left;																\
+		} else {																			\
+			node = node->right;																\
+		}																					\
+	}																						\
+	return found != NULL ? &found->value : NULL;											\
+}																							\
+																							\
+static inline T* set_##T##_lower_bound(Set_##T set, T value) {								\
+	return set_##T##_bound(set, value, false);												\
+}																							\
+																							\
+static inline T* set_##T##_upper_bound(Set_##T set, T value) {								\
+	return set_##T##_bound(set, value, true);												\
+}																							\
+																							\
+static inline void set_##T##_destroy(Set_##T set) {											\
+	set_##T##_node_destroy(set->root);														\
+	free(set);																				\
+}
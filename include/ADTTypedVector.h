@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////
+//
+// ADT TypedVector
+//
+// Vector για έναν συγκεκριμένο τύπο T, παραγόμενο με μακροεντολή.
+// Οι τιμές αποθηκεύονται αυτούσιες στον πίνακα (όχι Pointer), οπότε
+// πχ ένας ακέραιος δεν χρειάζεται malloc, και όλες οι συναρτήσεις
+// είναι static inline.
+//
+// Χρήση (μία φορά ανά τύπο, σε header ή .c):
+//   DEFINE_VECTOR(int)
+//   Vector_int vec = vector_int_create(0);
+//   vector_int_insert_last(vec, 42);
+//
+// Ο T πρέπει να είναι ένα όνομα (πχ int, uint32_t, Record), αφού γίνεται
+// μέρος των ονομάτων. Για σύνθετους τύπους χρησιμοποιείται typedef.
+//
+///////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "common_types.h"
+
+#define TYPED_VECTOR_MIN_CAPACITY 10
+
+// Παράγει τον τύπο Vector_T και τις συναρτήσεις:
+//
+//   Vector_T vector_T_create(int size)         Vector με size στοιχεία, με τιμή 0
+//   int vector_T_size(Vector_T vec)
+//   void vector_T_insert_last(Vector_T vec, T value)
+//   void vector_T_remove_last(Vector_T vec)
+//   T vector_T_get_at(Vector_T vec, int pos)
+//   void vector_T_set_at(Vector_T vec, int pos, T value)
+//   T* vector_T_array(Vector_T vec)             Τα στοιχεία, έγκυρα μέχρι την επόμενη αλλαγή μεγέθους
+//   void vector_T_destroy(Vector_T vec)
+//
+// Με pos εκτός ορίων η συμπεριφορά είναι μη ορισμένη (assert), όπως στο ADTVector.
+
+#define DEFINE_VECTOR(T)																\
+																						\
+typedef struct vector_##T {																\
+	T* array;																			\
+	int size;																			\
+	int capacity;																		\
+}* Vector_##T;																			\
+																						\
+static inline Vector_##T vector_##T##_create(int size) {								\
+	Vector_##T vec = malloc(sizeof(*vec));												\
+	vec->size = size;																	\
+	vec->capacity = size < TYPED_VECTOR_MIN_CAPACITY ? TYPED_VECTOR_MIN_CAPACITY : size;	\
+	vec->array = calloc(vec->capacity, sizeof(T));										\
+	return vec;																			\
+}																						\
+																						\
+static inline int vector_##T##_size(Vector_##T vec) {									\
+	return vec->size;																	\
+}																						\
+																						\
+static inline void vector_##T##_insert_last(Vector_##T vec, T value) {					\
+	if (vec->size == vec->capacity) {													\
+		vec->capacity *= 2;																\
+		vec->array = realloc(vec->array, vec->capacity * sizeof(T));					\
+	}																					\
+	vec->array[vec->size++] = value;													\
+}																						\
+																						\
+static inline void vector_##T##_remove_last(Vector_##T vec) {							\
+	assert(vec->size != 0);																\
+	vec->size--;																		\
+}																						\
+																						\
+static inline T vector_##T##_get_at(Vector_##T vec, int pos) {							\
+	assert(pos >= 0 && pos < vec->size);												\
+	return vec->array[pos];																\
+}																						\
+																						\
+static inline void vector_##T##_set_at(Vector_##T vec, int pos, T value) {				\
+	assert(pos >= 0 && pos < vec->size);												\
+	vec->array[pos] = value;															\
+}																						\
+																						\
+static inline T* vector_##T##_array(Vector_##T vec) {									\
+	return vec->array;																	\
+}																						\
+																						\
+static inline void vector_##T##_destroy(Vector_##T vec) {								\
+	free(vec->array);																	\
+	free(vec);																			\
+}
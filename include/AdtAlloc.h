@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////
+//
+// ADT Alloc
+//
+// Μέτρηση (και προαιρετικά αντικατάσταση) των δεσμεύσεων μνήμης των
+// modules. Ενεργοποιείται κατά το compile με -DADT_ALLOC_STATS, πχ
+//   make CFLAGS=-DADT_ALLOC_STATS
+// Χωρίς αυτό τα modules καλούν κατευθείαν malloc/free και οι μετρητές
+// μένουν 0.
+//
+///////////////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "common_types.h"
+
+// Τα modules για τα οποία κρατούνται ξεχωριστοί μετρητές
+
+typedef enum {
+	ADT_VECTOR,
+	ADT_LIST,
+	ADT_MAP,
+	ADT_SET,
+	ADT_PQUEUE,
+	ADT_GRAPH,
+	ADT_DISEASE_MONITOR,
+	ADT_SHARDED_MONITOR,
+	ADT_FROZEN_MONITOR,
+	ADT_CONCURRENT_MAP,
+	ADT_MODULE_NO				// Πλήθος modules, και "όλα τα modules" στην adt_alloc_stats
+} AdtModule;
+
+// Μετρητές ενός module. Κάθε realloc μετράει ως μία δέσμευση και μία αποδέσμευση.
+// Μια περιοχή μετράει στο module που την δέσμευσε, ακόμα κι αν γίνει free από άλλο.
+
+struct adt_alloc_stats {
+	long allocs;				// Πλήθος δεσμεύσεων
+	long frees;					// Πλήθος αποδεσμεύσεων
+	long bytes_live;			// Bytes που είναι δεσμευμένα αυτή τη στιγμή
+	long bytes_peak;			// Μέγιστη τιμή του bytes_live
+};
+typedef struct adt_alloc_stats AdtAllocStats;
+
+// Επιστρέφει τους μετρητές του module, ή το σύνολο όλων αν module == ADT_MODULE_NO.
+
+AdtAllocStats adt_alloc_stats(AdtModule module);
+
+// Μηδενίζει τα allocs και frees όλων των modules, και θέτει bytes_peak = bytes_live.
+
+void adt_alloc_stats_reset();
+
+// Επιστρέφει το όνομα του module (πχ "map"), για εκτύπωση.
+
+String adt_module_name(AdtModule module);
+
+
+// Allocator
+//
+// Οι δεσμεύσεις γίνονται μέσω ενός allocator, που από default είναι τα malloc/realloc/free.
+// Με την adt_set_allocator μπορεί να χρησιμοποιηθεί οποιοσδήποτε άλλος (πχ arena ή bump
+// allocator) χωρίς αλλαγές στα modules. Η release δέχεται και το μέγεθος της περιοχής. Αν
+// resize == NULL, το realloc γίνεται με alloc, αντιγραφή και release.
+//
+// Ο allocator πρέπει να οριστεί πριν από οποιαδήποτε δέσμευση (ή αφού έχουν αποδεσμευτεί όλες),
+// αφού μια περιοχή πρέπει να επιστραφεί στον allocator που τη δέσμευσε. Με allocator == NULL
+// επανέρχεται ο default.
+
+struct adt_allocator {
+	Pointer (*alloc)(Pointer context, size_t size);
+	Pointer (*resize)(Pointer context, Pointer ptr, size_t old_size, size_t new_size);
+	void (*release)(Pointer context, Pointer ptr, size_t size);
+	Pointer context;			// Περνάει σε κάθε κλήση
+};
+typedef struct adt_allocator AdtAllocator;
+
+void adt_set_allocator(AdtAllocator* allocator);
+
+
+// Οι αντίστοιχες των malloc/calloc/realloc/free, με μέτρηση. Η adt_free δεν χρειάζεται
+// module, αφού αυτό αποθηκεύεται μαζί με το μέγεθος πριν από κάθε περιοχή.
+
+Pointer adt_malloc(AdtModule module, size_t size);
+
+Pointer adt_calloc(AdtModule module, size_t count, size_t size);
+
+Pointer adt_realloc(AdtModule module, Pointer ptr, size_t size);
+
+void adt_free(Pointer ptr);
+
+
+// Ενα module που θέλει να μετράει τις δεσμεύσεις του ορίζει το ADT_MODULE και κάνει include
+// αυτό το αρχείο μετά από όλα τα system headers. Με ADT_ALLOC_STATS οι κλήσεις (και οι
+// pointers, πχ list_create(free)) στα malloc/calloc/realloc/free γίνονται κλήσεις των adt_*.
+
+#if defined(ADT_ALLOC_STATS) && defined(ADT_MODULE)
+#define malloc(size) adt_malloc(ADT_MODULE, size)
+#define calloc(count, size) adt_calloc(ADT_MODULE, count, size)
+#define realloc(ptr, size) adt_realloc(ADT_MODULE, ptr, size)
+#define free adt_free
+#endif
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////
+//
+// ADT Hash
+//
+// Συναρτήσεις κατακερματισμού για τα hash_* του ADTMap, και για όποιο
+// module φτιάχνει τις δικές του (πχ για σύνθετα κλειδιά). Ολες είναι
+// static inline, οπότε δεν χρειάζεται κάποιο επιπλέον .o για το link.
+//
+// Το αποτέλεσμα έχει καλή ανάμειξη σε όλα τα bits, ώστε να μπορεί να
+// χρησιμοποιηθεί και με πίνακες μεγέθους δύναμης του 2 (μόνο τα χαμηλά bits).
+//
+///////////////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include <stdint.h>
+#include <string.h>
+
+#include "common_types.h"
+
+// Σταθερές του wyhash (περιττοί αριθμοί με τυχαία κατανομή των bits)
+
+#define ADT_HASH_P0 0xa0761d6478bd642fULL
+#define ADT_HASH_P1 0xe7037ed1a0b428dbULL
+#define ADT_HASH_P2 0x8ebc6af09c88c6e3ULL
+
+// Πολλαπλασιασμός 64x64 => 128 bits και xor των δύο μισών. Κάθε bit του αποτελέσματος
+// εξαρτάται από όλα τα bits των a και b.
+
+static inline uint64_t adt_hash_mum(uint64_t a, uint64_t b) {
+	__uint128_t r = (__uint128_t)a * b;
+	return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+// Αναγνώσεις 8 / 4 bytes από οποιαδήποτε (και μη ευθυγραμμισμένη) διεύθυνση
+
+static inline uint64_t adt_hash_read64(const uint8_t* p) {
+	uint64_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static inline uint64_t adt_hash_read32(const uint8_t* p) {
+	uint32_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+// Hash των size bytes από το data, με τη δομή του wyhash: 16 bytes ανά επανάληψη, και για
+// μικρά κλειδιά (<= 16 bytes) το πολύ 4 αναγνώσεις που επικαλύπτονται, χωρίς επανάληψη.
+
+static inline uint64_t adt_hash_bytes(const void* data, size_t size, uint64_t seed) {
+	const uint8_t* p = data;
+	uint64_t a, b;
+	seed ^= adt_hash_mum(seed ^ ADT_HASH_P0, ADT_HASH_P1);
+
+	if (size <= 16) {
+		if (size >= 4) {
+			size_t middle = (size >> 3) << 2;		// 0 ή 4
+			a = (adt_hash_read32(p) << 32) | adt_hash_read32(p + middle);
+			b = (adt_hash_read32(p + size - 4) << 32) | adt_hash_read32(p + size - 4 - middle);
+		} else if (size > 0) {
+			a = ((uint64_t)p[0] << 16) | ((uint64_t)p[size >> 1] << 8) | p[size - 1];
+			b = 0;
+		} else {
+			a = b = 0;
+		}
+	} else {
+		size_t left = size;
+		while (left > 16) {
+			seed = adt_hash_mum(adt_hash_read64(p) ^ ADT_HASH_P1, adt_hash_read64(p + 8) ^ seed);
+			p += 16;
+			left -= 16;
+		}
+		// Τα τελευταία 16 bytes (μπορεί να επικαλύπτονται με τα προηγούμενα)
+		a = adt_hash_read64(p + left - 16);
+		b = adt_hash_read64(p + left - 8);
+	}
+
+	return adt_hash_mum(ADT_HASH_P1 ^ size, adt_hash_mum(a ^ ADT_HASH_P1, b ^ seed));
+}
+
+// Finalizer ενός ακεραίου 64 bits (του splitmix64): αντιστρέψιμος, οπότε διαφορετικές
+// τιμές δίνουν πάντα διαφορετικό αποτέλεσμα, και κάθε bit της τιμής αλλάζει περίπου τα
+// μισά bits του αποτελέσματος.
+
+static inline uint64_t adt_hash_u64(uint64_t value) {
+	value ^= value >> 30;
+	value *= 0xbf58476d1ce4e5b9ULL;
+	value ^= value >> 27;
+	value *= 0x94d049bb133111ebULL;
+	value ^= value >> 31;
+	return value;
+}
+
+// Συνδυάζει δύο hashes (πχ των πεδίων ενός σύνθετου κλειδιού), ανάλογα με τη σειρά τους
+
+static inline uint64_t adt_hash_combine(uint64_t a, uint64_t b) {
+	return adt_hash_mum(a ^ ADT_HASH_P0, b ^ ADT_HASH_P2);
+}
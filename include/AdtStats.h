@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////
+//
+// ADT Stats
+//
+// Ιστογράμματα (χρόνοι, βάθη κλπ) για εσωτερικά γεγονότα των modules,
+// πχ rehash στο ADTMap ή rotations στο AVL. Οι μετρήσεις γίνονται
+// μόνο με compile με -DADT_STATS, πχ
+//   make CFLAGS=-DADT_STATS
+// Χωρίς αυτό οι μακροεντολές ADT_STATS_* δεν παράγουν κώδικα.
+//
+///////////////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include <stdint.h>
+#include <time.h>
+
+#include "common_types.h"
+
+// Ιστόγραμμα μη αρνητικών ακεραίων τιμών, τύπου HDR: οι τιμές 0..15 έχουν δική τους θέση,
+// και κάθε μεγαλύτερη δύναμη του 2 χωρίζεται σε 8 ίσες θέσεις, οπότε κάθε percentile έχει
+// σχετικό σφάλμα το πολύ 12.5%. Η καταγραφή είναι O(1) (μερικές atomic προσθέσεις), χωρίς
+// δεσμεύσεις μνήμης, και μπορεί να γίνεται ταυτόχρονα από πολλά threads.
+//
+// Ενα ιστόγραμμα με όλα τα πεδία 0 (πχ static) είναι έτοιμο για χρήση.
+
+#define ADT_HISTOGRAM_BUCKETS 496
+
+struct adt_histogram {
+	_Atomic long count;
+	_Atomic long sum;
+	_Atomic long max;
+	_Atomic long buckets[ADT_HISTOGRAM_BUCKETS];
+};
+typedef struct adt_histogram AdtHistogram;
+
+void adt_histogram_record(AdtHistogram* histogram, uint64_t value);
+
+// Επιστρέφει την τιμή κάτω από την οποία (ή ίση) βρίσκεται το percent% (0 < percent <= 100)
+// των τιμών, στρογγυλεμένη προς τα πάνω στο όριο της θέσης της (ποτέ πάνω από το max).
+// Επιστρέφει 0 αν το ιστόγραμμα είναι κενό.
+
+uint64_t adt_histogram_percentile(AdtHistogram* histogram, double percent);
+
+void adt_histogram_reset(AdtHistogram* histogram);
+
+
+// Εσωτερικά γεγονότα των modules, το καθένα με το ιστόγραμμά του
+
+typedef enum {
+	ADT_EVENT_MAP_REHASH,			// Διάρκεια κάθε rehash του ADTMap (ns)
+	ADT_EVENT_SET_ROTATION,			// Κάθε απλό rotation του AVL, με τιμή 1 (ένα διπλό μετράει 2 φορές)
+	ADT_EVENT_PQUEUE_SIFT_UP,		// Επίπεδα που ανέβηκε ένας κόμβος του σωρού (bubble_up)
+	ADT_EVENT_PQUEUE_SIFT_DOWN,		// Επίπεδα που κατέβηκε ένας κόμβος του σωρού (bubble_down)
+	ADT_EVENT_NO
+} AdtEvent;
+
+void adt_stats_event(AdtEvent event, uint64_t value);
+
+AdtHistogram* adt_stats_histogram(AdtEvent event);
+
+// Το όνομα του γεγονότος (πχ "map_rehash_ns"), για εκτύπωση
+
+String adt_event_name(AdtEvent event);
+
+void adt_stats_reset();
+
+// Τρέχουσα χρονική στιγμή σε ns
+
+static inline uint64_t adt_stats_now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+
+// Μακροεντολές για τα modules. Πχ για τη διάρκεια μιας λειτουργίας:
+//   ADT_STATS_START(start);
+//   ...
+//   ADT_STATS_EVENT(ADT_EVENT_MAP_REHASH, ADT_STATS_ELAPSED(start));
+// Χωρίς ADT_STATS δεν υπολογίζεται καν η τιμή.
+
+#ifdef ADT_STATS
+#define ADT_STATS_START(timer) uint64_t timer = adt_stats_now()
+#define ADT_STATS_ELAPSED(timer) (adt_stats_now() - timer)
+#define ADT_STATS_EVENT(event, value) adt_stats_event(event, value)
+#define ADT_STATS_RECORD(histogram, value) adt_histogram_record(histogram, value)
+#else
+#define ADT_STATS_START(timer)
+#define ADT_STATS_ELAPSED(timer)
+#define ADT_STATS_EVENT(event, value)
+#define ADT_STATS_RECORD(histogram, value)
+#endif
@@ -9,6 +9,7 @@
 #pragma once // #include το πολύ μία φορά
 
 #include "ADTList.h"
+#include "ADTSet.h"
 
 // Οι ημερομηνίες δίνονται σαν Strings, σε format YYYY-MM-DD, πχ "2019-10-31"
 typedef String Date;
@@ -75,6 +76,25 @@ bool dm_remove_record(int id);
 
 List dm_get_records(String disease, String country, Date date_from, Date date_to);
 
+// Διάσχιση των εγγραφών που ικανοποιούν τα κριτήρια χωρίς τη δημιουργία λίστας.
+// Ο cursor δημιουργείται από τον χρήστη (πχ ως τοπική μεταβλητή) και αρχικοποιείται
+// με την dm_records_cursor. Κάθε κλήση της dm_cursor_next επιστρέφει την επόμενη
+// εγγραφή σε χρονολογική σειρά, ή NULL όταν δεν υπάρχουν άλλες. Δεν γίνεται καμία
+// δέσμευση μνήμης.
+//
+// Οποιαδήποτε προσθήκη ή αφαίρεση εγγραφής ακυρώνει τους υπάρχοντες cursors.
+
+struct dm_cursor {
+	Set set;			// Το set στο οποίο γίνεται η διάσχιση
+	SetNode node;		// Ο κόμβος που θα επιστραφεί στην επόμενη κλήση
+	Date date_to;		// Πάνω όριο ημερομηνίας (NULL αν δεν υπάρχει)
+};
+typedef struct dm_cursor DmCursor;
+
+void dm_records_cursor(DmCursor* cursor, String disease, String country, Date date_from, Date date_to);
+
+Record dm_cursor_next(DmCursor* cursor);
+
 // Επιστρέφει τον αριθμό εγγραφών που ικανοποιούν τα συγκεκριμένα κριτήρια.
 
 int dm_count_records(String disease, String country, Date date_from, Date date_to);
@@ -89,3 +109,246 @@ int dm_count_records(String disease, String country, Date date_from, Date date_t
 
 List dm_top_diseases(int k, String country);
 
+// Όπως η dm_top_diseases, αλλά μετρώντας μόνο τις εγγραφές με ημερομηνία από
+// date_from μέχρι date_to (χωρίς όριο, αν NULL).
+//
+// Πχ η dm_top_diseases_range(3, "Italy", "2020-03-01", "2020-03-14") επιστρέφει τις
+// 3 ασθένειες με τις περισσότερες εγγραφές στην Ιταλία μέσα σε αυτές τις 14 ημέρες.
+
+List dm_top_diseases_range(int k, String country, Date date_from, Date date_to);
+
+
+// Επιστρέφει την πρώτη ημερομηνία μέχρι την οποία (συμπεριλαμβανομένης) έχει
+// καταγραφεί τουλάχιστον το percent% (0 <= percent <= 100) των εγγραφών που
+// ικανοποιούν τα κριτήρια, ή NULL αν δεν υπάρχουν τέτοιες εγγραφές.
+//
+// Πχ η dm_percentile_date(NULL, "Germany", NULL, NULL, 90) επιστρέφει την
+// ημερομηνία μέχρι την οποία είχε καταγραφεί το 90% των εγγραφών στη Γερμανία,
+// και με percent = 50 παίρνουμε τη διάμεση ημερομηνία.
+
+Date dm_percentile_date(String disease, String country, Date date_from, Date date_to, int percent);
+
+
+
+// Επιστρέφει τον αριθμό εγγραφών που ικανοποιούν ένα φίλτρο με οποιονδήποτε συνδυασμό χωρών,
+// ασθενειών και ημερομηνιών. Σε κάθε πεδίο του φίλτρου NULL (ή πλήθος 0) σημαίνει χωρίς κριτήριο.
+//
+// Πχ με countries = { "Italy", "Spain" } και diseases = { "COVID-19", "Flu" } μετράει τις εγγραφές
+// που είναι από μία από τις δύο χώρες με μία από τις δύο ασθένειες.
+//
+// Για τέτοια queries δεν υπάρχουν indexes, οπότε με την πρώτη κλήση το monitor δημιουργεί ένα
+// αντίγραφο των εγγραφών σε στήλες (χώρα, ασθένεια, ημέρα ως ακέραιοι) και από εκεί και πέρα το
+// ενημερώνει σε κάθε αλλαγή. Κάθε κλήση είναι ένα σειριακό πέρασμα O(n) των στηλών, που ελέγχει
+// 4 εγγραφές τη φορά με εντολές SSE2 (όπου υπάρχουν).
+
+struct dm_filter {
+	String* countries;		// Μία από τις country_no χώρες
+	int country_no;
+	String* diseases;		// Μία από τις disease_no ασθένειες
+	int disease_no;
+	Date date_from;			// Ημερομηνία date_from ή μεταγενέστερη
+	Date date_to;			// Ημερομηνία date_to ή προγενέστερη
+};
+typedef struct dm_filter DmFilter;
+
+int dm_count_where(DmFilter* filter);
+
+// Πολλαπλά monitors ////////////////////////////////////////////////////////////
+//
+// Οι συναρτήσεις dm_* λειτουργούν πάνω σε ένα μοναδικό, global monitor. Για να
+// υπάρχουν πολλά ανεξάρτητα monitors στο ίδιο πρόγραμμα (πχ ένα ανά περιοχή, ή ένα
+// ανά thread) χρησιμοποιείται ο τύπος DiseaseMonitor και οι συναρτήσεις monitor_*,
+// που έχουν ακριβώς την ίδια συμπεριφορά με τις αντίστοιχες dm_*. Διαφορετικά
+// monitors δεν μοιράζονται καμία δομή.
+
+typedef struct disease_monitor* DiseaseMonitor;
+
+// Δημιουργεί και επιστρέφει ένα νέο, κενό monitor.
+
+DiseaseMonitor dm_create();
+
+// Καταστρέφει το monitor, χωρίς να κάνει free τα records.
+
+void dm_free(DiseaseMonitor monitor);
+
+bool monitor_insert_record(DiseaseMonitor monitor, Record record);
+
+bool monitor_remove_record(DiseaseMonitor monitor, int id);
+
+List monitor_get_records(DiseaseMonitor monitor, String disease, String country, Date date_from, Date date_to);
+
+void monitor_records_cursor(DiseaseMonitor monitor, DmCursor* cursor, String disease, String country, Date date_from, Date date_to);
+
+int monitor_count_records(DiseaseMonitor monitor, String disease, String country, Date date_from, Date date_to);
+
+List monitor_top_diseases(DiseaseMonitor monitor, int k, String country);
+
+List monitor_top_diseases_range(DiseaseMonitor monitor, int k, String country, Date date_from, Date date_to);
+
+Date monitor_percentile_date(DiseaseMonitor monitor, String disease, String country, Date date_from, Date date_to, int percent);
+
+int monitor_count_where(DiseaseMonitor monitor, DmFilter* filter);
+
+// Μια ασθένεια και το πλήθος των εγγραφών της. Η dm_compare_cases τις συγκρίνει ως προς
+// το πλήθος (CompareFunc, πχ για pqueue με πρώτη την ασθένεια με τις περισσότερες εγγραφές).
+
+typedef struct dis_cases* DisCases;
+
+struct dis_cases {
+	String disease;
+	int cases;
+};
+
+int dm_compare_cases(Pointer a, Pointer b);
+
+// Επιστρέφει λίστα με ένα DisCases για κάθε ασθένεια του monitor (με τουλάχιστον 1 εγγραφή),
+// σε οποιαδήποτε σειρά. Τα πλήθη είναι αυτά που κρατάει ήδη το monitor για τη dm_top_diseases,
+// οπότε δεν γίνεται καμία καταμέτρηση. Η list_destroy κάνει free και τα DisCases.
+
+List monitor_disease_cases(DiseaseMonitor monitor);
+
+
+// Εγγραφές που ανήκουν στο monitor ////////////////////////////////////////////
+//
+// Ενα monitor που δημιουργείται με dm_create_owning (και το default monitor μετά από
+// dm_init_owning) δεν κρατάει τους pointers που του δίνονται, αλλά αντίγραφα των εγγραφών σε
+// ένα arena, δηλαδή μεγάλα blocks μνήμης που ανήκουν στο monitor. Το name κάθε εγγραφής
+// αποθηκεύεται αμέσως μετά την εγγραφή, ενώ κάθε διαφορετική ασθένεια, χώρα και ημερομηνία
+// αποθηκεύεται μία φορά (interning). Ετσι κάθε εγγραφή κοστίζει μία συνεχόμενη περιοχή μνήμης
+// αντί για 5 ξεχωριστά malloc.
+//
+// Ο χρήστης μπορεί να αλλάξει ή να κάνει free την εγγραφή του αμέσως μετά την insert, και τα
+// queries επιστρέφουν τα αντίγραφα. Ολη η μνήμη γίνεται free μαζί στο dm_free / dm_destroy
+// (όχι στη remove ή όταν μια εγγραφή αντικατασταθεί από άλλη με το ίδιο id). Τα snapshots ενός
+// τέτοιου monitor πρέπει να καταστραφούν πριν από αυτό.
+
+DiseaseMonitor dm_create_owning();
+
+void dm_init_owning();
+
+// Ταυτόχρονη πρόσβαση /////////////////////////////////////////////////////////
+//
+// Ενα monitor που δημιουργείται με dm_create_concurrent μπορεί να χρησιμοποιείται
+// ταυτόχρονα από πολλά threads. Τα queries (monitor_get_records, monitor_count_records,
+// κλπ) εκτελούνται παράλληλα μεταξύ τους κάτω από ένα read lock, ενώ οι αλλαγές
+// παίρνουν το write lock. Για λιγότερες διακοπές των queries οι προσθήκες μπορούν
+// να γίνονται σε ομάδες με τη monitor_insert_records.
+//
+// Η monitor_records_cursor και η dm_cursor_next ΔΕΝ παίρνουν lock. Αν γίνονται ταυτόχρονα
+// αλλαγές, η δημιουργία του cursor και όλη η διάσχιση γίνονται ανάμεσα σε monitor_read_lock
+// και monitor_read_unlock. Το lock δεν είναι recursive, οπότε όσο κρατείται δεν καλούνται
+// άλλες συναρτήσεις monitor_* του ίδιου monitor.
+
+DiseaseMonitor dm_create_concurrent();
+
+// Προσθέτει τις n εγγραφές του records με μία απόκτηση του write lock. Επιστρέφει
+// πόσες από αυτές αντικατέστησαν εγγραφή με το ίδιο id.
+
+int monitor_insert_records(DiseaseMonitor monitor, Record records[], int n);
+
+// Παίρνει / αφήνει το read lock του monitor (δεν κάνουν τίποτα σε monitor που
+// δημιουργήθηκε με dm_create).
+
+void monitor_read_lock(DiseaseMonitor monitor);
+
+void monitor_read_unlock(DiseaseMonitor monitor);
+
+
+// Snapshots ///////////////////////////////////////////////////////////////////
+//
+// Ενα snapshot είναι ένα monitor με τις εγγραφές που υπήρχαν τη στιγμή της δημιουργίας
+// του, στο οποίο μπορούν να γίνονται queries (monitor_*) όσο χρειάζεται ενώ το αρχικό
+// monitor συνεχίζει να αλλάζει (και από άλλο thread, αν είναι concurrent). Δεν επιτρέπονται
+// αλλαγές (insert/remove) στο ίδιο το snapshot. Καταστρέφεται με dm_free.
+//
+// Οι εγγραφές του snapshot είναι οι ίδιοι pointers με του monitor, οπότε μια εγγραφή δεν
+// πρέπει να γίνει free (ή να αλλάξει) όσο υπάρχει snapshot που την περιέχει, ακόμα κι αν
+// έχει αφαιρεθεί από το monitor.
+//
+// Τα sets των εγγραφών γίνονται set_snapshot. Με το UsingPersistentAVL αυτό είναι O(1), οπότε
+// το snapshot κοστίζει O(χώρες x ασθένειες) ανεξάρτητα από το πλήθος των εγγραφών.
+
+DiseaseMonitor monitor_snapshot(DiseaseMonitor monitor);
+
+// Snapshot του default monitor
+
+DiseaseMonitor dm_snapshot();
+
+
+// Αποθήκευση / φόρτωση ////////////////////////////////////////////////////////
+//
+// Η monitor_save γράφει όλες τις εγγραφές του monitor σε δυαδικό αρχείο. Η monitor_load
+// δημιουργεί νέο monitor από ένα τέτοιο αρχείο, χτίζοντας όλες τις δομές σε γραμμικό
+// χρόνο (χωρίς διαδοχικές monitor_insert_record). Οι εγγραφές του νέου monitor (και
+// τα strings τους) ανήκουν στο monitor και γίνονται free στο dm_free.
+//
+// Η monitor_save επιστρέφει false αν απέτυχε η εγγραφή, η monitor_load NULL αν το
+// αρχείο δεν υπάρχει ή δεν είναι έγκυρο.
+
+bool monitor_save(DiseaseMonitor monitor, String path);
+
+DiseaseMonitor monitor_load(String path);
+
+// Αντίστοιχα για το default monitor. Μετά από επιτυχημένη dm_load το default monitor
+// περιέχει μόνο τις εγγραφές του αρχείου (και δεν χρειάζεται dm_init).
+
+bool dm_save(String path);
+
+bool dm_load(String path);
+
+
+// Εισαγωγή από CSV/TSV ////////////////////////////////////////////////////////
+//
+// Η monitor_ingest_csv διαβάζει εγγραφές από το file descriptor fd μέχρι το τέλος του, μία ανά
+// γραμμή, με πεδία id, name, disease, country, date (η σειρά του struct record) χωρισμένα με ','
+// ή με tab (το διαχωριστικό της πρώτης γραμμής ισχύει για όλο το αρχείο). Αν η πρώτη γραμμή δεν
+// ξεκινάει με αριθμό θεωρείται επικεφαλίδα και αγνοείται. Δεν υποστηρίζονται πεδία σε εισαγωγικά.
+// Γραμμές με λάθος πλήθος πεδίων, μη αριθμητικό id ή ημερομηνία εκτός μορφής YYYY-MM-DD
+// (ή που δεν υπάρχει, πχ 2020-02-30) παραλείπονται και μετράνε στα rejected.
+//
+// Το αρχείο διαβάζεται σε μεγάλα blocks και τα πεδία χωρίζονται μέσα στο ίδιο το block (δεν
+// φτιάχνονται αντίγραφα των strings), ενώ οι εγγραφές δεσμεύονται σε ομάδες και προστίθενται με
+// τη monitor_insert_records. Τα blocks και οι εγγραφές ανήκουν στο monitor και γίνονται free στο
+// dm_free (και όσες εγγραφές αφαιρεθούν ή αντικατασταθούν στο μεταξύ).
+//
+// Επιστρέφει το πλήθος των εγγραφών που προστέθηκαν, ή -1 αν απέτυχε η ανάγνωση (όσες εγγραφές
+// διαβάστηκαν πριν το σφάλμα έχουν ήδη προστεθεί). Αν stats != NULL συμπληρώνεται με το πλήθος
+// των bytes/εγγραφών και τον χρόνο κάθε σταδίου (πχ bytes / read_seconds είναι η ταχύτητα ανάγνωσης).
+
+struct dm_ingest_stats {
+	long bytes;				// Bytes που διαβάστηκαν
+	int records;			// Εγγραφές που προστέθηκαν
+	int rejected;			// Γραμμές που παραλείφθηκαν
+	double read_seconds;	// Χρόνος ανάγνωσης (read)
+	double parse_seconds;	// Χρόνος χωρισμού γραμμών και πεδίων
+	double insert_seconds;	// Χρόνος προσθήκης στο monitor
+};
+typedef struct dm_ingest_stats DmIngestStats;
+
+int monitor_ingest_csv(DiseaseMonitor monitor, int fd, DmIngestStats* stats);
+
+int dm_ingest_csv(int fd, DmIngestStats* stats);
+
+
+// Στατιστικά //////////////////////////////////////////////////////////////////
+//
+// Με compile με -DADT_STATS κάθε κλήση dm_* (εκτός της dm_cursor_next) καταγράφει τη διάρκειά
+// της σε ένα ιστόγραμμα (βλ. AdtStats.h), και τα modules καταγράφουν εσωτερικά γεγονότα: διάρκεια
+// κάθε rehash των maps, rotations των AVL και επίπεδα που μετακινείται ένας κόμβος σε κάθε σωρό.
+// Το κόστος είναι δύο αναγνώσεις του ρολογιού και μερικές atomic προσθέσεις ανά κλήση. Χωρίς
+// ADT_STATS δεν γίνεται καμία καταγραφή και όλα τα ιστογράμματα είναι κενά.
+//
+// Η dm_stats_dump γράφει στο fd το πλήθος, το άθροισμα, το μέγιστο και τα p50/p90/p99/p999 κάθε
+// ιστογράμματος (και τις δεσμεύσεις μνήμης ανά module, αν υπάρχει και το ADT_ALLOC_STATS), σε
+// JSON ή στη μορφή κειμένου του Prometheus. Επιστρέφει false αν απέτυχε η εγγραφή.
+
+typedef enum {
+	DM_STATS_JSON,
+	DM_STATS_PROMETHEUS
+} DmStatsFormat;
+
+bool dm_stats_dump(int fd, DmStatsFormat format);
+
+// Αδειάζει όλα τα ιστογράμματα
+
+void dm_stats_reset();
@@ -0,0 +1,49 @@
+///////////////////////////////////////////////////////////////////
+//
+// Frozen Disease Monitor
+//
+// Αμετάβλητη (read-only) μορφή ενός DiseaseMonitor, αποθηκευμένη σε
+// ένα αρχείο χωρίς pointers (μόνο θέσεις μέσα στο αρχείο). Το αρχείο
+// γίνεται mmap και τα queries εκτελούνται κατευθείαν πάνω του, οπότε
+// το άνοιγμα είναι O(1) ανεξάρτητα από το πλήθος των εγγραφών.
+//
+///////////////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include "DiseaseMonitor.h"
+
+// Ενα frozen monitor αναπαριστάται από τον τύπο FrozenMonitor
+
+typedef struct frozen_monitor* FrozenMonitor;
+
+
+// Γράφει στο αρχείο path τη frozen μορφή των εγγραφών που περιέχει αυτή τη στιγμή το
+// monitor. Για κάθε χώρα, ασθένεια και συνδυασμό τους αποθηκεύεται ένας ταξινομημένος
+// πίνακας (ημερομηνία, id), ένας πίνακας κατακερματισμού για την εύρεσή τους, και οι
+// ασθένειες κάθε χώρας (και συνολικά) ταξινομημένες με βάση το πλήθος των εγγραφών.
+// Επιστρέφει false αν απέτυχε η εγγραφή.
+
+bool frozen_build(DiseaseMonitor monitor, String path);
+
+// Ανοίγει (mmap) ένα αρχείο που δημιουργήθηκε με frozen_build. Ελέγχεται μόνο το header,
+// οπότε το κόστος δεν εξαρτάται από το μέγεθος του αρχείου. Επιστρέφει NULL αν το αρχείο
+// δεν υπάρχει ή δεν είναι έγκυρο.
+
+FrozenMonitor frozen_open(String path);
+
+// Κλείνει το αρχείο. Τα strings που έχουν επιστραφεί από queries παύουν να είναι έγκυρα.
+
+void frozen_close(FrozenMonitor monitor);
+
+
+// Queries
+//
+// Ίδια συμπεριφορά με τις αντίστοιχες dm_*. Η frozen_count_records κάνει δυαδική αναζήτηση
+// στον πίνακα του κατάλληλου συνδυασμού χώρας/ασθένειας, σε O(logn). Η frozen_top_diseases
+// επιστρέφει τις πρώτες k από τις ήδη ταξινομημένες ασθένειες· τα strings της λίστας
+// δείχνουν μέσα στο αρχείο (μέχρι την frozen_close).
+
+int frozen_count_records(FrozenMonitor monitor, String disease, String country, Date date_from, Date date_to);
+
+List frozen_top_diseases(FrozenMonitor monitor, int k, String country);
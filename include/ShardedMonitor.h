@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////
+//
+// Sharded Disease Monitor
+//
+// Monitor που μοιράζει τις εγγραφές, με βάση τη χώρα τους, σε N
+// ανεξάρτητα DiseaseMonitors (shards). Κάθε shard έχει το δικό του
+// thread που εφαρμόζει τις προσθήκες/αφαιρέσεις, οπότε η εισαγωγή
+// εγγραφών κλιμακώνεται με το πλήθος των πυρήνων.
+//
+///////////////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include "DiseaseMonitor.h"
+
+// Ενα sharded monitor αναπαριστάται από τον τύπο ShardedMonitor
+
+typedef struct sharded_monitor* ShardedMonitor;
+
+
+// Δημιουργεί ένα sharded monitor με shards ανεξάρτητα shards (και ισάριθμα threads).
+
+ShardedMonitor sharded_create(int shards);
+
+// Εφαρμόζει όσες αλλαγές εκκρεμούν, σταματάει τα threads και καταστρέφει όλα τα shards.
+// ΔΕΝ κάνει free τα records.
+
+void sharded_destroy(ShardedMonitor monitor);
+
+// Επιστρέφει το πλήθος των shards
+
+int sharded_shards(ShardedMonitor monitor);
+
+
+// Προσθήκη / αφαίρεση εγγραφών
+//
+// Οι συναρτήσεις αυτές απλά βάζουν την αλλαγή στην ουρά του κατάλληλου shard (μέσω
+// lock-free ουράς, οπότε μπορούν να καλούνται ταυτόχρονα από πολλά threads) και
+// επιστρέφουν αμέσως. Οι αλλαγές κάθε shard εφαρμόζονται με τη σειρά που μπήκαν
+// στην ουρά. Για να είναι σίγουρο ότι οι αλλαγές έχουν εφαρμοστεί (και φαίνονται
+// στα queries) καλείται η sharded_flush.
+//
+// Αφού ο προορισμός μιας εγγραφής εξαρτάται από τη χώρα της, η αντικατάσταση μιας
+// εγγραφής από άλλη με το ίδιο id αλλά διαφορετική χώρα πρέπει να γίνεται με
+// sharded_remove_record και μετά sharded_insert_record.
+
+void sharded_insert_record(ShardedMonitor monitor, Record record);
+
+void sharded_remove_record(ShardedMonitor monitor, int id);
+
+// Περιμένει μέχρι να εφαρμοστούν όλες οι αλλαγές που μπήκαν στις ουρές πριν την κλήση.
+
+void sharded_flush(ShardedMonitor monitor);
+
+
+// Queries
+//
+// Ίδια συμπεριφορά με τις αντίστοιχες dm_*. Αν τα κριτήρια περιλαμβάνουν χώρα το query
+// γίνεται μόνο στο shard της χώρας, αλλιώς γίνεται σε όλα τα shards και τα αποτελέσματα
+// συνδυάζονται (τα πλήθη αθροίζονται, οι λίστες ενώνονται, οι ασθένειες κατατάσσονται
+// με βάση τα συνολικά πλήθη). Μπορούν να καλούνται ενώ γίνονται εισαγωγές.
+
+List sharded_get_records(ShardedMonitor monitor, String disease, String country, Date date_from, Date date_to);
+
+int sharded_count_records(ShardedMonitor monitor, String disease, String country, Date date_from, Date date_to);
+
+List sharded_top_diseases(ShardedMonitor monitor, int k, String country);
@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////
+//
+// ADT Alloc
+//
+// Κάθε περιοχή έχει πριν από την αρχή της ένα header με το μέγεθος
+// και το module της. Το header έχει μέγεθος max_align_t, ώστε η
+// περιοχή που επιστρέφεται να έχει την ίδια στοίχιση με του malloc.
+//
+///////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "AdtAlloc.h"
+
+typedef union header* Header;
+
+union header {
+	struct {
+		size_t size;
+		AdtModule module;
+	};
+	max_align_t align;
+};
+
+// Οι μετρητές είναι atomic γιατί δεσμεύσεις γίνονται από πολλά threads (πχ ShardedMonitor).
+// Η θέση ADT_MODULE_NO κρατάει το σύνολο, χρειάζεται ξεχωριστά γιατί το συνολικό peak δεν
+// είναι το άθροισμα των peaks.
+
+struct counters {
+	atomic_long allocs;
+	atomic_long frees;
+	atomic_long bytes_live;
+	atomic_long bytes_peak;
+};
+
+static struct counters counters[ADT_MODULE_NO + 1];
+
+static String module_names[ADT_MODULE_NO + 1] = {
+	"vector", "list", "map", "set", "pqueue", "graph",
+	"disease_monitor", "sharded_monitor", "frozen_monitor",
+	"concurrent_map",
+	"all"
+};
+
+
+// Default allocator: malloc/realloc/free
+
+static Pointer default_alloc(Pointer context, size_t size) {
+	return malloc(size);
+}
+
+static Pointer default_resize(Pointer context, Pointer ptr, size_t old_size, size_t new_size) {
+	return realloc(ptr, new_size);
+}
+
+static void default_release(Pointer context, Pointer ptr, size_t size) {
+	free(ptr);
+}
+
+static AdtAllocator default_allocator = { default_alloc, default_resize, default_release, NULL };
+
+static AdtAllocator* allocator = &default_allocator;
+
+void adt_set_allocator(AdtAllocator* new_allocator) {
+	allocator = new_allocator != NULL ? new_allocator : &default_allocator;
+}
+
+
+// Μετρητές
+
+static void update_peak(struct counters* c, long live) {
+	long peak = atomic_load_explicit(&c->bytes_peak, memory_order_relaxed);
+	while (live > peak && !atomic_compare_exchange_weak_explicit(&c->bytes_peak, &peak, live,
+			memory_order_relaxed, memory_order_relaxed))
+		;
+}
+
+static void count_alloc(AdtModule module, size_t size) {
+	struct counters* both[] = { &counters[module], &counters[ADT_MODULE_NO] };
+	for (int i = 0; i < 2; i++) {
+		atomic_fetch_add_explicit(&both[i]->allocs, 1, memory_order_relaxed);
+		long live = atomic_fetch_add_explicit(&both[i]->bytes_live, size, memory_order_relaxed) + size;
+		update_peak(both[i], live);
+	}
+}
+
+static void count_free(AdtModule module, size_t size) {
+	struct counters* both[] = { &counters[module], &counters[ADT_MODULE_NO] };
+	for (int i = 0; i < 2; i++) {
+		atomic_fetch_add_explicit(&both[i]->frees, 1, memory_order_relaxed);
+		atomic_fetch_sub_explicit(&both[i]->bytes_live, size, memory_order_relaxed);
+	}
+}
+
+AdtAllocStats adt_alloc_stats(AdtModule module) {
+	struct counters* c = &counters[module];
+	return (AdtAllocStats){
+		.allocs = atomic_load(&c->allocs),
+		.frees = atomic_load(&c->frees),
+		.bytes_live = atomic_load(&c->bytes_live),
+		.bytes_peak = atomic_load(&c->bytes_peak),
+	};
+}
+
+void adt_alloc_stats_reset() {
+	for (int i = 0; i <= ADT_MODULE_NO; i++) {
+		atomic_store(&counters[i].allocs, 0);
+		atomic_store(&counters[i].frees, 0);
+		atomic_store(&counters[i].bytes_peak, atomic_load(&counters[i].bytes_live));
+	}
+}
+
+String adt_module_name(AdtModule module) {
+	return module_names[module];
+}
+
+
+// Δεσμεύσεις
+
+Pointer adt_malloc(AdtModule module, size_t size) {
+	Header header = allocator->alloc(allocator->context, sizeof(*header) + size);
+	if (header == NULL)
+		return NULL;
+
+	header->size = size;
+	header->module = module;
+	count_alloc(module, size);
+	return header + 1;
+}
+
+Pointer adt_calloc(AdtModule module, size_t count, size_t size) {
+	if (size != 0 && count > SIZE_MAX / size)
+		return NULL;
+
+	Pointer ptr = adt_malloc(module, count * size);
+	if (ptr != NULL)
+		memset(ptr, 0, count * size);
+	return ptr;
+}
+
+Pointer adt_realloc(AdtModule module, Pointer ptr, size_t size) {
+	if (ptr == NULL)
+		return adt_malloc(module, size);
+
+	Header header = (Header)ptr - 1;
+	size_t old_size = header->size;
+	AdtModule old_module = header->module;
+
+	Header new_header;
+	if (allocator->resize != NULL) {
+		new_header = allocator->resize(allocator->context, header, sizeof(*header) + old_size, sizeof(*header) + size);
+		if (new_header == NULL)
+			return NULL;				// Το παλιό header δεν έχει αλλάξει
+	} else {
+		new_header = allocator->alloc(allocator->context, sizeof(*header) + size);
+		if (new_header == NULL)
+			return NULL;
+		memcpy(new_header, header, sizeof(*header) + (old_size < size ? old_size : size));
+		allocator->release(allocator->context, header, sizeof(*header) + old_size);
+	}
+
+	// Η περιοχή μετακινείται στο module που κάνει το realloc
+	new_header->size = size;
+	new_header->module = module;
+	count_free(old_module, old_size);
+	count_alloc(module, size);
+	return new_header + 1;
+}
+
+void adt_free(Pointer ptr) {
+	if (ptr == NULL)
+		return;
+
+	Header header = (Header)ptr - 1;
+	count_free(header->module, header->size);
+	allocator->release(allocator->context, header, sizeof(*header) + header->size);
+}
@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////
+//
+// ADT Stats
+//
+///////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdatomic.h>
+
+#include "AdtStats.h"
+
+// Θέσεις του ιστογράμματος. Οι τιμές κάτω από 16 έχουν δική τους θέση. Για μεγαλύτερες, αν
+// το πιο σημαντικό bit είναι το msb (>= 4), η τιμή πέφτει σε μία από τις 8 θέσεις της
+// δύναμης 2^msb ανάλογα με τα 3 επόμενα bits.
+
+#define SUB_BITS 3
+#define SUB_BUCKETS (1 << SUB_BITS)
+#define LINEAR_BUCKETS (2 * SUB_BUCKETS)
+
+static int bucket_of(uint64_t value) {
+	if (value < LINEAR_BUCKETS)
+		return value;
+
+	int msb = 63 - __builtin_clzll(value);
+	int sub = (value >> (msb - SUB_BITS)) & (SUB_BUCKETS - 1);
+	return LINEAR_BUCKETS + (msb - SUB_BITS - 1) * SUB_BUCKETS + sub;
+}
+
+// Η μεγαλύτερη τιμή που πέφτει στη θέση bucket
+
+static uint64_t bucket_limit(int bucket) {
+	if (bucket < LINEAR_BUCKETS)
+		return bucket;
+
+	int msb = (bucket - LINEAR_BUCKETS) / SUB_BUCKETS + SUB_BITS + 1;
+	int sub = (bucket - LINEAR_BUCKETS) % SUB_BUCKETS;
+	int shift = msb - SUB_BITS;
+	return ((uint64_t)(SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+void adt_histogram_record(AdtHistogram* histogram, uint64_t value) {
+	atomic_fetch_add_explicit(&histogram->count, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&histogram->sum, value, memory_order_relaxed);
+	atomic_fetch_add_explicit(&histogram->buckets[bucket_of(value)], 1, memory_order_relaxed);
+
+	long max = atomic_load_explicit(&histogram->max, memory_order_relaxed);
+	while ((long)value > max && !atomic_compare_exchange_weak_explicit(&histogram->max, &max, value,
+			memory_order_relaxed, memory_order_relaxed))
+		;
+}
+
+uint64_t adt_histogram_percentile(AdtHistogram* histogram, double percent) {
+	long count = atomic_load(&histogram->count);
+	if (count == 0)
+		return 0;
+
+	// Η θέση (nearest-rank) της τιμής που ψάχνουμε
+	long rank = (long)(percent / 100 * count + 0.999999);
+	if (rank < 1)
+		rank = 1;
+
+	uint64_t max = atomic_load(&histogram->max);
+	long seen = 0;
+	for (int i = 0; i < ADT_HISTOGRAM_BUCKETS; i++) {
+		seen += atomic_load_explicit(&histogram->buckets[i], memory_order_relaxed);
+		if (seen >= rank) {
+			uint64_t limit = bucket_limit(i);
+			return limit < max ? limit : max;
+		}
+	}
+	return max;		// Καταγραφή σε εξέλιξη από άλλο thread
+}
+
+void adt_histogram_reset(AdtHistogram* histogram) {
+	atomic_store(&histogram->count, 0);
+	atomic_store(&histogram->sum, 0);
+	atomic_store(&histogram->max, 0);
+	for (int i = 0; i < ADT_HISTOGRAM_BUCKETS; i++)
+		atomic_store(&histogram->buckets[i], 0);
+}
+
+
+// Γεγονότα
+
+static AdtHistogram events[ADT_EVENT_NO];
+
+static String event_names[ADT_EVENT_NO] = {
+	"map_rehash_ns",
+	"set_rotation",
+	"pqueue_sift_up_levels",
+	"pqueue_sift_down_levels",
+};
+
+void adt_stats_event(AdtEvent event, uint64_t value) {
+	adt_histogram_record(&events[event], value);
+}
+
+AdtHistogram* adt_stats_histogram(AdtEvent event) {
+	return &events[event];
+}
+
+String adt_event_name(AdtEvent event) {
+	return event_names[event];
+}
+
+void adt_stats_reset() {
+	for (int i = 0; i < ADT_EVENT_NO; i++)
+		adt_histogram_reset(&events[i]);
+}
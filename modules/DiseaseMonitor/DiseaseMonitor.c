@@ -7,499 +7,2111 @@
 ///////////////////////////////////////////////////////////////////
 
 #include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
 #include <string.h>
 #include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "DiseaseMonitor.h"
 #include "ADTList.h"
 #include "ADTMap.h"
 #include "ADTSet.h"
 #include "ADTPriorityQueue.h"
+#include "ADTVector.h"
+#include "AdtStats.h"
+#include "AdtHash.h"
 
-// Struct που αποθηκεύει μια ασθένεια και το πλήθος κρουσμάτων αυτής.
+#define ADT_MODULE ADT_DISEASE_MONITOR
+#include "AdtAlloc.h"			// Τελευταίο include, μετρητές δεσμεύσεων (ADT_ALLOC_STATS)
 
-typedef struct dis_cases* DisCases;
+// Μετρητής εγγραφών ανά ημέρα.
+//
+// Είναι ένα Fenwick tree πάνω σε πίνακα που έχει μία θέση για κάθε ημέρα από την first_day
+// μέχρι την first_day + capacity - 1, οπότε το πλήθος εγγραφών σε οποιοδήποτε εύρος ημερών
+// βρίσκεται με O(logD) πράξεις ακεραίων, χωρίς συγκρίσεις strings. Ο πίνακας μεγαλώνει
+// (με διπλασιασμό) όταν εμφανιστεί ημέρα εκτός ορίων.
+
+typedef struct day_counter* DayCounter;
+
+struct day_counter {
+	int first_day;		// Η ημέρα που αντιστοιχεί στη θέση 0
+	int capacity;		// Πλήθος ημερών που καλύπτονται
+	int* counts;		// Πλήθος εγγραφών για κάθε ημέρα
+	int* tree;			// Το Fenwick tree (1-based) πάνω στον counts
+};
+
+// Για να μην δεσμεύεται υπερβολική μνήμη όταν οι ημερομηνίες ενός συνόλου εγγραφών απέχουν
+// πολύ μεταξύ τους, ο μετρητής εγκαταλείπεται αν χρειάζεται να καλύψει περισσότερες ημέρες
+// από τις παρακάτω (~180 χρόνια). Τότε οι μετρήσεις γίνονται μέσω του αντίστοιχου set.
+#define MAX_COUNTER_DAYS (1 << 16)
+#define MIN_COUNTER_DAYS 32
+
+// Μετατρέπει μια ημερομηνία YYYY-MM-DD στον αριθμό ημερών από την 1970-01-01 (αρνητικός για
+// προγενέστερες). Η διάταξη των αριθμών είναι ίδια με τη διάταξη των strings.
+
+static int date_to_day(Date date) {
+	int year = (date[0] - '0') * 1000 + (date[1] - '0') * 100 + (date[2] - '0') * 10 + (date[3] - '0');
+	int month = (date[5] - '0') * 10 + (date[6] - '0');
+	int day = (date[8] - '0') * 10 + (date[9] - '0');
+
+	// Μετράμε τα έτη από τον Μάρτιο, ώστε η 29η Φεβρουαρίου να είναι η τελευταία ημέρα του έτους
+	year -= month <= 2;
+	int era = (year >= 0 ? year : year - 399) / 400;					// Κύκλοι των 400 ετών (146097 ημέρες)
+	int year_of_era = year - era * 400;									// [0, 399]
+	int day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;	// [0, 365]
+	int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+	return era * 146097 + day_of_era - 719468;
+}
+
+// Επιστρέφει true αν η date είναι υπαρκτή ημερομηνία σε μορφή YYYY-MM-DD. Μόνο για τέτοιες
+// ημερομηνίες η date_to_day διατηρεί τη διάταξη των strings (πχ η "2000-02-99" είναι πριν από
+// την "2000-03-01" ως string, αλλά μετά ως ημέρα), οπότε μόνο αυτές μπαίνουν στους μετρητές.
+
+static bool date_valid(Date date) {
+	for (int i = 0; i < 10; i++) {
+		if (i == 4 || i == 7 ? date[i] != '-' : date[i] < '0' || date[i] > '9')
+			return false;
+	}
+	if (date[10] != '\0')
+		return false;
+
+	int year = (date[0] - '0') * 1000 + (date[1] - '0') * 100 + (date[2] - '0') * 10 + (date[3] - '0');
+	int month = (date[5] - '0') * 10 + (date[6] - '0');
+	int day = (date[8] - '0') * 10 + (date[9] - '0');
+
+	static const int month_days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	if (month < 1 || month > 12 || day < 1)
+		return false;
+	bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+	return day <= month_days[month - 1] + (month == 2 && leap);
+}
+
+// Η ημέρα μιας εγγραφής με μη έγκυρη ημερομηνία, που δεν μπορεί να μπει σε μετρητή
+
+#define INVALID_DAY INT_MIN
+
+static int record_day(Record record) {
+	return date_valid(record->date) ? date_to_day(record->date) : INVALID_DAY;
+}
+
+// Ξαναχτίζει το Fenwick tree από τον πίνακα counts σε O(D)
+
+static void counter_build_tree(DayCounter counter) {
+	for (int i = 1; i <= counter->capacity; i++)
+		counter->tree[i] = counter->counts[i - 1];
+	for (int i = 1; i <= counter->capacity; i++) {
+		int parent = i + (i & -i);
+		if (parent <= counter->capacity)
+			counter->tree[parent] += counter->tree[i];
+	}
+}
+
+static DayCounter counter_create(int day) {
+	DayCounter counter = malloc(sizeof(*counter));
+	counter->first_day = day;
+	counter->capacity = MIN_COUNTER_DAYS;
+	counter->counts = calloc(counter->capacity, sizeof(int));
+	counter->tree = calloc(counter->capacity + 1, sizeof(int));
+	return counter;
+}
+
+static void counter_destroy(DayCounter counter) {
+	if (counter == NULL)
+		return;
+	free(counter->counts);
+	free(counter->tree);
+	free(counter);
+}
+
+// Μεγαλώνει τον counter ώστε να καλύπτει και την ημέρα day. Το επιπλέον κενό μπαίνει
+// από την πλευρά που μεγάλωσε ο counter. Επιστρέφει false αν ξεπερνιέται το MAX_COUNTER_DAYS.
+
+static bool counter_grow(DayCounter counter, int day) {
+	int last_day = counter->first_day + counter->capacity - 1;
+	int new_first = day < counter->first_day ? day : counter->first_day;
+	int new_last = day > last_day ? day : last_day;
+	if (new_last - new_first + 1 > MAX_COUNTER_DAYS)
+		return false;
+
+	int new_capacity = 2 * counter->capacity;
+	if (new_capacity < new_last - new_first + 1)
+		new_capacity = new_last - new_first + 1;
+	if (new_capacity > MAX_COUNTER_DAYS)
+		new_capacity = MAX_COUNTER_DAYS;
+	if (day < counter->first_day)
+		new_first = new_last - new_capacity + 1;
+
+	// Μεταφέρουμε τις παλιές τιμές στις σωστές θέσεις του νέου πίνακα
+	int* new_counts = calloc(new_capacity, sizeof(int));
+	for (int i = 0; i < counter->capacity; i++)
+		new_counts[counter->first_day - new_first + i] = counter->counts[i];
+
+	free(counter->counts);
+	free(counter->tree);
+	counter->counts = new_counts;
+	counter->tree = malloc((new_capacity + 1) * sizeof(int));
+	counter->first_day = new_first;
+	counter->capacity = new_capacity;
+	counter_build_tree(counter);
+	return true;
+}
+
+// Προσθέτει delta στο πλήθος εγγραφών της ημέρας day. Επιστρέφει false αν ο counter
+// δεν μπορεί να καλύψει την ημέρα (οπότε πρέπει να εγκαταλειφθεί).
+
+static bool counter_add(DayCounter counter, int day, int delta) {
+	if ((day < counter->first_day || day >= counter->first_day + counter->capacity) && !counter_grow(counter, day))
+		return false;
+
+	int pos = day - counter->first_day;
+	counter->counts[pos] += delta;
+	for (int i = pos + 1; i <= counter->capacity; i += i & -i)
+		counter->tree[i] += delta;
+	return true;
+}
+
+// Επιστρέφει το πλήθος εγγραφών στις θέσεις 0 μέχρι και pos
+
+static int counter_prefix(DayCounter counter, int pos) {
+	int sum = 0;
+	for (int i = pos + 1; i > 0; i -= i & -i)
+		sum += counter->tree[i];
+	return sum;
+}
+
+// Επιστρέφει το πλήθος εγγραφών από την ημέρα from_day μέχρι και την to_day
+
+static int counter_count(DayCounter counter, int from_day, int to_day) {
+	// Περιορίζουμε το εύρος στις ημέρες που καλύπτει ο counter (έξω από αυτές δεν υπάρχουν εγγραφές)
+	int last_day = counter->first_day + counter->capacity - 1;
+	if (from_day < counter->first_day)
+		from_day = counter->first_day;
+	if (to_day > last_day)
+		to_day = last_day;
+	if (from_day > to_day)
+		return 0;
+
+	int before = from_day > counter->first_day ? counter_prefix(counter, from_day - counter->first_day - 1) : 0;
+	return counter_prefix(counter, to_day - counter->first_day) - before;
+}
+
+
+// Ένα index αποθηκεύει τις εγγραφές ενός υποσυνόλου (μιας χώρας, ασθένειας, ή και των δύο) σε set
+// κατατεταγμένες με την ημερομηνία τους, και τον μετρητή εγγραφών ανά ημέρα του υποσυνόλου αυτού
+// (NULL αν εγκαταλείφθηκε λόγω του MAX_COUNTER_DAYS).
+
+typedef struct index* Index;
+
+struct index {
+	Set set;
+	DayCounter days;
+};
+
+// Hash function που παίρνει υπ' όψιν το id ενός κρούσματος
+
+static uint hash_id(Pointer value) {
+	return ((Record) value)->id;
+}
+
+// Συνάρτηση σύγκρισης κρουσμάτων ως προς την ημερομηνία τους.
+// Ισοδύναμα θεωρούνται μόνο όσα έχουν ίδιο id, άρα αν δύο διαφορετικά
+// έχουν ίδια ημερομηνία κατατάσσονται σε αύξουσα σειρά id
+
+static int compare_record_dates(Pointer a, Pointer b) {
+	int result = strcmp(((Record) a)->date, ((Record) b)->date);
+	if (result) {
+		return result;
+	}
+	return ((Record) a)->id - ((Record) b)->id;
+}
+
+// Συνάρτηση σύγκρισης κρουσμάτων ως προς το id τους.
+// Μας ενδιαφέρει ουσιαστικά μόνο η περίπτωση της ισοδυναμίας.
+
+static int compare_ids(Pointer a, Pointer b) {
+	return ((Record) a)->id - ((Record) b)->id;
+}
+
+// Σύγκριση ενός κρούσματος με ένα id (int*), για αναζήτηση με map_find_with χωρίς
+// προσωρινό record. Το hash ενός id είναι το ίδιο το id, όπως στην hash_id.
+
+static int compare_record_id(Pointer record, Pointer id) {
+	return ((Record) record)->id != *(int*) id;
+}
+
+// Συνάρτηση σύγκρισης DiseaseCases ως προς τον αριθμό των κρουσματάτων τους.
+
+int dm_compare_cases(Pointer a, Pointer b) {
+	return ((DisCases) a)->cases - ((DisCases) b)->cases;
+}
+
+// Δημιουργεί DisCases για την ασθένεια, με 0 κρούσματα
+
+static DisCases cases_create(String disease) {
+	DisCases count = malloc(sizeof(*count));
+	count->disease = disease;
+	count->cases = 0;
+	return count;
+}
+
+// Προσθέτει delta στα κρούσματα του κόμβου node της pqueue
+
+static void cases_add(PriorityQueue pqueue, PriorityQueueNode node, int delta) {
+	((DisCases) pqueue_node_value(pqueue, node))->cases += delta;
+	pqueue_update_order(pqueue, node);
+}
+
+// Συναρτήσεις χειρισμού των indexes
+
+static Index index_create() {
+	Index index = malloc(sizeof(*index));
+	index->set = set_create(compare_record_dates, NULL);
+	index->days = NULL;
+	return index;
+}
+
+static void index_destroy(Index index) {
+	set_destroy(index->set);
+	counter_destroy(index->days);
+	free(index);
+}
+
+static void index_insert(Index index, Record record, int day) {
+	set_insert(index->set, record);
+
+	// Ο counter δημιουργείται με την πρώτη εγγραφή, και εγκαταλείπεται αν οι ημερομηνίες απέχουν πολύ
+	// ή αν μπει εγγραφή με μη έγκυρη ημερομηνία (μέχρι να αδειάσει ξανά το index).
+	// Το total_index δεν καταστρέφεται όταν αδειάσει, οπότε μπορεί να υπάρχει ήδη (κενός) counter.
+	if (set_size(index->set) == 1) {
+		counter_destroy(index->days);
+		index->days = (day != INVALID_DAY) ? counter_create(day) : NULL;
+	}
+	if (index->days != NULL && (day == INVALID_DAY || !counter_add(index->days, day, 1))) {
+		counter_destroy(index->days);
+		index->days = NULL;
+	}
+}
+
+static void index_remove(Index index, Record record, int day) {
+	set_remove(index->set, record);
+	if (index->days != NULL) {
+		counter_add(index->days, day, -1);
+	}
+}
+
+// Επιστρέφει index με snapshot του set. Ο μετρητής ανά ημέρα δεν αντιγράφεται (θα κόστιζε
+// O(D) για κάθε index), οπότε οι μετρήσεις του snapshot γίνονται μέσω του set.
+
+static Index index_snapshot(Index index) {
+	Index snapshot = malloc(sizeof(*snapshot));
+	snapshot->set = set_snapshot(index->set);
+	snapshot->days = NULL;
+	return snapshot;
+}
+
+// Γεμίζει το κενό index με τις n εγγραφές του records, ταξινομημένες ως προς compare_record_dates,
+// σε O(n + D) αντί για O(nlogn) με διαδοχικές index_insert
+
+static void index_fill_sorted(Index index, Record records[], int n) {
+	set_destroy(index->set);
+	counter_destroy(index->days);
+	index->set = set_create_from_sorted(compare_record_dates, NULL, (Pointer*) records, n);
+	index->days = NULL;
+
+	// Ο counter καλύπτει από την πρώτη μέχρι την τελευταία ημέρα (αν χωράει στο MAX_COUNTER_DAYS).
+	// Τα όρια βρίσκονται από όλες τις εγγραφές και όχι από την πρώτη και την τελευταία, ώστε να μην
+	// εξαρτώνται από τη διάταξη των strings, και με μη έγκυρη ημερομηνία δεν δημιουργείται counter.
+	if (n == 0) {
+		return;
+	}
+	int* days = malloc(n * sizeof(int));
+	int first_day = INT_MAX, last_day = INT_MIN;
+	for (int i = 0; i < n; i++) {
+		days[i] = record_day(records[i]);
+		if (days[i] == INVALID_DAY) {
+			free(days);
+			return;
+		}
+		first_day = days[i] < first_day ? days[i] : first_day;
+		last_day = days[i] > last_day ? days[i] : last_day;
+	}
+	if (last_day - first_day + 1 > MAX_COUNTER_DAYS) {
+		free(days);
+		return;
+	}
+
+	index->days = counter_create(first_day);
+	if (last_day >= first_day + index->days->capacity) {
+		counter_grow(index->days, last_day);
+	}
+	for (int i = 0; i < n; i++) {
+		index->days->counts[days[i] - index->days->first_day]++;
+	}
+	counter_build_tree(index->days);
+	free(days);
+}
+
+
+// Οι εγγραφές μιας χώρας: το index τους, και pqueue από DisCases με τις ασθένειες της χώρας
+// κατατεταγμένες σύμφωνα με τον αριθμό των κρουσμάτων τους.
+
+typedef struct country_entry* CountryEntry;
+
+struct country_entry {
+	String country;
+	Index index;
+	PriorityQueue diseases;
+};
+
+// Οι εγγραφές μιας ασθένειας: το index τους, και ο κόμβος της ασθένειας στην total_pq
+
+typedef struct disease_entry* DiseaseEntry;
+
+struct disease_entry {
+	String disease;
+	Index index;
+	PriorityQueueNode node;
+};
+
+// Οι εγγραφές ενός συνδυασμού χώρας και ασθένειας: το index τους, ο κόμβος της ασθένειας στην
+// pqueue της χώρας, και τα entries της χώρας και της ασθένειας. Ετσι μια αλλαγή βρίσκει με ένα
+// lookup όλες τις δομές που πρέπει να ενημερώσει.
+
+typedef struct pair_entry* PairEntry;
+
+struct pair_entry {
+	String country, disease;		// Τα ίδια (interned) strings με του country_entry και του disease_entry
+	Index index;
+	PriorityQueueNode node;
+	CountryEntry country_entry;
+	DiseaseEntry disease_entry;
+};
+
+// Hash function και συνάρτηση σύγκρισης των pair entries ως προς τη χώρα και την ασθένεια. Τα strings
+// είναι συχνά τα ίδια interned strings, οπότε πριν τη strcmp ελέγχεται η ισότητα των pointers.
+//
+// Οι αναζητήσεις γίνονται με ένα PairKey (μόνο τα δύο strings και τα hashes τους) μέσω των
+// map_*_with, οπότε τα hashes των strings υπολογίζονται μία φορά και χρησιμοποιούνται και για
+// το country_map και το dis_map.
+
+typedef struct pair_key {
+	String country, disease;
+	uint country_hash, disease_hash, hash;
+} PairKey;
+
+static PairKey pair_key(String country, String disease) {
+	PairKey key = { .country = country, .disease = disease };
+	key.country_hash = hash_string(country);
+	key.disease_hash = hash_string(disease);
+	key.hash = adt_hash_combine(key.country_hash, key.disease_hash);
+	return key;
+}
+
+static uint hash_pair(Pointer value) {
+	return adt_hash_combine(hash_string(((PairEntry) value)->country), hash_string(((PairEntry) value)->disease));
+}
+
+static int compare_strings(String a, String b) {
+	return (a == b) ? 0 : strcmp(a, b);
+}
+
+static int compare_pairs(Pointer a, Pointer b) {
+	int result = compare_strings(((PairEntry) a)->country, ((PairEntry) b)->country);
+	if (result) {
+		return result;
+	}
+	return compare_strings(((PairEntry) a)->disease, ((PairEntry) b)->disease);
+}
+
+static int compare_pair_key(Pointer entry, Pointer key) {
+	return compare_strings(((PairEntry) entry)->country, ((PairKey*) key)->country) ||
+		compare_strings(((PairEntry) entry)->disease, ((PairKey*) key)->disease);
+}
+
+static void country_entry_destroy(CountryEntry entry) {
+	index_destroy(entry->index);
+	pqueue_destroy(entry->diseases);
+	free(entry);
+}
+
+static void disease_entry_destroy(DiseaseEntry entry) {
+	index_destroy(entry->index);
+	free(entry);
+}
+
+static void pair_entry_destroy(PairEntry entry) {
+	index_destroy(entry->index);
+	free(entry);
+}
+
+
+// Οι εγγραφές σε στήλες, για φίλτρα που δεν αντιστοιχούν στα indexes (monitor_count_where).
+//
+// Η θέση i κάθε πίνακα αφορά την εγγραφή records[i]. Οι χώρες και οι ασθένειες αποθηκεύονται
+// ως ακέραια ids (από το names), και οι ημερομηνίες ως ημέρες, οπότε ένα φίλτρο είναι ένα σειριακό
+// πέρασμα με συγκρίσεις ακεραίων. Η αφαίρεση μεταφέρει την τελευταία εγγραφή στη θέση της
+// αφαιρεμένης, και το rows δίνει τη θέση κάθε εγγραφής.
+
+typedef struct columns* Columns;
+
+struct columns {
+	int size, capacity;
+	Record* records;
+	int32_t* countries;
+	int32_t* diseases;
+	int32_t* days;
+	Map rows;				// Εγγραφή (key ως προς το id) => θέση + 1
+	Map names;				// Χώρα ή ασθένεια => id + 1 (τα ids δεν επαναχρησιμοποιούνται)
+};
+
+static Columns columns_create() {
+	Columns columns = malloc(sizeof(*columns));
+	columns->size = 0;
+	columns->capacity = 64;
+	columns->records = malloc(columns->capacity * sizeof(Record));
+	columns->countries = malloc(columns->capacity * sizeof(int32_t));
+	columns->diseases = malloc(columns->capacity * sizeof(int32_t));
+	columns->days = malloc(columns->capacity * sizeof(int32_t));
+
+	columns->rows = map_create(compare_ids, NULL, NULL);
+	map_set_hash_function(columns->rows, hash_id);
+	columns->names = map_create((CompareFunc) strcmp, NULL, NULL);
+	map_set_hash_function(columns->names, hash_string);
+	return columns;
+}
+
+static void columns_destroy(Columns columns) {
+	if (columns == NULL) {
+		return;
+	}
+	free(columns->records);
+	free(columns->countries);
+	free(columns->diseases);
+	free(columns->days);
+	map_destroy(columns->rows);
+	map_destroy(columns->names);
+	free(columns);
+}
+
+// Επιστρέφει το id του string, ή -1 αν δεν υπάρχει (τα ids ξεκινούν από 0)
+
+static int32_t columns_name_id(Columns columns, String name) {
+	return (int32_t) (intptr_t) map_find(columns->names, name) - 1;
+}
+
+// Το name πρέπει να μένει έγκυρο όσο υπάρχει το columns (πχ interned string)
+
+static int32_t columns_add_name(Columns columns, String name) {
+	bool inserted;
+	MapNode node = map_find_or_insert(columns->names, name, NULL, &inserted);
+	if (inserted) {
+		map_node_set_value(columns->names, node, (Pointer) (intptr_t) map_size(columns->names));
+	}
+	return (int32_t) (intptr_t) map_node_value(columns->names, node) - 1;
+}
+
+static void columns_insert(Columns columns, Record record, String country, String disease, int day) {
+	if (columns->size == columns->capacity) {
+		columns->capacity *= 2;
+		columns->records = realloc(columns->records, columns->capacity * sizeof(Record));
+		columns->countries = realloc(columns->countries, columns->capacity * sizeof(int32_t));
+		columns->diseases = realloc(columns->diseases, columns->capacity * sizeof(int32_t));
+		columns->days = realloc(columns->days, columns->capacity * sizeof(int32_t));
+	}
+
+	int row = columns->size++;
+	columns->records[row] = record;
+	columns->countries[row] = columns_add_name(columns, country);
+	columns->diseases[row] = columns_add_name(columns, disease);
+	columns->days[row] = day;
+	map_insert(columns->rows, record, (Pointer) (intptr_t) (row + 1));
+}
+
+static void columns_remove(Columns columns, Record record) {
+	int row = (intptr_t) map_find(columns->rows, record) - 1;
+	map_remove(columns->rows, record);
+
+	// Η τελευταία εγγραφή μεταφέρεται στη θέση της αφαιρεμένης
+	int last = --columns->size;
+	if (row != last) {
+		columns->records[row] = columns->records[last];
+		columns->countries[row] = columns->countries[last];
+		columns->diseases[row] = columns->diseases[last];
+		columns->days[row] = columns->days[last];
+		map_insert(columns->rows, columns->records[row], (Pointer) (intptr_t) (row + 1));
+	}
+}
+
+// Επιστρέφει αν η τιμή value είναι μία από τις n τιμές του values (αληθές για n == 0)
+
+static bool value_in(int32_t value, int32_t values[], int n) {
+	if (n == 0) {
+		return true;
+	}
+	for (int i = 0; i < n; i++) {
+		if (values[i] == value) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Μετράει τις εγγραφές με χώρα μία από τις countries (οποιαδήποτε αν country_no == 0), ασθένεια
+// μία από τις diseases, και ημέρα από from μέχρι to. Με SSE2 ελέγχονται 4 εγγραφές τη φορά:
+// κάθε σύγκριση δίνει μάσκα 4 θέσεων, και οι θέσεις που ικανοποιούν όλα τα κριτήρια μετρώνται
+// με popcount της movemask.
+
+static int columns_count(Columns columns, int32_t countries[], int country_no, int32_t diseases[], int disease_no, int32_t from, int32_t to) {
+	int count = 0;
+	int i = 0;
+
+#ifdef __SSE2__
+	__m128i all = _mm_set1_epi32(-1);
+	__m128i from_v = _mm_set1_epi32(from);
+	__m128i to_v = _mm_set1_epi32(to);
+
+	for (; i + 4 <= columns->size; i += 4) {
+		__m128i days = _mm_loadu_si128((__m128i*) &columns->days[i]);
+		__m128i mask = _mm_andnot_si128(_mm_or_si128(_mm_cmplt_epi32(days, from_v), _mm_cmpgt_epi32(days, to_v)), all);
+
+		if (country_no > 0) {
+			__m128i values = _mm_loadu_si128((__m128i*) &columns->countries[i]);
+			__m128i match = _mm_setzero_si128();
+			for (int j = 0; j < country_no; j++) {
+				match = _mm_or_si128(match, _mm_cmpeq_epi32(values, _mm_set1_epi32(countries[j])));
+			}
+			mask = _mm_and_si128(mask, match);
+		}
+		if (disease_no > 0) {
+			__m128i values = _mm_loadu_si128((__m128i*) &columns->diseases[i]);
+			__m128i match = _mm_setzero_si128();
+			for (int j = 0; j < disease_no; j++) {
+				match = _mm_or_si128(match, _mm_cmpeq_epi32(values, _mm_set1_epi32(diseases[j])));
+			}
+			mask = _mm_and_si128(mask, match);
+		}
+
+		count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+	}
+#endif
+
+	// Οι υπόλοιπες εγγραφές (όλες, χωρίς SSE2)
+	for (; i < columns->size; i++) {
+		count += columns->days[i] >= from && columns->days[i] <= to &&
+			value_in(columns->countries[i], countries, country_no) &&
+			value_in(columns->diseases[i], diseases, disease_no);
+	}
+	return count;
+}
+
+
+// Κάθε DiseaseMonitor περιέχει τις παρακάτω δομές.
+//
+// Ο id_map οδηγεί από ένα record με ένα συγκεκριμένο id στο record με το ίδιο id που είναι αποθηκευμένο στο disease monitor.
+// Ο pair_map οδηγεί από μια χώρα και ασθένεια (key ένα PairEntry) στο PairEntry τους, και μέσα από αυτό στο CountryEntry
+// και στο DiseaseEntry, οπότε μια προσθήκη ή αφαίρεση κάνει μόνο 2 lookups (id_map και pair_map).
+// Οι country_map, dis_map οδηγούν από μια χώρα/ασθένεια (key το string) στο CountryEntry/DiseaseEntry της, για τα queries
+// που αφορούν μόνο χώρα ή μόνο ασθένεια, και για τη δημιουργία νέων PairEntry.
+// Το total_index περιέχει όλα τα records.
+// Η total_pq είναι μια pqueue που περιέχει όλες τις ασθένειες κατατεταγμένες σύμφωνα με τον αριθμό των κρουσμάτων τους,
+// ανεξάρτητα από την χώρα.
+//
+// Τα entries δημιουργούνται με την πρώτη εγγραφή τους και καταστρέφονται όταν μείνουν κενά. Τα strings τους γίνονται
+// intern στο monitor (και δεν γίνονται free μέχρι το dm_free), ώστε να μην εξαρτώνται από τις εγγραφές του χρήστη.
+
+struct disease_monitor {
+	Map id_map, pair_map, country_map, dis_map;
+	Index total_index;
+	PriorityQueue total_pq;
+	Columns columns;			// Οι εγγραφές σε στήλες (NULL μέχρι την πρώτη monitor_count_where)
+	List owned;					// Μνήμη που ανήκει στο monitor (πχ οι εγγραφές της monitor_load), free στο dm_free
+	Map strings;				// Interned strings: χώρες/ασθένειες των entries, και τα strings των αντιγράφων αν owning
+	char* arena;				// Ο ελεύθερος χώρος του τρέχοντος block για τα interned strings και τα αντίγραφα
+	size_t arena_left;
+	bool owning;				// true αν το monitor κρατάει αντίγραφα των εγγραφών (dm_create_owning)
+	bool concurrent;			// true αν το monitor δημιουργήθηκε με dm_create_concurrent
+	pthread_rwlock_t lock;		// Read lock για τα queries, write lock για τις αλλαγές (μόνο αν concurrent)
+};
+
+// Το monitor που χρησιμοποιείται από τις συναρτήσεις dm_* (NULL πριν την dm_init)
+
+static DiseaseMonitor default_monitor = NULL;
+
+// Ιστογράμματα του χρόνου κάθε κλήσης dm_* (μόνο με ADT_STATS, βλ. dm_stats_dump)
+
+typedef enum {
+	DM_OP_INIT,
+	DM_OP_DESTROY,
+	DM_OP_INSERT_RECORD,
+	DM_OP_REMOVE_RECORD,
+	DM_OP_GET_RECORDS,
+	DM_OP_RECORDS_CURSOR,
+	DM_OP_COUNT_RECORDS,
+	DM_OP_TOP_DISEASES,
+	DM_OP_TOP_DISEASES_RANGE,
+	DM_OP_PERCENTILE_DATE,
+	DM_OP_COUNT_WHERE,
+	DM_OP_SNAPSHOT,
+	DM_OP_SAVE,
+	DM_OP_LOAD,
+	DM_OP_INGEST_CSV,
+	DM_OP_NO
+} DmOp;
+
+static String dm_op_names[DM_OP_NO] = {
+	"init", "destroy", "insert_record", "remove_record", "get_records", "records_cursor",
+	"count_records", "top_diseases", "top_diseases_range", "percentile_date", "count_where",
+	"snapshot", "save", "load", "ingest_csv",
+};
+
+static AdtHistogram dm_stats[DM_OP_NO];
+
+// Δημιουργεί ένα νέο, κενό monitor
+
+DiseaseMonitor dm_create() {
+	DiseaseMonitor monitor = malloc(sizeof(*monitor));
+
+	monitor->id_map = map_create(compare_ids, NULL, NULL);
+	map_set_hash_function(monitor->id_map, hash_id);
+
+	monitor->pair_map = map_create(compare_pairs, NULL, (DestroyFunc) pair_entry_destroy);
+	map_set_hash_function(monitor->pair_map, hash_pair);
+
+	monitor->country_map = map_create((CompareFunc) strcmp, NULL, (DestroyFunc) country_entry_destroy);
+	map_set_hash_function(monitor->country_map, hash_string);
+
+	monitor->dis_map = map_create((CompareFunc) strcmp, NULL, (DestroyFunc) disease_entry_destroy);
+	map_set_hash_function(monitor->dis_map, hash_string);
+
+	monitor->total_index = index_create();
+
+	monitor->total_pq = pqueue_create(dm_compare_cases, free, NULL);
+
+	monitor->columns = NULL;
+	monitor->owned = list_create(free);
+	monitor->strings = map_create((CompareFunc) strcmp, NULL, NULL);
+	map_set_hash_function(monitor->strings, hash_string);
+	monitor->arena = NULL;
+	monitor->arena_left = 0;
+	monitor->owning = false;
+	monitor->concurrent = false;
+
+	return monitor;
+}
+
+// Δημιουργεί ένα νέο, κενό monitor που αποθηκεύει αντίγραφα των εγγραφών
+
+DiseaseMonitor dm_create_owning() {
+	DiseaseMonitor monitor = dm_create();
+	monitor->owning = true;
+	return monitor;
+}
+
+// Δημιουργεί ένα νέο, κενό monitor που μπορεί να χρησιμοποιείται ταυτόχρονα από πολλά threads
+
+DiseaseMonitor dm_create_concurrent() {
+	DiseaseMonitor monitor = dm_create();
+	monitor->concurrent = true;
+
+	// Με τη συνεχή ροή queries ένα rwlock που προτιμά τους readers (default της glibc) δεν θα
+	// έδινε ποτέ το lock στις αλλαγές, οπότε ζητάμε προτεραιότητα στους writers.
+	pthread_rwlockattr_t attr;
+	pthread_rwlockattr_init(&attr);
+#ifdef __GLIBC__
+	pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+	pthread_rwlock_init(&monitor->lock, &attr);
+	pthread_rwlockattr_destroy(&attr);
+
+	return monitor;
+}
+
+// Τα queries παίρνουν το read lock (οπότε εκτελούνται παράλληλα μεταξύ τους) και οι
+// αλλαγές το write lock. Σε monitor που δεν είναι concurrent δεν γίνεται τίποτα.
+// Το read lock δεν είναι recursive: όσο το κρατάει ένα thread δεν καλεί άλλα queries.
+
+void monitor_read_lock(DiseaseMonitor monitor) {
+	if (monitor->concurrent)
+		pthread_rwlock_rdlock(&monitor->lock);
+}
+
+void monitor_read_unlock(DiseaseMonitor monitor) {
+	if (monitor->concurrent)
+		pthread_rwlock_unlock(&monitor->lock);
+}
+
+static void write_lock(DiseaseMonitor monitor) {
+	if (monitor->concurrent)
+		pthread_rwlock_wrlock(&monitor->lock);
+}
+
+static void write_unlock(DiseaseMonitor monitor) {
+	if (monitor->concurrent)
+		pthread_rwlock_unlock(&monitor->lock);
+}
+
+// Καταστρέφει όλες τις δομές του monitor, απελευθερώνοντας την αντίστοιχη
+// μνήμη. ΔΕΝ κάνει free τα records, αυτά δημιουργούνται και καταστρέφονται από
+// τον χρήστη.
+
+void dm_free(DiseaseMonitor monitor) {
+	// Τα pair entries πρώτα, αφού δείχνουν στα entries των χωρών/ασθενειών
+	map_destroy(monitor->pair_map);
+	map_destroy(monitor->country_map);
+	map_destroy(monitor->dis_map);
+	map_destroy(monitor->id_map);
+	index_destroy(monitor->total_index);
+	pqueue_destroy(monitor->total_pq);
+	columns_destroy(monitor->columns);
+	list_destroy(monitor->owned);
+	map_destroy(monitor->strings);
+	if (monitor->concurrent)
+		pthread_rwlock_destroy(&monitor->lock);
+	free(monitor);
+}
+
+
+// Τα interned strings και τα αντίγραφα των εγγραφών ενός owning monitor δεσμεύονται από blocks
+// των ARENA_BLOCK bytes, που προστίθενται στο monitor->owned και γίνονται free όλα μαζί στο dm_free.
+
+#define ARENA_BLOCK (64 * 1024)
+
+// Δεσμεύει size bytes από το arena του monitor, με alignment κατάλληλο για struct record
+
+static Pointer arena_alloc(DiseaseMonitor monitor, size_t size) {
+	size_t align = _Alignof(struct record);
+	size = (size + align - 1) & ~(align - 1);
+
+	if (size > monitor->arena_left) {
+		// Οι μεγάλες δεσμεύσεις παίρνουν δικό τους block, ώστε να μη χαθεί ο χώρος του τρέχοντος
+		if (size > ARENA_BLOCK / 4) {
+			Pointer block = malloc(size);
+			list_insert_next(monitor->owned, LIST_BOF, block);
+			return block;
+		}
+		monitor->arena = malloc(ARENA_BLOCK);
+		monitor->arena_left = ARENA_BLOCK;
+		list_insert_next(monitor->owned, LIST_BOF, monitor->arena);
+	}
+
+	Pointer result = monitor->arena;
+	monitor->arena += size;
+	monitor->arena_left -= size;
+	return result;
+}
+
+// Επιστρέφει το μοναδικό αντίγραφο του string στο arena, δημιουργώντας το αν δεν υπάρχει
+
+static String intern_string(DiseaseMonitor monitor, String string) {
+	uint hash = hash_string(string);
+	String interned = map_find_with(monitor->strings, hash, string, (CompareFunc) strcmp);
+	if (interned == NULL) {
+		size_t size = strlen(string) + 1;
+		interned = memcpy(arena_alloc(monitor, size), string, size);
+		map_insert_with(monitor->strings, hash, interned, interned);
+	}
+	return interned;
+}
+
+// Αντιγράφει την εγγραφή στο arena. Το name (συνήθως διαφορετικό σε κάθε εγγραφή) μπαίνει
+// αμέσως μετά το struct, ενώ τα υπόλοιπα strings επαναλαμβάνονται και γίνονται intern.
+
+static Record copy_record(DiseaseMonitor monitor, Record record) {
+	size_t name_size = strlen(record->name) + 1;
+	Record copy = arena_alloc(monitor, sizeof(*copy) + name_size);
+
+	copy->id = record->id;
+	copy->name = memcpy((char*) (copy + 1), record->name, name_size);
+	copy->disease = intern_string(monitor, record->disease);
+	copy->country = intern_string(monitor, record->country);
+	copy->date = intern_string(monitor, record->date);
+	return copy;
+}
+
+// Επιστρέφει το PairEntry της χώρας και της ασθένειας του record. Αν δεν υπάρχει δημιουργείται,
+// μαζί με το CountryEntry και το DiseaseEntry αν δεν υπάρχουν κι αυτά.
+
+static PairEntry find_pair(DiseaseMonitor monitor, Record record) {
+	PairKey key = pair_key(record->country, record->disease);
+	PairEntry pair = map_find_with(monitor->pair_map, key.hash, &key, compare_pair_key);
+	if (pair != NULL) {
+		return pair;
+	}
+
+	// Οι αναζητήσεις και προσθήκες στα country_map / dis_map χρησιμοποιούν τα hashes του key
+	CountryEntry country = map_find_with(monitor->country_map, key.country_hash, record->country, (CompareFunc) strcmp);
+	if (country == NULL) {
+		country = malloc(sizeof(*country));
+		country->country = intern_string(monitor, record->country);
+		country->index = index_create();
+		country->diseases = pqueue_create(dm_compare_cases, free, NULL);
+		map_insert_with(monitor->country_map, key.country_hash, country->country, country);
+	}
+
+	DiseaseEntry disease = map_find_with(monitor->dis_map, key.disease_hash, record->disease, (CompareFunc) strcmp);
+	if (disease == NULL) {
+		disease = malloc(sizeof(*disease));
+		disease->disease = intern_string(monitor, record->disease);
+		disease->index = index_create();
+		disease->node = pqueue_insert(monitor->total_pq, cases_create(disease->disease));
+		map_insert_with(monitor->dis_map, key.disease_hash, disease->disease, disease);
+	}
+
+	pair = malloc(sizeof(*pair));
+	pair->country = country->country;
+	pair->disease = disease->disease;
+	pair->index = index_create();
+	pair->node = pqueue_insert(country->diseases, cases_create(disease->disease));
+	pair->country_entry = country;
+	pair->disease_entry = disease;
+	map_insert_with(monitor->pair_map, key.hash, pair, pair);
+
+	return pair;
+}
+
+static bool remove_record(DiseaseMonitor monitor, int id);
+
+// Προσθέτει την εγγραφή record στο monitor. Δεν δεσμεύει νέα μνήμη (ούτε
+// φτιάχνει αντίγραφα του record), απλά αποθηκεύει τον pointer (η δέσμευση
+// μνήμης για τα records είναι ευθύνη του χρήστη). Αν υπάρχει εγγραφή με το ίδιο
+// id αντικαθίσταται και επιστρέφεται true, αν όχι επιστρέφεται false.
+//
+// Οι αλλαγές στα δεδομένα της εγγραφής απαγορεύονται μέχρι να γίνει remove από
+// τον monitor. Ενα owning monitor αντίθετα αποθηκεύει αντίγραφο (copy_record).
+
+static bool insert_record(DiseaseMonitor monitor, Record record) {
+	if (monitor->owning) {
+		record = copy_record(monitor, record);
+	}
+
+	// Αν υπάρχει εγγραφή με αυτό το id την αφαιρούμε και σημειώνουμε πως υπήρχε
+	bool removed = remove_record(monitor, record->id);
+
+	// Προσθέτουμε το record στο id_map για να το βρίσκουμε μετά από το id του
+	map_insert(monitor->id_map, record, record);
+
+	// Το προσθέτουμε στο συνολικό index, και στα indexes της χώρας, της ασθένειας και του
+	// συνδυασμού τους (που δημιουργούνται αν δεν υπάρχουν)
+	int day = record_day(record);
+	PairEntry pair = find_pair(monitor, record);
+	index_insert(monitor->total_index, record, day);
+	index_insert(pair->index, record, day);
+	index_insert(pair->country_entry->index, record, day);
+	index_insert(pair->disease_entry->index, record, day);
+
+	// Ενημερώνουμε τα κρούσματα της ασθένειας στην pqueue της χώρας και στη συνολική pqueue
+	cases_add(pair->country_entry->diseases, pair->node, 1);
+	cases_add(monitor->total_pq, pair->disease_entry->node, 1);
+
+	if (monitor->columns != NULL) {
+		columns_insert(monitor->columns, record, pair->country, pair->disease, day);
+	}
+
+	// Επιστρέφουμε αν αφαιρέθηκε άλλη εγγραφή ή όχι
+	return removed;
+}
+
+// Αφαιρεί την εγγραφή με το συγκεκριμένο id από το σύστημα (χωρίς free, είναι
+// ευθύνη του χρήστη). Επιστρέφει true αν υπήρχε τέτοια εγγραφή, αλλιώς false.
+
+static bool remove_record(DiseaseMonitor monitor, int id) {
+	// Βρίσκουμε το record με αυτό το id
+	Record record = map_find_with(monitor->id_map, id, &id, compare_record_id);
+
+	// Αν δεν υπάρχει επιστρέφουμε false
+	if (record == NULL) {
+		return false;
+	}
+
+	// Αλλιώς το αφαιρούμε από το id_map
+	map_remove_with(monitor->id_map, id, &id, compare_record_id);
+
+	// Από όλα τα indexes
+	PairKey key = pair_key(record->country, record->disease);
+	PairEntry pair = map_find_with(monitor->pair_map, key.hash, &key, compare_pair_key);
+	CountryEntry country = pair->country_entry;
+	DiseaseEntry disease = pair->disease_entry;
+
+	int day = record_day(record);
+	index_remove(monitor->total_index, record, day);
+	index_remove(pair->index, record, day);
+	index_remove(country->index, record, day);
+	index_remove(disease->index, record, day);
+
+	if (monitor->columns != NULL) {
+		columns_remove(monitor->columns, record);
+	}
+
+	// Από τις pqueues
+	cases_add(country->diseases, pair->node, -1);
+	cases_add(monitor->total_pq, disease->node, -1);
+
+	// Τα entries που έμειναν κενά καταστρέφονται (πρώτα το pair, που δείχνει στα άλλα δύο)
+	if (set_size(pair->index->set) == 0) {
+		pqueue_remove_node(country->diseases, pair->node);
+		map_remove_with(monitor->pair_map, key.hash, &key, compare_pair_key);
+	}
+	if (set_size(country->index->set) == 0) {
+		map_remove_with(monitor->country_map, key.country_hash, country->country, (CompareFunc) strcmp);
+	}
+	if (set_size(disease->index->set) == 0) {
+		pqueue_remove_node(monitor->total_pq, disease->node);
+		map_remove_with(monitor->dis_map, key.disease_hash, disease->disease, (CompareFunc) strcmp);
+	}
+
+	// Το record αφαιρέθηκε επιτυχώς
+	return true;
+}
+
+bool monitor_insert_record(DiseaseMonitor monitor, Record record) {
+	write_lock(monitor);
+	bool removed = insert_record(monitor, record);
+	write_unlock(monitor);
+	return removed;
+}
+
+bool monitor_remove_record(DiseaseMonitor monitor, int id) {
+	write_lock(monitor);
+	bool removed = remove_record(monitor, id);
+	write_unlock(monitor);
+	return removed;
+}
+
+// Προσθέτει τις n εγγραφές του πίνακα records με μία απόκτηση του write lock, ώστε τα
+// queries να διακόπτονται μία φορά ανά ομάδα αλλαγών. Επιστρέφει πόσες εγγραφές αντικατέστησαν
+// υπάρχουσες (με το ίδιο id).
+
+int monitor_insert_records(DiseaseMonitor monitor, Record records[], int n) {
+	int replaced = 0;
+
+	write_lock(monitor);
+	for (int i = 0; i < n; i++) {
+		if (insert_record(monitor, records[i])) {
+			replaced++;
+		}
+	}
+	write_unlock(monitor);
+
+	return replaced;
+}
+
+// Επιστρέφει νέα pqueue με αντίγραφα των DisCases της pqueue, με τα strings των ασθενειών
+// interned στο monitor
+
+static PriorityQueue copy_cases_pqueue(DiseaseMonitor monitor, PriorityQueue pqueue) {
+	List cases = pqueue_top_k(pqueue, pqueue_size(pqueue));
+	Vector copies = vector_create(0, NULL);
+
+	for (ListNode node = list_first(cases); node != LIST_EOF; node = list_next(cases, node)) {
+		DisCases count = list_node_value(cases, node);
+		DisCases copy = cases_create(intern_string(monitor, count->disease));
+		copy->cases = count->cases;
+		vector_insert_last(copies, copy);
+	}
+
+	PriorityQueue copy = pqueue_create(dm_compare_cases, free, copies);
+	vector_destroy(copies);
+	list_destroy(cases);
+	return copy;
+}
+
+// Επιστρέφει ένα read-only αντίγραφο του monitor, που δεν επηρεάζεται από μεταγενέστερες αλλαγές.
+// Τα sets των εγγραφών δεν αντιγράφονται αλλά γίνονται set_snapshot, που με το UsingPersistentAVL
+// είναι O(1), οπότε το κόστος εξαρτάται μόνο από το πλήθος των χωρών/ασθενειών.
+
+DiseaseMonitor monitor_snapshot(DiseaseMonitor monitor) {
+	DiseaseMonitor snapshot = dm_create();
+
+	monitor_read_lock(monitor);
+
+	// Οι κόμβοι των pqueues (όπως και το id_map) χρησιμοποιούνται μόνο στις αλλαγές, οπότε στα
+	// entries του snapshot είναι NULL. Οι pqueues των χωρών χρειάζονται για τη monitor_top_diseases.
+	for (MapNode node = map_first(monitor->country_map); node != MAP_EOF; node = map_next(monitor->country_map, node)) {
+		CountryEntry entry = map_node_value(monitor->country_map, node);
+		CountryEntry copy = malloc(sizeof(*copy));
+		copy->country = intern_string(snapshot, entry->country);
+		copy->index = index_snapshot(entry->index);
+		copy->diseases = copy_cases_pqueue(snapshot, entry->diseases);
+		map_insert(snapshot->country_map, copy->country, copy);
+	}
+	for (MapNode node = map_first(monitor->dis_map); node != MAP_EOF; node = map_next(monitor->dis_map, node)) {
+		DiseaseEntry entry = map_node_value(monitor->dis_map, node);
+		DiseaseEntry copy = malloc(sizeof(*copy));
+		copy->disease = intern_string(snapshot, entry->disease);
+		copy->index = index_snapshot(entry->index);
+		copy->node = NULL;
+		map_insert(snapshot->dis_map, copy->disease, copy);
+	}
+	for (MapNode node = map_first(monitor->pair_map); node != MAP_EOF; node = map_next(monitor->pair_map, node)) {
+		PairEntry entry = map_node_value(monitor->pair_map, node);
+		PairEntry copy = malloc(sizeof(*copy));
+		copy->country_entry = map_find(snapshot->country_map, entry->country);
+		copy->disease_entry = map_find(snapshot->dis_map, entry->disease);
+		copy->country = copy->country_entry->country;
+		copy->disease = copy->disease_entry->disease;
+		copy->index = index_snapshot(entry->index);
+		copy->node = NULL;
+		map_insert(snapshot->pair_map, copy, copy);
+	}
+
+	index_destroy(snapshot->total_index);
+	snapshot->total_index = index_snapshot(monitor->total_index);
+
+	pqueue_destroy(snapshot->total_pq);
+	snapshot->total_pq = copy_cases_pqueue(snapshot, monitor->total_pq);
+
+	monitor_read_unlock(monitor);
+
+	return snapshot;
+}
+
+// Monitor queries
+//
+// Στις παρακάτω συναρτήσεις χρησιμοποιούνται τα παρακάτω κριτήρια αναζήτησης εγγραφών:
+//   disease:   Μόνο εγγραφές με τη συγκεκριμένη ασθένεια (όλες, αν NULL)
+//   country:   Μόνο εγγραφές με τη συγκεκριμένη χώρα (όλες, αν NULL)
+//   date_from: Μόνο εγγραφές με ημερομηνία date_from ή μεταγενέστερη (όλες, αν NULL)
+//   date_to:   Μόνο εγγραφές με ημερομηνία date_to ή προγενέστερη (όλες, αν NULL)
+//
+// Οποιοδήποτε από τα κριτήρια μπορεί να είναι NULL, το οποίο σημαίνει "όλες οι
+// εγγραφές" (χωρίς φίλτρο για το συγκεκριμένο πεδίο).
+//
+// Στις συναρτήσεις που επιστρέφουν λίστα, η λίστα δημιουργείται την ώρα της
+// κλήσης και είναι ευθύνη του χρήστη να καλέσει τη list_destroy (η οποία θα
+// ελευθερώσει μόνο τη λίστα, όχι τα δεδομένα).
+
+
+// Επιστρέφει το index με τις εγγραφές που έχουν τη συγκεκριμένη ασθένεια και χώρα
+// (οποιαδήποτε από τις δύο μπορεί να είναι NULL), ή NULL αν δεν υπάρχουν τέτοιες εγγραφές.
+
+static Index find_search_index(DiseaseMonitor monitor, String disease, String country) {
+	// Αν δεν υπάρχει κανένα κριτήριο ψάχνουμε σε όλες τις εγγραφές
+	if ((disease == NULL) && (country == NULL)) {
+		return monitor->total_index;
+	}
+
+	// Επιλέγουμε το map ανάλογα με το πόσες πληροφορίες έχουμε για την χώρα
+	// και μέσα από από αυτό βρίσκουμε το κατάλληλο entry
+	if (disease == NULL) {
+		CountryEntry entry = map_find(monitor->country_map, country);
+		return (entry != NULL) ? entry->index : NULL;
+	}
+	if (country == NULL) {
+		DiseaseEntry entry = map_find(monitor->dis_map, disease);
+		return (entry != NULL) ? entry->index : NULL;
+	}
+	PairKey key = pair_key(country, disease);
+	PairEntry entry = map_find_with(monitor->pair_map, key.hash, &key, compare_pair_key);
+	return (entry != NULL) ? entry->index : NULL;
+}
+
+// Επιστρέφει το πλήθος των εγγραφών του index με ημερομηνία από date_from μέχρι date_to
+
+static int index_count(Index index, Date date_from, Date date_to) {
+	// Χωρίς όρια ημερομηνιών μετράνε όλες οι εγγραφές του index
+	if (date_from == NULL && date_to == NULL) {
+		return set_size(index->set);
+	}
+
+	// Αν υπάρχει μετρητής ανά ημέρα (και τα όρια είναι έγκυρες ημερομηνίες, ώστε να έχουν την ίδια
+	// διάταξη με τα strings του set) το πλήθος βρίσκεται μόνο με πράξεις ακεραίων
+	if (index->days != NULL && (date_from == NULL || date_valid(date_from)) && (date_to == NULL || date_valid(date_to))) {
+		return counter_count(index->days, (date_from != NULL) ? date_to_day(date_from) : INT_MIN, (date_to != NULL) ? date_to_day(date_to) : INT_MAX);
+	}
+
+	// Αλλιώς δημιουργούμε δύο records ως κάτω και πάνω όριο
+	struct record record_from = { .date = date_from, .id = 0 };
+	struct record record_to = { .date = date_to, .id = INT_MAX };
+
+	// Και μετράμε τα records ανάμεσα σε αυτά με μία κατάβαση στο set
+	return set_range_count(index->set, (date_from != NULL) ? &record_from : NULL, (date_to != NULL) ? &record_to : NULL);
+}
+
+// Επιστρέφει λίστα με τα Records που ικανοποιούν τα συγκεκριμένα κριτήρια, σε
+// οποιαδήποτε σειρά.
+
+List monitor_get_records(DiseaseMonitor monitor, String disease, String country, Date date_from, Date date_to) {
+	monitor_read_lock(monitor);
+
+	// Βρίσκουμε το index με τις εγγραφές της συγκεκριμένης χώρας/ασθένειας
+	Index index = find_search_index(monitor, disease, country);
+
+	// Αν δεν βρούμε τέτοιο index τότε δεν υπάρχουν κατάλληλα
+	// records και επιστρέφουμε κενή λίστα
+	if (index == NULL) {
+		monitor_read_unlock(monitor);
+		return list_create(NULL);
+	}
+
+	// Αλλιώς φτιάχνουμε δύο records ως πάνω και κάτω όρια
+	Record record_from = malloc(sizeof(*record_from));
+	record_from->date = date_from;
+	record_from->id = 0;
+	Record record_to = malloc(sizeof(*record_to));
+	record_to->date = date_to;
+	record_to->id = INT_MAX;
+
+	// Και βρίσκουμε στο set τα records ανάμεσα σε αυτά τα όρια (NULL αν δεν υπάρχουν)
+	List list = set_return_from_to(index->set, (date_from != NULL) ? record_from : NULL, (date_to != NULL) ? record_to : NULL);
+
+	monitor_read_unlock(monitor);
+
+	free(record_from);
+	free(record_to);
+	
+	return list;
+}
+
+// Διάσχιση των εγγραφών που ικανοποιούν τα κριτήρια χωρίς τη δημιουργία λίστας.
+// Δεν παίρνει lock, σε concurrent monitor το lock το κρατάει ο χρήστης.
+
+void monitor_records_cursor(DiseaseMonitor monitor, DmCursor* cursor, String disease, String country, Date date_from, Date date_to) {
+	Index index = find_search_index(monitor, disease, country);
+	cursor->date_to = date_to;
+
+	// Αν δεν υπάρχει τέτοιο index ο cursor είναι εξαρχής στο τέλος
+	if (index == NULL) {
+		cursor->set = NULL;
+		cursor->node = SET_EOF;
+		return;
+	}
+	cursor->set = index->set;
+
+	// Αλλιώς ξεκινάμε από την πρώτη εγγραφή με ημερομηνία >= date_from
+	if (date_from != NULL) {
+		struct record record_from = { .date = date_from, .id = 0 };
+		cursor->node = set_lower_bound(cursor->set, &record_from);
+	}
+	else {
+		cursor->node = set_first(cursor->set);
+	}
+}
+
+Record dm_cursor_next(DmCursor* cursor) {
+	if (cursor->node == SET_EOF) {
+		return NULL;
+	}
+
+	// Σταματάμε μόλις ξεπεράσουμε το πάνω όριο
+	Record record = set_node_value(cursor->set, cursor->node);
+	if (cursor->date_to != NULL && strcmp(record->date, cursor->date_to) > 0) {
+		cursor->node = SET_EOF;
+		return NULL;
+	}
+
+	cursor->node = set_next(cursor->set, cursor->node);
+	return record;
+}
+
+// Επιστρέφει τον αριθμό εγγραφών που ικανοποιούν τα συγκεκριμένα κριτήρια.
+
+int monitor_count_records(DiseaseMonitor monitor, String disease, String country, Date date_from, Date date_to) {
+	monitor_read_lock(monitor);
+
+	// Βρίσκουμε το index με τις εγγραφές της συγκεκριμένης χώρας/ασθένειας
+	// (αν δεν βρούμε τέτοιο index τότε δεν υπάρχουν κατάλληλα records)
+	Index index = find_search_index(monitor, disease, country);
+	int count = (index != NULL) ? index_count(index, date_from, date_to) : 0;
+
+	monitor_read_unlock(monitor);
+	return count;
+}
+
+// Μετατρέπει τη λίστα top_nodes από DisCases σε λίστα που περιέχει μόνο τις ασθένειες,
+// με την ίδια σειρά. Η top_nodes καταστρέφεται.
+
+static List disease_list(List top_nodes) {
+	List top_diseases = list_create(NULL);
+
+	// Αφού οι ασθένειες βρίσκονται σε κόμβους μαζί με το πλήθπς των κρουσμάτων,
+	// δημιουργούμε μια λίστα που θα περιέχει μόνο τις ασθένειες
+	// (κάθε ασθένεια μπαίνει μετά τον τελευταίο κόμβο, ώστε να διατηρηθεί η σειρά)
+	for (ListNode node = list_first(top_nodes); node != LIST_EOF; node = list_next(top_nodes, node)) {
+		list_insert_next(top_diseases, list_last(top_diseases), ((DisCases) list_node_value(top_nodes, node))->disease);
+	}
+
+	// Δεν χρειαζόμαστε την λίστα με τους κόμβους ασθένειας-κρουσμάτων
+	list_destroy(top_nodes);
+
+	return top_diseases;
+}
+
+// Επιστρέφει τις k ασθένειες με τις περισσότερες εγγραφές που ικανοποιούν τo
+// κριτήριο country (μπορεί να είναι NULL) _ταξινομημένες_ με βάση τον αριθμό
+// εγγραφών (πρώτα η ασθένεια με τις περισσότερες).
+//
+// Πχ η dm_top_diseases(3, "Germany") επιστρέφει τις 3 ασθένειες με τις
+// περισσότερες εγγραφές στη Γερμανία. Επιστρέφονται _μόνο_ ασθένειες με
+// __τουλάχιστον 1 εγγραφή__ (που ικανοποιεί τα κριτήρια).
+
+List monitor_top_diseases(DiseaseMonitor monitor, int k, String country) {
+	List top_nodes;
+	PriorityQueue diseases;
+
+	monitor_read_lock(monitor);
+
+	// Βρίσκουμε την κατάλληλη pqueue ανάλογα με τον ψάχνουμε τις ασθένειες σε μια χώρα ή γενικά
+	if (country != NULL) {
+		CountryEntry entry = map_find(monitor->country_map, country);
+		diseases = (entry != NULL) ? entry->diseases : NULL;
+	}
+	else {
+		diseases = monitor->total_pq;
+	}
+
+	// Αν δεν υπάρχει τέτοια επιστρέφουμε κενή λίστα
+	if (diseases == NULL) {
+		monitor_read_unlock(monitor);
+		return list_create(NULL);
+	}
 
-struct dis_cases {
-	String disease;
-	int cases;
-};
+	// Παίρουμε τις πρώτες k ασθένειες (η pqueue_top_k δεν τροποποιεί την pqueue). Οι κόμβοι
+	// μπορεί να γίνουν free από μια αλλαγή μόλις αφήσουμε το lock, οπότε η λίστα με τις
+	// ασθένειες φτιάχνεται πριν το unlock.
+	top_nodes = pqueue_top_k(diseases, k);
+	List top_diseases = disease_list(top_nodes);
 
-// Hash function που παίρνει υπ' όψιν την χώρα και την ασθένεια ενός κρούσματος
+	monitor_read_unlock(monitor);
 
-static uint hash_dis_country(Pointer value) {
-	char total[strlen(((Record) value)->disease) + strlen(((Record) value)->country) + 1];
-	strcpy(total, ((Record) value)->disease);
-	strcat(total, ((Record) value)->country);
-	return hash_string(total);
+	return top_diseases;
 }
 
-// Hash function που παίρνει υπ' όψιν την ασθένεια ενός κρούσματος
+// Επιστρέφει ένα DisCases για κάθε ασθένεια, με το πλήθος των εγγραφών της
 
-static uint hash_disease(Pointer value) {
-	return hash_string(((Record) value)->disease);
-}
+List monitor_disease_cases(DiseaseMonitor monitor) {
+	List list = list_create(free);
+
+	monitor_read_lock(monitor);
+
+	// Κάθε ασθένεια έχει έναν κόμβο στην total_pq με το πλήθος των εγγραφών της
+	for (MapNode node = map_first(monitor->dis_map); node != MAP_EOF; node = map_next(monitor->dis_map, node)) {
+		DiseaseEntry entry = map_node_value(monitor->dis_map, node);
+		DisCases count = cases_create(entry->disease);
+		count->cases = ((DisCases) pqueue_node_value(monitor->total_pq, entry->node))->cases;
+		list_insert_next(list, LIST_BOF, count);
+	}
 
-// Hash function που παίρνει υπ' όψιν την χώρα ενός κρούσματος
+	monitor_read_unlock(monitor);
 
-static uint hash_country(Pointer value) {
-	return hash_string(((Record) value)->country);
+	return list;
 }
 
-// Hash function που παίρνει υπ' όψιν το id ενός κρούσματος
+// Επιστρέφει τις k ασθένειες με τις περισσότερες εγγραφές στη χώρα country (όλες, αν NULL)
+// με ημερομηνία από date_from μέχρι date_to. Για κάθε ασθένεια το πλήθος βρίσκεται από τον
+// μετρητή ανά ημέρα του αντίστοιχου index, χωρίς διάσχιση εγγραφών.
+
+List monitor_top_diseases_range(DiseaseMonitor monitor, int k, String country, Date date_from, Date date_to) {
+	monitor_read_lock(monitor);
+
+	// Μετράμε τις εγγραφές κάθε ασθένειας μέσα στο εύρος
+	Vector counts = vector_create(0, NULL);
+	for (MapNode node = map_first(monitor->dis_map); node != MAP_EOF; node = map_next(monitor->dis_map, node)) {
+		DiseaseEntry entry = map_node_value(monitor->dis_map, node);
+
+		// Το index της ασθένειας στη συγκεκριμένη χώρα, ή γενικά
+		Index index = (country != NULL)
+			? find_search_index(monitor, entry->disease, country)
+			: entry->index;
+		int cases = (index != NULL) ? index_count(index, date_from, date_to) : 0;
+
+		// Κρατάμε μόνο ασθένειες με τουλάχιστον 1 εγγραφή
+		if (cases > 0) {
+			DisCases count = cases_create(entry->disease);
+			count->cases = cases;
+			vector_insert_last(counts, count);
+		}
+	}
 
-static uint hash_id(Pointer value) {
-	return ((Record) value)->id;
+	monitor_read_unlock(monitor);
+
+	// Φτιάχνουμε σωρό από όλες τις ασθένειες σε O(m) και παίρνουμε τις πρώτες k
+	PriorityQueue diseases = pqueue_create(dm_compare_cases, free, counts);
+	List top_diseases = disease_list(pqueue_top_k(diseases, k));
+
+	vector_destroy(counts);
+	pqueue_destroy(diseases);
+
+	return top_diseases;
 }
 
-// Συνάρτηση σύγκρισης κρουσμάτων ως προς την ημερομηνία τους.
-// Ισοδύναμα θεωρούνται μόνο όσα έχουν ίδιο id, άρα αν δύο διαφορετικά
-// έχουν ίδια ημερομηνία κατατάσσονται σε αύξουσα σειρά id
+// Επιστρέφει την πρώτη ημερομηνία μέχρι την οποία (συμπεριλαμβανομένης) έχει
+// καταγραφεί τουλάχιστον το percent% των εγγραφών που ικανοποιούν τα κριτήρια,
+// ή NULL αν δεν υπάρχουν τέτοιες εγγραφές.
 
-static int compare_record_dates(Pointer a, Pointer b) {
-	int result = strcmp(((Record) a)->date, ((Record) b)->date);
-	if (result) {
-		return result;
+static Date percentile_date(DiseaseMonitor monitor, String disease, String country, Date date_from, Date date_to, int percent) {
+	Index index = find_search_index(monitor, disease, country);
+
+	if (index == NULL) {
+		return NULL;
 	}
-	return ((Record) a)->id - ((Record) b)->id;
-}
+	Set searchset = index->set;
 
-// Συνάρτηση σύγκρισης κρουσμάτων ως προς την χώρα και την ασθένειά τους.
-// Μας ενδιαφέρει ουσιαστικά μόνο η περίπτωση της ισοδυναμίας.
+	struct record record_from = { .date = date_from, .id = 0 };
+	struct record record_to = { .date = date_to, .id = INT_MAX };
 
-static int compare_records_country_dis(Pointer a, Pointer b) {
-	int result = strcmp(((Record) a)->country, ((Record) b)->country);
-	if (result) {
-		return result;
+	// Οι εγγραφές μέσα στα όρια είναι οι count εγγραφές μετά τη θέση first του set
+	int first = (date_from != NULL) ? set_rank(searchset, &record_from) : 0;
+	int count = set_range_count(searchset, (date_from != NULL) ? &record_from : NULL, (date_to != NULL) ? &record_to : NULL);
+	if (count == 0) {
+		return NULL;
 	}
-	return strcmp(((Record) a)->disease, ((Record) b)->disease);
-}
 
-// Συνάρτηση σύγκρισης κρουσμάτων ως προς την χώρα τους.
-// Μας ενδιαφέρει ουσιαστικά μόνο η περίπτωση της ισοδυναμίας.
+	// Χρειαζόμαστε τις πρώτες ceil(percent * count / 100) εγγραφές (τουλάχιστον μία).
+	// Το γινόμενο υπολογίζεται σε int64_t, αφού για μερικά εκατομμύρια εγγραφές ξεπερνάει το int
+	int64_t needed = ((int64_t) percent * count + 99) / 100;
+	if (needed < 1) {
+		needed = 1;
+	}
+	if (needed > count) {
+		needed = count;
+	}
 
-static int compare_countries(Pointer a, Pointer b) {
-	return strcmp(((Record) a)->country, ((Record) b)->country);
+	// Η ημερομηνία της τελευταίας από αυτές είναι το ζητούμενο
+	return ((Record) set_node_value(searchset, set_select(searchset, first + needed - 1)))->date;
 }
 
-// Συνάρτηση σύγκρισης κρουσμάτων ως προς την ασθένειά τους.
-// Μας ενδιαφέρει ουσιαστικά μόνο η περίπτωση της ισοδυναμίας.
-
-static int compare_diseases(Pointer a, Pointer b) {
-	return strcmp(((Record) a)->disease, ((Record) b)->disease);
+Date monitor_percentile_date(DiseaseMonitor monitor, String disease, String country, Date date_from, Date date_to, int percent) {
+	monitor_read_lock(monitor);
+	Date date = percentile_date(monitor, disease, country, date_from, date_to, percent);
+	monitor_read_unlock(monitor);
+	return date;
 }
 
-// Συνάρτηση σύγκρισης κρουσμάτων ως προς το id τους.
-// Μας ενδιαφέρει ουσιαστικά μόνο η περίπτωση της ισοδυναμίας.
 
-static int compare_ids(Pointer a, Pointer b) {
-	return ((Record) a)->id - ((Record) b)->id;
+// Φίλτρα πάνω στις στήλες //////////////////////////////////////////////////////////
+
+// Δημιουργεί τις στήλες από όλες τις εγγραφές του monitor
+
+static Columns build_columns(DiseaseMonitor monitor) {
+	Columns columns = columns_create();
+	Set set = monitor->total_index->set;
+	for (SetNode node = set_first(set); node != SET_EOF; node = set_next(set, node)) {
+		Record record = set_node_value(set, node);
+		PairKey key = pair_key(record->country, record->disease);
+		PairEntry pair = map_find_with(monitor->pair_map, key.hash, &key, compare_pair_key);
+		columns_insert(columns, record, pair->country, pair->disease, date_to_day(record->date));
+	}
+	return columns;
 }
 
-// Συνάρτηση σύγκρισης DiseaseCases ως προς τον αριθμό των κρουσματάτων τους.
+// Μετατρέπει τα n strings σε ids των στηλών. Τα strings που δεν υπάρχουν παραλείπονται (καμία
+// εγγραφή δεν τα έχει). Επιστρέφει το πλήθος των ids.
 
-static int compare_cases(Pointer a, Pointer b) {
-	return ((DisCases) a)->cases - ((DisCases) b)->cases;
+static int name_ids(Columns columns, String names[], int n, int32_t ids[]) {
+	int count = 0;
+	for (int i = 0; i < n; i++) {
+		int32_t id = columns_name_id(columns, names[i]);
+		if (id != -1) {
+			ids[count++] = id;
+		}
+	}
+	return count;
 }
 
-// Οι map country_map, dis_map, country_dis_map οδηγούν από ένα record (key) στο set (value) από records, κατατεταγμένα με την ημερομηνία τους,
-// που μοιράζονται την ίδια χώρα, ασθένεια, ή και τα δύο, αντίστοιχα.
-// Ο id_map οδηγεί από ένα record με ένα συγκεκριμένο id στο record με το ίδιο id που είναι αποθηκευμένο στο disease monitor.
-// Η country_to_pq οδηγεί από μια χώρα (key) στην pqueue (value) από DisCases, δηλαδή από ασθένειες κατατεταγμένες με τον
-// αριθμό των κρουσμάτων τους, για αυτήν την χώρα.
-// Η country_dis_to_pqnode οδηγεί από ένα record (key) στον κόμβο της pqueue για αυτήν την χώρα (value), ο οποίος
-// αναπαριστά αυτήν την ασθένεια.
-// Το total_set είναι ένα σύνολο που περιέχει όλα τα records κατατεταγμένα με την ημερομηνία τους.
-// Η total_pq είναι μια pqueue που περιέχει όλες τις ασθένειες κατατεταγμένες σύμφωνα με τον αριθμό των κρουσμάτων τους,
-// ανεξάρτητα από την χώρα.
-// Ο dis_to_pqnode οδηγεί από ένα record (key) με μια συγκεκριμένη ασθένεια στον κόμβο της total_pq που αντιπροσωεύει αυτήν την ασθένεια.
+int monitor_count_where(DiseaseMonitor monitor, DmFilter* filter) {
+	monitor_read_lock(monitor);
 
-static Map country_map, dis_map, country_dis_map, id_map, country_to_pq, country_dis_to_pqnode, dis_to_pqnode;
-static Set total_set;
-static PriorityQueue total_pq;
+	// Οι στήλες δημιουργούνται στο πρώτο query (με το write lock, αφού αλλάζουν το monitor)
+	if (monitor->columns == NULL) {
+		monitor_read_unlock(monitor);
+		write_lock(monitor);
+		if (monitor->columns == NULL) {
+			monitor->columns = build_columns(monitor);
+		}
+		write_unlock(monitor);
+		monitor_read_lock(monitor);
+	}
 
-// Αρχικοποιεί όλες τις δομές του monitor, πρέπει να κληθεί πριν από οποιαδήποτε άλλη κλήση.
-// Αν υπήρχαν ήδη δεδομένα τα διαγράφει καλώντας την dm_destroy.
+	// Πίνακας NULL (ή πλήθος <= 0) σημαίνει χωρίς κριτήριο. Τα πλήθη δίνονται από τον χρήστη,
+	// οπότε οι πίνακες των ids δεσμεύονται με malloc και όχι στη στοίβα.
+	int filter_country_no = (filter->countries != NULL && filter->country_no > 0) ? filter->country_no : 0;
+	int filter_disease_no = (filter->diseases != NULL && filter->disease_no > 0) ? filter->disease_no : 0;
+
+	Columns columns = monitor->columns;
+	int32_t* countries = malloc((filter_country_no + 1) * sizeof(int32_t));
+	int32_t* diseases = malloc((filter_disease_no + 1) * sizeof(int32_t));
+	int country_no = name_ids(columns, filter->countries, filter_country_no, countries);
+	int disease_no = name_ids(columns, filter->diseases, filter_disease_no, diseases);
+
+	// Αν ζητήθηκαν μόνο χώρες/ασθένειες χωρίς εγγραφές δεν υπάρχει τίποτα να μετρηθεί
+	int count = 0;
+	if ((filter_country_no == 0 || country_no > 0) && (filter_disease_no == 0 || disease_no > 0)) {
+		count = columns_count(columns, countries, country_no, diseases, disease_no,
+			(filter->date_from != NULL) ? date_to_day(filter->date_from) : INT32_MIN,
+			(filter->date_to != NULL) ? date_to_day(filter->date_to) : INT32_MAX);
+	}
 
-void dm_init() {
-	country_dis_map = map_create(compare_records_country_dis, NULL, (DestroyFunc) set_destroy);
-	map_set_hash_function(country_dis_map, hash_dis_country);
+	monitor_read_unlock(monitor);
 
-	dis_map = map_create(compare_diseases, NULL, (DestroyFunc) set_destroy);
-	map_set_hash_function(dis_map, hash_disease);
+	free(countries);
+	free(diseases);
+	return count;
+}
+
+// Αποθήκευση / φόρτωση ////////////////////////////////////////////////////////
+//
+// Το αρχείο έχει ένα header, τον πίνακα των strings (κάθε διαφορετικό string μία φορά,
+// τερματισμένο με '\0') και τις εγγραφές ταξινομημένες ως προς compare_record_dates, με
+// τα strings τους ως θέσεις στον πίνακα. Οι αριθμοί γράφονται με τη σειρά bytes του
+// μηχανήματος, οπότε το αρχείο διαβάζεται μόνο από μηχάνημα με ίδιο endianness.
+//
+// Αφού οι εγγραφές είναι ταξινομημένες, οι εγγραφές κάθε χώρας/ασθένειας είναι επίσης
+// ταξινομημένες, οπότε όλα τα sets χτίζονται σε γραμμικό χρόνο (set_create_from_sorted).
 
-	country_map = map_create(compare_countries, NULL, (DestroyFunc) set_destroy);
-	map_set_hash_function(country_map, hash_country);
+#define FILE_MAGIC "DMON"
+#define FILE_VERSION 1
+
+struct file_header {
+	char magic[4];
+	uint32_t version;
+	uint32_t record_no;
+	uint32_t string_bytes;		// Μέγεθος του πίνακα strings
+};
+
+struct file_record {
+	int32_t id;
+	uint32_t name, disease, country, date;	// Θέσεις στον πίνακα strings
+};
 
-	id_map =  map_create(compare_ids, NULL, NULL);
-	map_set_hash_function(id_map, hash_id);
+// Πίνακας strings που μεγαλώνει με διπλασιασμό, και map από κάθε string στη θέση του
 
-	country_to_pq = map_create((CompareFunc) strcmp, NULL, (DestroyFunc) pqueue_destroy);
-	map_set_hash_function(country_to_pq, hash_string);
+struct string_table {
+	char* data;
+	uint32_t size, capacity;
+	Map offsets;
+};
 
-	country_dis_to_pqnode = map_create(compare_records_country_dis, NULL, NULL);
-	map_set_hash_function(country_dis_to_pqnode, hash_dis_country);
+// Επιστρέφει τη θέση του string στον πίνακα, προσθέτοντάς το αν δεν υπάρχει ήδη
 
-	dis_to_pqnode = map_create(compare_diseases, NULL, NULL);
-	map_set_hash_function(dis_to_pqnode, hash_disease);
+static uint32_t string_table_offset(struct string_table* table, String string) {
+	// Στο map αποθηκεύεται θέση + 1, ώστε η θέση 0 να μην είναι NULL
+	bool inserted;
+	MapNode node = map_find_or_insert(table->offsets, string, NULL, &inserted);
+	if (!inserted) {
+		return (uintptr_t) map_node_value(table->offsets, node) - 1;
+	}
 
-	total_set = set_create(compare_record_dates, NULL);
+	uint32_t length = strlen(string) + 1;
+	while (table->size + length > table->capacity) {
+		table->capacity *= 2;
+		table->data = realloc(table->data, table->capacity);
+	}
+	uint32_t offset = table->size;
+	memcpy(table->data + offset, string, length);
+	table->size += length;
 
-	total_pq = pqueue_create(compare_cases, free, NULL);
+	map_node_set_value(table->offsets, node, (Pointer) (uintptr_t) (offset + 1));
+	return offset;
 }
 
-// Καταστρέφει όλες τις δομές του monitor, απελευθερώνοντας την αντίστοιχη
-// μνήμη. ΔΕΝ κάνει free τα records, αυτά δημιουργούνται και καταστρέφονται από
-// τον χρήστη.
+bool monitor_save(DiseaseMonitor monitor, String path) {
+	FILE* file = fopen(path, "wb");
+	if (file == NULL) {
+		return false;
+	}
 
-void dm_destroy() {
-	map_destroy(country_dis_map);
-	map_destroy(id_map);
-	map_destroy(dis_map);
-	map_destroy(country_map);
-	map_destroy(country_to_pq);
-	map_destroy(country_dis_to_pqnode);
-	map_destroy(dis_to_pqnode);
-	set_destroy(total_set);
-	pqueue_destroy(total_pq);
+	struct string_table table = { .data = malloc(1024), .size = 0, .capacity = 1024 };
+	table.offsets = map_create((CompareFunc) strcmp, NULL, NULL);
+	map_set_hash_function(table.offsets, hash_string);
+
+	monitor_read_lock(monitor);
+
+	// Οι εγγραφές με τη σειρά του συνολικού set, δηλαδή ταξινομημένες
+	Set set = monitor->total_index->set;
+	struct file_header header = { .magic = FILE_MAGIC, .version = FILE_VERSION, .record_no = set_size(set) };
+	struct file_record* records = malloc((header.record_no + 1) * sizeof(*records));
+
+	int i = 0;
+	for (SetNode node = set_first(set); node != SET_EOF; node = set_next(set, node), i++) {
+		Record record = set_node_value(set, node);
+		records[i].id = record->id;
+		records[i].name = string_table_offset(&table, record->name);
+		records[i].disease = string_table_offset(&table, record->disease);
+		records[i].country = string_table_offset(&table, record->country);
+		records[i].date = string_table_offset(&table, record->date);
+	}
+
+	monitor_read_unlock(monitor);
+
+	header.string_bytes = table.size;
+	bool success =
+		fwrite(&header, sizeof(header), 1, file) == 1 &&
+		fwrite(table.data, 1, table.size, file) == table.size &&
+		fwrite(records, sizeof(*records), header.record_no, file) == header.record_no;
+
+	free(records);
+	free(table.data);
+	map_destroy(table.offsets);
+
+	return fclose(file) == 0 && success;
 }
 
+// Σύγκριση pointers, για map με key ένα pointer
 
-// Προσθέτει την εγγραφή record στο monitor. Δεν δεσμεύει νέα μνήμη (ούτε
-// φτιάχνει αντίγραφα του record), απλά αποθηκεύει τον pointer (η δέσμευση
-// μνήμης για τα records είναι ευθύνη του χρήστη). Αν υπάρχει εγγραφή με το ίδιο
-// id αντικαθίσταται και επιστρέφεται true, αν όχι επιστρέφεται false.
-//
-// Οι αλλαγές στα δεδομένα της εγγραφής απαγορεύονται μέχρι να γίνει remove από
-// τον monitor.
+static int compare_pointers(Pointer a, Pointer b) {
+	return (a < b) ? -1 : (a > b);
+}
 
-bool dm_insert_record(Record record) {
-	bool removed = false;
+static Pointer create_group(Pointer index) {
+	return vector_create(0, NULL);
+}
 
-	// Αν υπάρχει εγγραφή με αυτό το id την αφαιρούμε και σημειώνουμε πως υπήρχε
-	if (dm_remove_record(record->id)) {
-		removed = true;
+// Προσθέτει σε κενό monitor τις n εγγραφές του records, που είναι ταξινομημένες ως προς
+// compare_record_dates και έχουν διαφορετικά ids.
+
+static void build_from_sorted(DiseaseMonitor monitor, Record records[], int n) {
+	map_reserve(monitor->id_map, n);
+	for (int i = 0; i < n; i++) {
+		map_insert(monitor->id_map, records[i], records[i]);
 	}
 
-	// Προσθέτουμε την νέα εγγραφή
-	Set dest_set;
+	index_fill_sorted(monitor->total_index, records, n);
 
-	// Προσθέτουμε το record στο id_map για να το βρίσκουμε μετά από το id του
-	map_insert(id_map, record, record);
+	// Μοιράζουμε τις εγγραφές στα indexes των entries (που δημιουργούνται κενά). Οι εγγραφές
+	// μπαίνουν με τη σειρά τους, οπότε και οι εγγραφές κάθε index είναι ταξινομημένες.
+	Map groups = map_create(compare_pointers, NULL, (DestroyFunc) vector_destroy);
+	map_set_hash_function(groups, hash_pointer);
 
-	// Το προσθέτουμε στο συνολικό σύνολο
-	set_insert(total_set, record);
+	for (int i = 0; i < n; i++) {
+		PairEntry pair = find_pair(monitor, records[i]);
+		Index indexes[] = { pair->index, pair->country_entry->index, pair->disease_entry->index };
 
-	// Το προσθέτουμε στο σύνολο που καθορίζεται από την ασθένειά του
-	if ((dest_set = map_find(dis_map, record))) {
-		set_insert(dest_set, record);
+		for (int j = 0; j < 3; j++) {
+			Vector group = map_node_value(groups, map_find_or_insert(groups, indexes[j], create_group, NULL));
+			vector_insert_last(group, records[i]);
+		}
 	}
-	// Αν δεν υπάρχει τέτοιο σύνολο το δημιουργούμε
-	else {
-		dest_set = set_create(compare_record_dates, NULL);
-		map_insert(dis_map, record, dest_set);
-		set_insert(dest_set, record);
+
+	for (MapNode node = map_first(groups); node != MAP_EOF; node = map_next(groups, node)) {
+		Vector group = map_node_value(groups, node);
+		int size = vector_size(group);
+
+		Record* group_records = malloc(size * sizeof(Record));
+		for (int i = 0; i < size; i++) {
+			group_records[i] = vector_get_at(group, i);
+		}
+		index_fill_sorted(map_node_key(groups, node), group_records, size);
+		free(group_records);
 	}
+	map_destroy(groups);
 
-	// Το προσθέτουμε στο σύνολο που καθορίζεται από την χώρα του
-	if ((dest_set = map_find(country_map, record))) {
-		set_insert(dest_set, record);
+	// Τα κρούσματα στις pqueues είναι τα μεγέθη των indexes
+	for (MapNode node = map_first(monitor->pair_map); node != MAP_EOF; node = map_next(monitor->pair_map, node)) {
+		PairEntry pair = map_node_value(monitor->pair_map, node);
+		cases_add(pair->country_entry->diseases, pair->node, set_size(pair->index->set));
 	}
-	else {
-		dest_set = set_create(compare_record_dates, NULL);
-		map_insert(country_map, record, dest_set);
-		set_insert(dest_set, record);
+	for (MapNode node = map_first(monitor->dis_map); node != MAP_EOF; node = map_next(monitor->dis_map, node)) {
+		DiseaseEntry disease = map_node_value(monitor->dis_map, node);
+		cases_add(monitor->total_pq, disease->node, set_size(disease->index->set));
 	}
+}
 
-	// Το προσθέτουμε στην pqueue της χώρας του
-	PriorityQueue dest_pq;
-	PriorityQueueNode node;
-	DisCases count;
-	// Αν υπάρχει pqueue το προσθέτουμε εκεί
-	if ((dest_pq = map_find(country_to_pq, record->country))) {
-		// ΑΝ υπάρχει ο κόμβος τον ενημερώνουμε
-		if ((node = map_find(country_dis_to_pqnode, record))) {
-			((DisCases) pqueue_node_value(dest_pq, node))->cases++;
-			pqueue_update_order(dest_pq, node);
-		}
-		// ΑΛλιώς τον δημιουργούμε, και τον αποθηκεύουμε στο αντίστοιχο map
-		else {
-			count = malloc(sizeof(*count));
-			count->disease = record->disease;
-			count->cases = 1;
-			node = pqueue_insert(dest_pq, count);
-			map_insert(country_dis_to_pqnode, record, node);
-		}
-	}
-	// Αλλιώς την δημιουργούμε
-	else {
-		dest_pq = pqueue_create(compare_cases, free, NULL);
-		map_insert(country_to_pq, record->country, dest_pq);
-		count = malloc(sizeof(*count));
-		count->disease = record->disease;
-		count->cases = 1;
-		node = pqueue_insert(dest_pq, count);
-		map_insert(country_dis_to_pqnode, record, node);
+static String file_string(char* strings, uint32_t size, uint32_t offset) {
+	return offset < size ? strings + offset : NULL;
+}
+
+DiseaseMonitor monitor_load(String path) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		return NULL;
 	}
 
-	// Το προσθέτουμε στην συνολική pqueue
-	if ((node = map_find(dis_to_pqnode, record))) {
-		((DisCases) pqueue_node_value(total_pq, node))->cases++;
-		pqueue_update_order(total_pq, node);
+	// Διαβάζουμε και ελέγχουμε το header. Οι πίνακες που περιγράφει πρέπει να χωράνε στο
+	// υπόλοιπο αρχείο, ώστε ένα κατεστραμμένο header να μην οδηγεί σε τεράστιες δεσμεύσεις
+	struct file_header header;
+	struct stat st;
+	if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, FILE_MAGIC, 4) != 0 ||
+		header.version != FILE_VERSION || header.record_no > INT_MAX / sizeof(struct record) ||
+		fstat(fileno(file), &st) == -1 ||
+		(uint64_t) header.string_bytes + (uint64_t) header.record_no * sizeof(struct file_record) >
+			(uint64_t) st.st_size - sizeof(header)) {
+		fclose(file);
+		return NULL;
 	}
-	else {
-		count = malloc(sizeof(*count));
-		count->disease = record->disease;
-		count->cases = 1;
-		node = pqueue_insert(total_pq, count);
-		map_insert(dis_to_pqnode, record, node);
+
+	// Τα strings μένουν στον buffer όπου διαβάστηκαν, και οι εγγραφές δείχνουν μέσα σε αυτόν
+	char* strings = malloc((size_t) header.string_bytes + 1);
+	struct file_record* file_records = malloc(((size_t) header.record_no + 1) * sizeof(*file_records));
+	Record records = malloc(((size_t) header.record_no + 1) * sizeof(*records));
+	Record* sorted = malloc(((size_t) header.record_no + 1) * sizeof(Record));
+
+	bool valid =
+		fread(strings, 1, header.string_bytes, file) == header.string_bytes &&
+		fread(file_records, sizeof(*file_records), header.record_no, file) == header.record_no &&
+		(header.string_bytes == 0 || strings[header.string_bytes - 1] == '\0');
+	fclose(file);
+
+	// Ελέγχουμε ότι οι θέσεις των strings είναι έγκυρες, οι ημερομηνίες είναι υπαρκτές σε μορφή
+	// YYYY-MM-DD και οι εγγραφές είναι ταξινομημένες
+	for (uint32_t i = 0; valid && i < header.record_no; i++) {
+		records[i].id = file_records[i].id;
+		records[i].name = file_string(strings, header.string_bytes, file_records[i].name);
+		records[i].disease = file_string(strings, header.string_bytes, file_records[i].disease);
+		records[i].country = file_string(strings, header.string_bytes, file_records[i].country);
+		records[i].date = file_string(strings, header.string_bytes, file_records[i].date);
+		sorted[i] = &records[i];
+
+		valid = records[i].name != NULL && records[i].disease != NULL && records[i].country != NULL &&
+			records[i].date != NULL && date_valid(records[i].date) &&
+			(i == 0 || compare_record_dates(sorted[i - 1], sorted[i]) < 0);
 	}
+	free(file_records);
 
-	// Το προσθέτουμε στο σύνολο που καθορίζεται από την ασθένειά και την χώρα του
-	if ((dest_set = map_find(country_dis_map, record))) {
-		set_insert(dest_set, record);
+	if (!valid) {
+		free(strings);
+		free(records);
+		free(sorted);
+		return NULL;
 	}
-	else {
-		dest_set = set_create(compare_record_dates, NULL);
-		map_insert(country_dis_map, record, dest_set);
-		set_insert(dest_set, record);
+
+	DiseaseMonitor monitor = dm_create();
+	list_insert_next(monitor->owned, LIST_BOF, strings);
+	list_insert_next(monitor->owned, LIST_BOF, records);
+
+	build_from_sorted(monitor, sorted, header.record_no);
+	free(sorted);
+
+	// Δύο εγγραφές με το ίδιο id (αλλά διαφορετική ημερομηνία) σημαίνουν κατεστραμμένο αρχείο
+	if (map_size(monitor->id_map) != header.record_no) {
+		dm_free(monitor);
+		return NULL;
 	}
 
-	// Επιστρέφουμε αν αφαιρέθηκε άλλη εγγραφή ή όχι
-	return removed;
+	return monitor;
 }
 
-// Αφαιρεί την εγγραφή με το συγκεκριμένο id από το σύστημα (χωρίς free, είναι
-// ευθύνη του χρήστη). Επιστρέφει true αν υπήρχε τέτοια εγγραφή, αλλιώς false.
 
-bool dm_remove_record(int id) {
-	// Δημιουργούμε ένα προσωρινό record με το δοσμένο id για να
-	// βρούμε το record με αυτό το id που έχουμε αποθηκεύσει
-	Record temp_record = malloc(sizeof(*temp_record));
-	temp_record->id = id;
-	Record record = map_find(id_map, temp_record);
+// Εισαγωγή από CSV/TSV ///////////////////////////////////////////////////////////////
+//
+// Το αρχείο διαβάζεται σε blocks των INGEST_BLOCK bytes. Σε κάθε block οι γραμμές και τα πεδία
+// εντοπίζονται με memchr (που στη glibc ελέγχει πολλά bytes ανά εντολή) και τα διαχωριστικά
+// γίνονται '\0', οπότε τα strings των εγγραφών δείχνουν μέσα στο block. Η μισή γραμμή στο
+// τέλος ενός block αντιγράφεται στην αρχή του επόμενου.
+
+#define INGEST_BLOCK (1 << 20)
+#define INGEST_BATCH 1024
+
+static double now_seconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
 
-	// Αν δεν υπάρχει επιστρέφουμε false
-	if (record == NULL) {
-		free(temp_record);
-		return false;
-	}
+// Χωρίζει τη γραμμή [line, end) στα πεδία της και συμπληρώνει το record. Το *end γίνεται '\0'.
+// Επιστρέφει false αν η γραμμή δεν είναι έγκυρη εγγραφή.
 
-	// Αλλιώς το αφαιρούμε από το id_map
-	map_remove(id_map, temp_record);
-	free(temp_record);
-	// Από όλα τα sets
-	Set set = map_find(country_dis_map, record);
-	set_remove(set, record);
-	// Τα οποία καταστρέφονται αν μείνουν κενά
-	if (set_size(set) == 0) {
-		map_remove(country_dis_map, record);
-	}
-	set = map_find(dis_map, record);
-	set_remove(set, record);
-	if (set_size(set) == 0) {
-		map_remove(dis_map, record);
-	}
-	set = map_find(country_map, record);
-	set_remove(set, record);
-	if (set_size(set) == 0) {
-		map_remove(country_map, record);
-	}
-
-	// Από την pqueue της χώρας του
-	PriorityQueue pqueue = map_find(country_to_pq, record->country);
-	PriorityQueueNode node = map_find(country_dis_to_pqnode, record);
-	DisCases count = pqueue_node_value(pqueue, node);
-	// Ενημερώνεται το node και αν μείνει κενό αφαιρείται
-	if (count->cases == 1) {
-		map_remove(country_dis_to_pqnode, record);
-		pqueue_remove_node(pqueue, node);
-		// Και αν μείνει κενή και η pqueue καταστρέφεται
-		if (pqueue_size(pqueue) == 0) {
-			map_remove(country_to_pq, record->country);
+static bool parse_csv_line(char* line, char* end, char delimiter, Record record) {
+	String fields[5];
+	char* field = line;
+	for (int i = 0; i < 5; i++) {
+		char* next = memchr(field, delimiter, end - field);
+		if ((i < 4 && next == NULL) || (i == 4 && next != NULL)) {
+			return false;
 		}
-	}
-	else {
-		count->cases--;
-		pqueue_update_order(pqueue, node);
+		if (i == 4) {
+			next = end;
+		}
+		*next = '\0';
+		fields[i] = field;
+		field = next + 1;
 	}
 
-	// Από την συνολική pqueue
-	node = map_find(dis_to_pqnode, record);
-	count = pqueue_node_value(total_pq, node);
-	// Ενημερώνεται ή αφαιρείται ο κόμβος
-	if (count->cases == 1) {
-		map_remove(dis_to_pqnode, record);
-		pqueue_remove_node(total_pq, node);
-	}
-	else {
-		count->cases--;
-		pqueue_update_order(total_pq, node);
+	char* id_end;
+	errno = 0;
+	long id = strtol(fields[0], &id_end, 10);
+	if (id_end == fields[0] || *id_end != '\0' || errno != 0 || id < INT_MIN || id > INT_MAX) {
+		return false;
 	}
 
-	// Τέλος αφιρείται από το συνολικό σύνολο κρουσμάτων
-	set_remove(total_set, record);
+	// Μόνο υπαρκτές ημερομηνίες (πχ όχι 2020-13-01 ή 2020-02-30)
+	Date date = fields[4];
+	if (!date_valid(date)) {
+		return false;
+	}
 
-	// Το record αφαιρέθηκε επιτυχώς
+	*record = (struct record) { .id = id, .name = fields[1], .disease = fields[2], .country = fields[3], .date = date };
 	return true;
 }
 
+// Προσθέτει στο monitor τις εγγραφές του batch
 
-// Monitor queries
-//
-// Στις παρακάτω συναρτήσεις χρησιμοποιούνται τα παρακάτω κριτήρια αναζήτησης εγγραφών:
-//   disease:   Μόνο εγγραφές με τη συγκεκριμένη ασθένεια (όλες, αν NULL)
-//   country:   Μόνο εγγραφές με τη συγκεκριμένη χώρα (όλες, αν NULL)
-//   date_from: Μόνο εγγραφές με ημερομηνία date_from ή μεταγενέστερη (όλες, αν NULL)
-//   date_to:   Μόνο εγγραφές με ημερομηνία date_to ή προγενέστερη (όλες, αν NULL)
-//
-// Οποιοδήποτε από τα κριτήρια μπορεί να είναι NULL, το οποίο σημαίνει "όλες οι
-// εγγραφές" (χωρίς φίλτρο για το συγκεκριμένο πεδίο).
-//
-// Στις συναρτήσεις που επιστρέφουν λίστα, η λίστα δημιουργείται την ώρα της
-// κλήσης και είναι ευθύνη του χρήστη να καλέσει τη list_destroy (η οποία θα
-// ελευθερώσει μόνο τη λίστα, όχι τα δεδομένα).
-
+static void ingest_batch(DiseaseMonitor monitor, Record batch[], int* batch_no, DmIngestStats* stats) {
+	double start = now_seconds();
+	monitor_insert_records(monitor, batch, *batch_no);
+	stats->insert_seconds += now_seconds() - start;
+	stats->records += *batch_no;
+	*batch_no = 0;
+}
 
-// Επιστρέφει λίστα με τα Records που ικανοποιούν τα συγκεκριμένα κριτήρια, σε
-// οποιαδήποτε σειρά.
+int monitor_ingest_csv(DiseaseMonitor monitor, int fd, DmIngestStats* stats) {
+	DmIngestStats total = { 0 };
+	List owned = list_create(NULL);			// Blocks και πίνακες εγγραφών, μεταφέρονται στο monitor->owned
+
+	Record batch[INGEST_BATCH];
+	int batch_no = 0;
+	Record records = NULL;					// Ο τρέχων πίνακας εγγραφών και πόσες θέσεις του έχουν χρησιμοποιηθεί
+	int records_used = INGEST_BATCH;
+
+	char delimiter = 0;						// 0 μέχρι να διαβαστεί η πρώτη γραμμή
+	char* tail = NULL;						// Η μισή γραμμή στο τέλος του προηγούμενου block
+	size_t tail_size = 0;
+	bool eof = false, error = false;
+
+	while (!eof) {
+		// Ανάγνωση ενός block (+1 byte για το '\0' μιας τελευταίας γραμμής χωρίς '\n')
+		size_t capacity = tail_size + INGEST_BLOCK;
+		char* block = malloc(capacity + 1);
+		if (tail_size > 0)
+			memcpy(block, tail, tail_size);
+		size_t size = tail_size;
+
+		double start = now_seconds();
+		while (size < capacity) {
+			ssize_t n = read(fd, block + size, capacity - size);
+			if (n < 0 && errno == EINTR) {
+				continue;
+			}
+			if (n <= 0) {
+				eof = true;
+				error = n < 0;
+				break;
+			}
+			size += n;
+		}
+		total.read_seconds += now_seconds() - start;
+		total.bytes += size - tail_size;
 
-List dm_get_records(String disease, String country, Date date_from, Date date_to) {
-	// Επιλέγουμε το map ανάλογα με το πόσες πληροφορίες έχουμε για την χώρα
-	// και μέσα από από αυτό βρίσκουμε το κατάλληλο set
-	Map searchmap = country_dis_map;
-	Set searchset;
-	if ((disease != NULL) || (country != NULL)) {
-		if (disease == NULL) {
-			searchmap = country_map;
+		// Το τελευταίο block μικραίνει στο μέγεθος που χρειάζεται (πριν δημιουργηθούν pointers μέσα του)
+		if (eof) {
+			block = realloc(block, size + 1);
 		}
-		if (country == NULL) {
-			searchmap = dis_map;
+		list_insert_next(owned, LIST_BOF, block);
+
+		start = now_seconds();
+		double insert_seconds = total.insert_seconds;
+
+		char* line = block;
+		char* block_end = block + size;
+		while (line < block_end) {
+			char* newline = memchr(line, '\n', block_end - line);
+			if (newline == NULL && !eof) {
+				break;
+			}
+			char* end = newline != NULL ? newline : block_end;
+			char* next = newline != NULL ? newline + 1 : block_end;
+			if (end > line && end[-1] == '\r') {
+				end--;
+			}
+
+			// Από την πρώτη γραμμή βρίσκουμε το διαχωριστικό, και αν είναι επικεφαλίδα την παραλείπουμε
+			if (delimiter == 0) {
+				char* c = line;
+				while (c < end && *c != ',' && *c != '\t') {
+					c++;
+				}
+				delimiter = c < end ? *c : ',';
+
+				if (line < end && (*line < '0' || *line > '9') && *line != '-') {
+					line = next;
+					continue;
+				}
+			}
+
+			if (line == end) {
+				line = next;						// Κενές γραμμές απλά αγνοούνται
+				continue;
+			}
+
+			if (records_used == INGEST_BATCH) {
+				records = malloc(INGEST_BATCH * sizeof(*records));
+				list_insert_next(owned, LIST_BOF, records);
+				records_used = 0;
+			}
+
+			Record record = &records[records_used];
+			if (parse_csv_line(line, end, delimiter, record)) {
+				records_used++;
+				batch[batch_no++] = record;
+				if (batch_no == INGEST_BATCH) {
+					ingest_batch(monitor, batch, &batch_no, &total);
+				}
+			} else {
+				total.rejected++;
+			}
+			line = next;
 		}
-		Record temp_record = malloc(sizeof(*temp_record));
-		temp_record->disease = disease;
-		temp_record->country = country;
-		searchset = map_find(searchmap, temp_record);
-		free(temp_record);
+
+		tail = line;
+		tail_size = block_end - line;
+		total.parse_seconds += now_seconds() - start - (total.insert_seconds - insert_seconds);
 	}
-	else {
-		searchset = total_set;
+
+	ingest_batch(monitor, batch, &batch_no, &total);
+
+	// Η μνήμη των εγγραφών ανήκει πλέον στο monitor. Ενα owning monitor έχει ήδη κρατήσει
+	// αντίγραφα, οπότε τα blocks δεν χρειάζονται.
+	if (monitor->owning) {
+		list_set_destroy_value(owned, free);
+	} else {
+		write_lock(monitor);
+		for (ListNode node = list_first(owned); node != LIST_EOF; node = list_next(owned, node)) {
+			list_insert_next(monitor->owned, LIST_BOF, list_node_value(owned, node));
+		}
+		write_unlock(monitor);
 	}
+	list_destroy(owned);
 
-	// Αν δεν βρούμε τέτοιο set τότε δεν υπάρχουν κατάλληλα
-	// records και επιστρέφουμε κενή λίστα
-	if (searchset == NULL) {
-		return list_create(NULL);
+	if (stats != NULL) {
+		*stats = total;
 	}
+	return error ? -1 : total.records;
+}
 
-	// Αλλιώς φτιάχνουμε δύο records ως πάνω και κάτω όρια
-	Record record_from = malloc(sizeof(*record_from));
-	record_from->date = date_from;
-	record_from->id = 0;
-	Record record_to = malloc(sizeof(*record_to));
-	record_to->date = date_to;
-	record_to->id = INT_MAX;
 
-	// Και βρίσκουμε στο set τα records ανάμεσα σε αυτά τα όρια (NULL αν δεν υπάρχουν)
-	List list = set_return_from_to(searchset, (date_from != NULL) ? record_from : NULL, (date_to != NULL) ? record_to : NULL);
+// Οι συναρτήσεις dm_* λειτουργούν πάνω στο default_monitor ////////////////////////////
 
-	free(record_from);
-	free(record_to);
-	
-	return list;
+void dm_init() {
+	ADT_STATS_START(start);
+
+	// Αν υπήρχαν ήδη δεδομένα τα διαγράφουμε
+	if (default_monitor != NULL) {
+		dm_destroy();
+	}
+	default_monitor = dm_create();
+
+	ADT_STATS_RECORD(&dm_stats[DM_OP_INIT], ADT_STATS_ELAPSED(start));
 }
 
-// Επιστρέφει τον αριθμό εγγραφών που ικανοποιούν τα συγκεκριμένα κριτήρια.
+void dm_init_owning() {
+	ADT_STATS_START(start);
 
-int dm_count_records(String disease, String country, Date date_from, Date date_to) {
-	// Επιλέγουμε το map ανάλογα με το πόσες πληροφορίες έχουμε για την χώρα
-	// και μέσα από από αυτό βρίσκουμε το κατάλληλο set
-	Map searchmap = country_dis_map;
-	Set searchset;
-	if ((disease != NULL) || (country != NULL)) {
-		if (disease == NULL) {
-			searchmap = country_map;
-		}
-		if (country == NULL) {
-			searchmap = dis_map;
-		}
-		Record temp_record = malloc(sizeof(*temp_record));
-		temp_record->disease = disease;
-		temp_record->country = country;
-		searchset = map_find(searchmap, temp_record);
-		free(temp_record);
-	}
-	else {
-		searchset = total_set;
+	if (default_monitor != NULL) {
+		dm_destroy();
 	}
+	default_monitor = dm_create_owning();
 
-	// Αν δεν βρούμε τέτοιο set τότε δεν υπάρχουν κατάλληλα
-	// records και επιστρέφουμε 0
-	if (searchset == NULL) {
-		return 0;
+	ADT_STATS_RECORD(&dm_stats[DM_OP_INIT], ADT_STATS_ELAPSED(start));
+}
+
+DiseaseMonitor dm_snapshot() {
+	ADT_STATS_START(start);
+	DiseaseMonitor result = monitor_snapshot(default_monitor);
+	ADT_STATS_RECORD(&dm_stats[DM_OP_SNAPSHOT], ADT_STATS_ELAPSED(start));
+	return result;
+}
+
+bool dm_save(String path) {
+	ADT_STATS_START(start);
+	bool result = monitor_save(default_monitor, path);
+	ADT_STATS_RECORD(&dm_stats[DM_OP_SAVE], ADT_STATS_ELAPSED(start));
+	return result;
+}
+
+bool dm_load(String path) {
+	ADT_STATS_START(start);
+
+	DiseaseMonitor monitor = monitor_load(path);
+	if (monitor != NULL) {
+		// Τα προηγούμενα δεδομένα (αν υπήρχαν) αντικαθίστανται
+		if (default_monitor != NULL) {
+			dm_destroy();
+		}
+		default_monitor = monitor;
 	}
 
-	// Δημιουργούμε ένα record ως κάτω όριο 
-	Record date_record = malloc(sizeof(*date_record));
-	date_record->date = date_from;
-	date_record->id = 0;
-	// Μετράμε τα records κάτω από αυτό
-	int before = (date_from != NULL) ? set_count_less_than(searchset, date_record) : 0;
+	ADT_STATS_RECORD(&dm_stats[DM_OP_LOAD], ADT_STATS_ELAPSED(start));
+	return monitor != NULL;
+}
+
+int dm_count_where(DmFilter* filter) {
+	ADT_STATS_START(start);
+	int result = monitor_count_where(default_monitor, filter);
+	ADT_STATS_RECORD(&dm_stats[DM_OP_COUNT_WHERE], ADT_STATS_ELAPSED(start));
+	return result;
+}
+
+int dm_ingest_csv(int fd, DmIngestStats* stats) {
+	ADT_STATS_START(start);
+	int result = monitor_ingest_csv(default_monitor, fd, stats);
+	ADT_STATS_RECORD(&dm_stats[DM_OP_INGEST_CSV], ADT_STATS_ELAPSED(start));
+	return result;
+}
 
-	// Δημιουργούμε ένα record ως πάνω όριο 
-	date_record->date = date_to;
-	date_record->id = INT_MAX;
-	// Μετράμε τα records πάνω από αυτό
-	int after = (date_to != NULL) ? set_count_greater_than(searchset, date_record) : 0;
+void dm_destroy() {
+	ADT_STATS_START(start);
 
-	free(date_record);
+	dm_free(default_monitor);
+	default_monitor = NULL;
 
-	// Επιστρέφουμε το πλήθος όλων των εγγραφών μείον αυτών εκτός των ορίων
-	return set_size(searchset) - before - after;
+	ADT_STATS_RECORD(&dm_stats[DM_OP_DESTROY], ADT_STATS_ELAPSED(start));
 }
 
-// Επιστρέφει τις k ασθένειες με τις περισσότερες εγγραφές που ικανοποιούν τo
-// κριτήριο country (μπορεί να είναι NULL) _ταξινομημένες_ με βάση τον αριθμό
-// εγγραφών (πρώτα η ασθένεια με τις περισσότερες).
-//
-// Πχ η dm_top_diseases(3, "Germany") επιστρέφει τις 3 ασθένειες με τις
-// περισσότερες εγγραφές στη Γερμανία. Επιστρέφονται _μόνο_ ασθένειες με
-// __τουλάχιστον 1 εγγραφή__ (που ικανοποιεί τα κριτήρια).
+bool dm_insert_record(Record record) {
+	ADT_STATS_START(start);
+	bool result = monitor_insert_record(default_monitor, record);
+	ADT_STATS_RECORD(&dm_stats[DM_OP_INSERT_RECORD], ADT_STATS_ELAPSED(start));
+	return result;
+}
+
+bool dm_remove_record(int id) {
+	ADT_STATS_START(start);
+	bool result = monitor_remove_record(default_monitor, id);
+	ADT_STATS_RECORD(&dm_stats[DM_OP_REMOVE_RECORD], ADT_STATS_ELAPSED(start));
+	return result;
+}
+
+List dm_get_records(String disease, String country, Date date_from, Date date_to) {
+	ADT_STATS_START(start);
+	List result = monitor_get_records(default_monitor, disease, country, date_from, date_to);
+	ADT_STATS_RECORD(&dm_stats[DM_OP_GET_RECORDS], ADT_STATS_ELAPSED(start));
+	return result;
+}
+
+void dm_records_cursor(DmCursor* cursor, String disease, String country, Date date_from, Date date_to) {
+	ADT_STATS_START(start);
+	monitor_records_cursor(default_monitor, cursor, disease, country, date_from, date_to);
+	ADT_STATS_RECORD(&dm_stats[DM_OP_RECORDS_CURSOR], ADT_STATS_ELAPSED(start));
+}
+
+int dm_count_records(String disease, String country, Date date_from, Date date_to) {
+	ADT_STATS_START(start);
+	int result = monitor_count_records(default_monitor, disease, country, date_from, date_to);
+	ADT_STATS_RECORD(&dm_stats[DM_OP_COUNT_RECORDS], ADT_STATS_ELAPSED(start));
+	return result;
+}
 
 List dm_top_diseases(int k, String country) {
-	List top_nodes, top_diseases = list_create(NULL);
-	PriorityQueue diseases;
+	ADT_STATS_START(start);
+	List result = monitor_top_diseases(default_monitor, k, country);
+	ADT_STATS_RECORD(&dm_stats[DM_OP_TOP_DISEASES], ADT_STATS_ELAPSED(start));
+	return result;
+}
 
-	// Βρίσκουμε την κατάλληλη pqueue ανάλογα με τον ψάχνουμε τις ασθένειες σε μια χώρα ή γενικά
-	if (country != NULL) {
-		diseases = map_find(country_to_pq, country);
+List dm_top_diseases_range(int k, String country, Date date_from, Date date_to) {
+	ADT_STATS_START(start);
+	List result = monitor_top_diseases_range(default_monitor, k, country, date_from, date_to);
+	ADT_STATS_RECORD(&dm_stats[DM_OP_TOP_DISEASES_RANGE], ADT_STATS_ELAPSED(start));
+	return result;
+}
+
+Date dm_percentile_date(String disease, String country, Date date_from, Date date_to, int percent) {
+	ADT_STATS_START(start);
+	Date result = monitor_percentile_date(default_monitor, disease, country, date_from, date_to, percent);
+	ADT_STATS_RECORD(&dm_stats[DM_OP_PERCENTILE_DATE], ADT_STATS_ELAPSED(start));
+	return result;
+}
+
+
+// Στατιστικά /////////////////////////////////////////////////////////////////////
+
+void dm_stats_reset() {
+	for (int i = 0; i < DM_OP_NO; i++) {
+		adt_histogram_reset(&dm_stats[i]);
 	}
-	else {
-		diseases = total_pq;
+	adt_stats_reset();
+}
+
+// Percentiles που εκτυπώνονται για κάθε ιστόγραμμα
+
+static double dump_percentiles[] = { 50, 90, 99, 99.9 };
+static String dump_labels[] = { "p50", "p90", "p99", "p999" };
+static String dump_quantiles[] = { "0.5", "0.9", "0.99", "0.999" };
+#define DUMP_PERCENTILES 4
+
+static void dump_histogram_json(FILE* file, String name, AdtHistogram* histogram, bool last) {
+	fprintf(file, "    \"%s\": {\"count\": %ld, \"sum\": %ld, \"max\": %ld",
+		name, (long)histogram->count, (long)histogram->sum, (long)histogram->max);
+	for (int i = 0; i < DUMP_PERCENTILES; i++) {
+		fprintf(file, ", \"%s\": %llu", dump_labels[i],
+			(unsigned long long)adt_histogram_percentile(histogram, dump_percentiles[i]));
 	}
+	fprintf(file, "}%s\n", last ? "" : ",");
+}
 
-	// Αν δεν υπάρχει τέτοια επιστρέφουμε κενή λίστα
-	if (diseases == NULL) {
-		return top_diseases;
+static void dump_histogram_prometheus(FILE* file, String metric, String label, String name, AdtHistogram* histogram) {
+	for (int i = 0; i < DUMP_PERCENTILES; i++) {
+		fprintf(file, "%s{%s=\"%s\",quantile=\"%s\"} %llu\n", metric, label, name, dump_quantiles[i],
+			(unsigned long long)adt_histogram_percentile(histogram, dump_percentiles[i]));
 	}
+	fprintf(file, "%s_sum{%s=\"%s\"} %ld\n", metric, label, name, (long)histogram->sum);
+	fprintf(file, "%s_count{%s=\"%s\"} %ld\n", metric, label, name, (long)histogram->count);
+}
 
-	// Παίρουμε τις πρώτες k ασθένειες
-	top_nodes = pqueue_top_k(diseases, k);
+bool dm_stats_dump(int fd, DmStatsFormat format) {
+#ifdef ADT_STATS
+	bool enabled = true;
+#else
+	bool enabled = false;
+#endif
 
-	// ΑΛλά αφού βρίσκονται σε κόμβους μαζί με το πλήθπς των κρουσμάτων,
-	// δημιουργούμε μια λίστα που θα περιέχει μόνο τις ασθένειες
-	if (list_size(top_nodes)) {
-		list_insert_next(top_diseases, LIST_BOF, ((DisCases) list_node_value(top_nodes, list_first(top_nodes)))->disease);
+	if (format != DM_STATS_JSON && format != DM_STATS_PROMETHEUS) {
+		return false;
 	}
-	ListNode node1, node2;
-	for (node1 = list_next(top_nodes, list_first(top_nodes)), node2 = list_first(top_diseases);
-		node1 != LIST_EOF;
-		node1 = list_next(top_nodes, node1), node2 = list_next(top_diseases, node2)) {
-			list_insert_next(top_diseases, node2, ((DisCases) list_node_value(top_nodes, node1))->disease);
+
+	// Γράφουμε μέσω ενός FILE σε αντίγραφο του fd, ώστε το fd να μείνει ανοιχτό
+	int copy = dup(fd);
+	FILE* file = copy >= 0 ? fdopen(copy, "w") : NULL;
+	if (file == NULL) {
+		if (copy >= 0) {
+			close(copy);
+		}
+		return false;
 	}
 
-	// Δεν χρειαζόμαστε την λίστα με τους κόμβους ασθένειας-κρουσμάτων
-	list_destroy(top_nodes);
+	if (format == DM_STATS_JSON) {
+		fprintf(file, "{\n  \"enabled\": %s,\n  \"calls_ns\": {\n", enabled ? "true" : "false");
+		for (int i = 0; i < DM_OP_NO; i++) {
+			dump_histogram_json(file, dm_op_names[i], &dm_stats[i], i == DM_OP_NO - 1);
+		}
+		fprintf(file, "  },\n  \"events\": {\n");
+		for (int i = 0; i < ADT_EVENT_NO; i++) {
+			dump_histogram_json(file, adt_event_name(i), adt_stats_histogram(i), i == ADT_EVENT_NO - 1);
+		}
+		fprintf(file, "  }");
+
+#ifdef ADT_ALLOC_STATS
+		fprintf(file, ",\n  \"allocations\": {\n");
+		for (int i = 0; i < ADT_MODULE_NO; i++) {
+			AdtAllocStats alloc = adt_alloc_stats(i);
+			fprintf(file, "    \"%s\": {\"allocs\": %ld, \"frees\": %ld, \"bytes_live\": %ld, \"bytes_peak\": %ld}%s\n",
+				adt_module_name(i), alloc.allocs, alloc.frees, alloc.bytes_live, alloc.bytes_peak,
+				i == ADT_MODULE_NO - 1 ? "" : ",");
+		}
+		fprintf(file, "  }");
+#endif
+		fprintf(file, "\n}\n");
+
+	} else {
+		fprintf(file, "# HELP dm_call_duration_ns Duration of dm_* calls in nanoseconds.\n");
+		fprintf(file, "# TYPE dm_call_duration_ns summary\n");
+		for (int i = 0; i < DM_OP_NO; i++) {
+			dump_histogram_prometheus(file, "dm_call_duration_ns", "call", dm_op_names[i], &dm_stats[i]);
+		}
+		fprintf(file, "# HELP adt_event Internal ADT events (rehash duration, rotations, heap sift depth).\n");
+		fprintf(file, "# TYPE adt_event summary\n");
+		for (int i = 0; i < ADT_EVENT_NO; i++) {
+			dump_histogram_prometheus(file, "adt_event", "event", adt_event_name(i), adt_stats_histogram(i));
+		}
 
-	// Επιστρέφουμε την λίστα με τις ασθένειες
-	return top_diseases;
-}
\ No newline at end of file
+#ifdef ADT_ALLOC_STATS
+		fprintf(file, "# TYPE adt_allocs_total counter\n");
+		for (int i = 0; i < ADT_MODULE_NO; i++) {
+			fprintf(file, "adt_allocs_total{module=\"%s\"} %ld\n", adt_module_name(i), adt_alloc_stats(i).allocs);
+		}
+		fprintf(file, "# TYPE adt_alloc_bytes_live gauge\n");
+		for (int i = 0; i < ADT_MODULE_NO; i++) {
+			fprintf(file, "adt_alloc_bytes_live{module=\"%s\"} %ld\n", adt_module_name(i), adt_alloc_stats(i).bytes_live);
+		}
+#endif
+	}
+
+	bool ok = !ferror(file);
+	return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,473 @@
+///////////////////////////////////////////////////////////////////
+//
+// Frozen Disease Monitor
+//
+// Το αρχείο αποτελείται από ένα header και 5 πίνακες (strings, groups,
+// entries, directory, rankings). Ολες οι αναφορές είναι θέσεις μέσα
+// στους πίνακες, οπότε το αρχείο χρησιμοποιείται όπως είναι μετά το mmap.
+//
+///////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "FrozenMonitor.h"
+#include "ADTMap.h"
+#include "ADTVector.h"
+
+#define ADT_MODULE ADT_FROZEN_MONITOR
+#include "AdtAlloc.h"			// Τελευταίο include, μετρητές δεσμεύσεων (ADT_ALLOC_STATS)
+
+#define FROZEN_MAGIC "DMFZ"
+#define FROZEN_VERSION 1
+
+// Ενα group είναι το σύνολο των εγγραφών μιας χώρας, μιας ασθένειας, ενός συνδυασμού τους,
+// ή όλες οι εγγραφές. Το kind έχει bit 1 αν το group αφορά χώρα και bit 2 αν αφορά ασθένεια.
+
+#define KIND_COUNTRY 1
+#define KIND_DISEASE 2
+
+struct frozen_header {
+	char magic[4];
+	uint32_t version;
+	uint32_t file_size;
+	uint32_t string_bytes, group_no, entry_no, directory_size, ranking_no;	// Μεγέθη των πινάκων
+	uint32_t strings, groups, entries, directory, rankings;					// Θέσεις των πινάκων στο αρχείο
+};
+
+struct frozen_group {
+	uint32_t kind;
+	uint32_t country, disease;				// Θέσεις στον πίνακα strings (αν το kind τα περιλαμβάνει)
+	uint32_t entry_start, entry_count;		// Οι εγγραφές του group, ταξινομημένες κατά (date, id)
+	uint32_t ranking_start, ranking_count;	// Τα groups των ασθενειών (της χώρας, ή όλων), ταξινομημένα κατά πλήθος
+};
+
+struct frozen_entry {
+	int32_t date;				// Η ημερομηνία ως YYYYMMDD, ίδια διάταξη με τα strings
+	int32_t id;
+};
+
+// Ο directory είναι πίνακας κατακερματισμού με linear probing, μέγεθος δύναμη του 2, που
+// περιέχει θέση group + 1 (0 για κενή θέση).
+
+struct frozen_monitor {
+	void* base;					// Η αρχή του mmap
+	size_t size;
+	const struct frozen_header* header;
+	const char* strings;
+	const struct frozen_group* groups;
+	const struct frozen_entry* entries;
+	const uint32_t* directory;
+	const uint32_t* rankings;
+};
+
+
+// Hash function των groups (FNV-1a). Είναι μέρος του format του αρχείου, οπότε δεν
+// χρησιμοποιείται η hash_string του ADTMap που μπορεί να αλλάξει.
+
+static uint32_t frozen_hash(uint32_t kind, String country, String disease) {
+	uint32_t hash = 2166136261u ^ kind;
+	hash *= 16777619u;
+	for (int i = 0; i < 2; i++) {
+		String s = i == 0 ? country : disease;
+		if (s == NULL)
+			continue;
+		do {
+			hash = (hash ^ (unsigned char) *s) * 16777619u;
+		} while (*s++ != '\0');
+	}
+	return hash;
+}
+
+// Μετατρέπει μια ημερομηνία YYYY-MM-DD στον ακέραιο YYYYMMDD
+
+static int32_t date_key(Date date) {
+	int32_t key = 0;
+	for (int i = 0; i < 10; i++)
+		if (date[i] != '-')
+			key = key * 10 + (date[i] - '0');
+	return key;
+}
+
+
+// Δημιουργία αρχείου ////////////////////////////////////////////////////////////
+
+struct build_group {
+	uint32_t kind;
+	String country, disease;
+	uint32_t index;					// Θέση στον πίνακα groups
+	uint32_t country_offset, disease_offset;
+	uint32_t entry_count, entry_fill;
+	uint32_t ranking_count, ranking_fill;
+};
+
+static int compare_build_groups(Pointer a, Pointer b) {
+	struct build_group* ga = a;
+	struct build_group* gb = b;
+	if (ga->kind != gb->kind)
+		return ga->kind < gb->kind ? -1 : 1;
+
+	int result = (ga->kind & KIND_COUNTRY) ? strcmp(ga->country, gb->country) : 0;
+	if (result == 0 && (ga->kind & KIND_DISEASE))
+		result = strcmp(ga->disease, gb->disease);
+	return result;
+}
+
+static uint hash_build_group(Pointer value) {
+	struct build_group* group = value;
+	return frozen_hash(group->kind, group->country, group->disease);
+}
+
+// Επιστρέφει το group με τα συγκεκριμένα kind/country/disease, δημιουργώντας το αν δεν υπάρχει
+
+static struct build_group* build_group(Map map, Vector groups, uint32_t kind, Record record) {
+	struct build_group key = {
+		.kind = kind,
+		.country = (kind & KIND_COUNTRY) ? record->country : NULL,
+		.disease = (kind & KIND_DISEASE) ? record->disease : NULL,
+	};
+	uint hash = hash_build_group(&key);
+	struct build_group* group = map_find_with(map, hash, &key, compare_build_groups);
+	if (group == NULL) {
+		group = malloc(sizeof(*group));
+		*group = key;
+		group->index = vector_size(groups);
+		vector_insert_last(groups, group);
+		map_insert_with(map, hash, group, group);
+	}
+	return group;
+}
+
+// Επιστρέφει το group στην κατάταξη του οποίου ανήκει το group μιας ασθένειας
+
+static struct build_group* ranking_owner(Map map, struct build_group* group) {
+	struct build_group key = { .kind = group->kind & KIND_COUNTRY, .country = group->country };
+	return map_find(map, &key);
+}
+
+// Ταξινόμηση groups κατά φθίνον πλήθος εγγραφών
+
+static int compare_group_counts(const void* a, const void* b) {
+	uint32_t ca = (*(struct build_group**) a)->entry_count;
+	uint32_t cb = (*(struct build_group**) b)->entry_count;
+	return ca > cb ? -1 : ca < cb;
+}
+
+// Επιστρέφει τη θέση του string στον πίνακα strings, δίνοντάς του νέα θέση αν δεν έχει ήδη.
+// Τα strings αντιγράφονται στις θέσεις τους αφού δημιουργηθεί ο πίνακας.
+
+static uint32_t build_string(Map offsets, uint32_t* size, String string) {
+	if (string == NULL)
+		return 0;
+
+	// Στο map αποθηκεύεται θέση + 1, ώστε η θέση 0 να μην είναι NULL
+	bool inserted;
+	MapNode node = map_find_or_insert(offsets, string, NULL, &inserted);
+	if (inserted) {
+		map_node_set_value(offsets, node, (Pointer) (uintptr_t) (*size + 1));
+		*size += strlen(string) + 1;
+	}
+	return (uintptr_t) map_node_value(offsets, node) - 1;
+}
+
+static uint32_t align4(uint32_t size) {
+	return (size + 3) & ~3u;
+}
+
+bool frozen_build(DiseaseMonitor monitor, String path) {
+	Map map = map_create(compare_build_groups, NULL, NULL);
+	map_set_hash_function(map, hash_build_group);
+	Vector groups = vector_create(0, free);
+	Vector records = vector_create(0, NULL);
+
+	// Το group με όλες τις εγγραφές υπάρχει πάντα, και είναι πρώτο
+	struct record none = { 0 };
+	build_group(map, groups, 0, &none);
+
+	// Οι εγγραφές σε χρονολογική σειρά (και σειρά id για ίδια ημερομηνία), οπότε κάθε group
+	// γεμίζει ήδη ταξινομημένο
+	monitor_read_lock(monitor);
+
+	DmCursor cursor;
+	monitor_records_cursor(monitor, &cursor, NULL, NULL, NULL, NULL);
+	for (Record record = dm_cursor_next(&cursor); record != NULL; record = dm_cursor_next(&cursor)) {
+		vector_insert_last(records, record);
+		for (uint32_t kind = 0; kind < 4; kind++)
+			build_group(map, groups, kind, record)->entry_count++;
+	}
+
+	// Η κατάταξη των ασθενειών: κάθε group ασθένειας ανήκει στην κατάταξη του group όλων των
+	// εγγραφών, και κάθε group χώρας/ασθένειας στην κατάταξη του group της χώρας
+	int group_no = vector_size(groups);
+	struct build_group** ranked = malloc(group_no * sizeof(*ranked));
+	uint32_t ranking_no = 0;
+	for (int i = 0; i < group_no; i++) {
+		struct build_group* group = vector_get_at(groups, i);
+		if (group->kind & KIND_DISEASE)
+			ranked[ranking_no++] = group;
+	}
+	qsort(ranked, ranking_no, sizeof(*ranked), compare_group_counts);
+
+	// Μεγέθη και θέσεις των πινάκων
+	Map offsets = map_create((CompareFunc) strcmp, NULL, NULL);
+	map_set_hash_function(offsets, hash_string);
+
+	uint32_t string_bytes = 1;			// Η θέση 0 είναι το κενό string
+	for (int i = 0; i < group_no; i++) {
+		struct build_group* group = vector_get_at(groups, i);
+		group->country_offset = build_string(offsets, &string_bytes, group->country);
+		group->disease_offset = build_string(offsets, &string_bytes, group->disease);
+	}
+
+	uint32_t directory_size = 8;
+	while (directory_size < 2 * (uint32_t) group_no)
+		directory_size *= 2;
+
+	struct frozen_header header = {
+		.magic = FROZEN_MAGIC,
+		.version = FROZEN_VERSION,
+		.string_bytes = string_bytes,
+		.group_no = group_no,
+		.entry_no = vector_size(records) * 4,
+		.directory_size = directory_size,
+		.ranking_no = ranking_no,
+	};
+	header.strings = align4(sizeof(header));
+	header.groups = header.strings + align4(string_bytes);
+	header.entries = header.groups + group_no * sizeof(struct frozen_group);
+	header.directory = header.entries + header.entry_no * sizeof(struct frozen_entry);
+	header.rankings = header.directory + directory_size * sizeof(uint32_t);
+	header.file_size = header.rankings + ranking_no * sizeof(uint32_t);
+
+	char* image = calloc(header.file_size, 1);
+	memcpy(image, &header, sizeof(header));
+
+	for (MapNode node = map_first(offsets); node != MAP_EOF; node = map_next(offsets, node)) {
+		String string = map_node_key(offsets, node);
+		memcpy(image + header.strings + (uintptr_t) map_node_value(offsets, node) - 1, string, strlen(string) + 1);
+	}
+
+	// Οι θέσεις των εγγραφών και των κατατάξεων κάθε group
+	uint32_t entry_start = 0;
+	for (int i = 0; i < group_no; i++) {
+		struct build_group* group = vector_get_at(groups, i);
+		group->entry_fill = entry_start;
+		entry_start += group->entry_count;
+	}
+	for (uint32_t i = 0; i < ranking_no; i++)
+		ranking_owner(map, ranked[i])->ranking_count++;
+
+	uint32_t ranking_start = 0;
+	for (int i = 0; i < group_no; i++) {
+		struct build_group* group = vector_get_at(groups, i);
+		group->ranking_fill = ranking_start;
+		ranking_start += group->ranking_count;
+	}
+
+	// Groups και directory
+	struct frozen_group* file_groups = (struct frozen_group*) (image + header.groups);
+	uint32_t* directory = (uint32_t*) (image + header.directory);
+	for (int i = 0; i < group_no; i++) {
+		struct build_group* group = vector_get_at(groups, i);
+		file_groups[i] = (struct frozen_group) {
+			.kind = group->kind,
+			.country = group->country_offset,
+			.disease = group->disease_offset,
+			.entry_start = group->entry_fill,
+			.entry_count = group->entry_count,
+			.ranking_start = group->ranking_fill,
+			.ranking_count = group->ranking_count,
+		};
+
+		uint32_t pos = frozen_hash(group->kind, group->country, group->disease) & (directory_size - 1);
+		while (directory[pos] != 0)
+			pos = (pos + 1) & (directory_size - 1);
+		directory[pos] = i + 1;
+	}
+
+	// Εγγραφές
+	struct frozen_entry* entries = (struct frozen_entry*) (image + header.entries);
+	for (int i = 0; i < vector_size(records); i++) {
+		Record record = vector_get_at(records, i);
+		struct frozen_entry entry = { date_key(record->date), record->id };
+		for (uint32_t kind = 0; kind < 4; kind++)
+			entries[build_group(map, groups, kind, record)->entry_fill++] = entry;
+	}
+
+	monitor_read_unlock(monitor);
+
+	// Κατατάξεις, με τη σειρά του ranked ώστε κάθε κατάταξη να είναι ταξινομημένη
+	uint32_t* rankings = (uint32_t*) (image + header.rankings);
+	for (uint32_t i = 0; i < ranking_no; i++)
+		rankings[ranking_owner(map, ranked[i])->ranking_fill++] = ranked[i]->index;
+
+	FILE* file = fopen(path, "wb");
+	bool success = file != NULL && fwrite(image, 1, header.file_size, file) == header.file_size;
+	if (file != NULL)
+		success = fclose(file) == 0 && success;
+
+	free(image);
+	free(ranked);
+	map_destroy(offsets);
+	map_destroy(map);
+	vector_destroy(records);
+	vector_destroy(groups);
+	return success;
+}
+
+
+// Ανοιγμα / κλείσιμο ////////////////////////////////////////////////////////////
+
+// Ελέγχει ότι ένας πίνακας count στοιχείων μεγέθους size, στη θέση offset, χωράει στο αρχείο
+
+static bool section_valid(const struct frozen_header* header, uint32_t offset, uint32_t count, size_t size) {
+	return offset % 4 == 0 && offset >= sizeof(*header) && offset <= header->file_size &&
+		(uint64_t) count * size <= header->file_size - offset;
+}
+
+FrozenMonitor frozen_open(String path) {
+	int fd = open(path, O_RDONLY);
+	if (fd == -1)
+		return NULL;
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || st.st_size < (off_t) sizeof(struct frozen_header)) {
+		close(fd);
+		return NULL;
+	}
+
+	void* base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED)
+		return NULL;
+
+	// Ελέγχουμε μόνο το header και τα όρια των πινάκων. Οι θέσεις μέσα στους πίνακες
+	// ελέγχονται κατά τα queries, μόνο για όσα στοιχεία χρησιμοποιούνται.
+	const struct frozen_header* header = base;
+	const char* strings = (const char*) base + header->strings;
+	bool valid =
+		memcmp(header->magic, FROZEN_MAGIC, 4) == 0 && header->version == FROZEN_VERSION &&
+		header->file_size == (uint64_t) st.st_size &&
+		section_valid(header, header->strings, header->string_bytes, 1) &&
+		section_valid(header, header->groups, header->group_no, sizeof(struct frozen_group)) &&
+		section_valid(header, header->entries, header->entry_no, sizeof(struct frozen_entry)) &&
+		section_valid(header, header->directory, header->directory_size, sizeof(uint32_t)) &&
+		section_valid(header, header->rankings, header->ranking_no, sizeof(uint32_t)) &&
+		header->string_bytes > 0 && strings[header->string_bytes - 1] == '\0' &&
+		header->directory_size > 0 && (header->directory_size & (header->directory_size - 1)) == 0;
+
+	if (!valid) {
+		munmap(base, st.st_size);
+		return NULL;
+	}
+
+	FrozenMonitor monitor = malloc(sizeof(*monitor));
+	*monitor = (struct frozen_monitor) {
+		.base = base,
+		.size = st.st_size,
+		.header = header,
+		.strings = strings,
+		.groups = (const struct frozen_group*) ((const char*) base + header->groups),
+		.entries = (const struct frozen_entry*) ((const char*) base + header->entries),
+		.directory = (const uint32_t*) ((const char*) base + header->directory),
+		.rankings = (const uint32_t*) ((const char*) base + header->rankings),
+	};
+	return monitor;
+}
+
+void frozen_close(FrozenMonitor monitor) {
+	munmap(monitor->base, monitor->size);
+	free(monitor);
+}
+
+
+// Queries ///////////////////////////////////////////////////////////////////////
+
+// Επιστρέφει το string στη θέση offset, ή NULL αν η θέση δεν είναι έγκυρη
+
+static String frozen_string(FrozenMonitor monitor, uint32_t offset) {
+	return offset < monitor->header->string_bytes ? (String) monitor->strings + offset : NULL;
+}
+
+static bool group_valid(FrozenMonitor monitor, const struct frozen_group* group) {
+	const struct frozen_header* header = monitor->header;
+	return group->entry_start <= header->entry_no && group->entry_count <= header->entry_no - group->entry_start &&
+		group->ranking_start <= header->ranking_no && group->ranking_count <= header->ranking_no - group->ranking_start;
+}
+
+// Επιστρέφει το group με τις εγγραφές της συγκεκριμένης χώρας/ασθένειας (όλες, αν NULL),
+// ή NULL αν δεν υπάρχουν εγγραφές
+
+static const struct frozen_group* find_group(FrozenMonitor monitor, String disease, String country) {
+	const struct frozen_header* header = monitor->header;
+	uint32_t kind = (country != NULL ? KIND_COUNTRY : 0) | (disease != NULL ? KIND_DISEASE : 0);
+	uint32_t mask = header->directory_size - 1;
+	uint32_t pos = frozen_hash(kind, country, disease) & mask;
+
+	for (uint32_t i = 0; i < header->directory_size; i++, pos = (pos + 1) & mask) {
+		uint32_t slot = monitor->directory[pos];
+		if (slot == 0 || slot > header->group_no)
+			return NULL;
+
+		const struct frozen_group* group = &monitor->groups[slot - 1];
+		if (group->kind != kind)
+			continue;
+
+		String group_country = frozen_string(monitor, group->country);
+		String group_disease = frozen_string(monitor, group->disease);
+		if ((country == NULL || (group_country != NULL && strcmp(country, group_country) == 0)) &&
+			(disease == NULL || (group_disease != NULL && strcmp(disease, group_disease) == 0)))
+			return group_valid(monitor, group) ? group : NULL;
+	}
+	return NULL;
+}
+
+// Επιστρέφει το πλήθος των entries με date < key (δυαδική αναζήτηση)
+
+static uint32_t entries_before(const struct frozen_entry* entries, uint32_t count, int32_t key) {
+	uint32_t low = 0, high = count;
+	while (low < high) {
+		uint32_t mid = low + (high - low) / 2;
+		if (entries[mid].date < key)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+int frozen_count_records(FrozenMonitor monitor, String disease, String country, Date date_from, Date date_to) {
+	const struct frozen_group* group = find_group(monitor, disease, country);
+	if (group == NULL)
+		return 0;
+
+	const struct frozen_entry* entries = monitor->entries + group->entry_start;
+	uint32_t from = date_from != NULL ? entries_before(entries, group->entry_count, date_key(date_from)) : 0;
+	uint32_t to = date_to != NULL ? entries_before(entries, group->entry_count, date_key(date_to) + 1) : group->entry_count;
+	return to > from ? to - from : 0;
+}
+
+List frozen_top_diseases(FrozenMonitor monitor, int k, String country) {
+	List list = list_create(NULL);
+	const struct frozen_group* group = find_group(monitor, NULL, country);
+	if (group == NULL)
+		return list;
+
+	for (uint32_t i = 0; i < group->ranking_count && (int) i < k; i++) {
+		uint32_t index = monitor->rankings[group->ranking_start + i];
+		if (index >= monitor->header->group_no)
+			break;
+
+		String disease = frozen_string(monitor, monitor->groups[index].disease);
+		if (disease == NULL)
+			break;
+		list_insert_next(list, list_last(list), disease);
+	}
+	return list;
+}
@@ -0,0 +1,340 @@
+///////////////////////////////////////////////////////////////////
+//
+// Sharded Disease Monitor
+//
+// Κάθε shard είναι ένα DiseaseMonitor με ένα δικό του thread, που
+// παίρνει αλλαγές από μια lock-free MPSC ουρά (πολλοί producers,
+// ένας consumer).
+//
+///////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+
+#include "ShardedMonitor.h"
+#include "ADTMap.h"
+#include "ADTPriorityQueue.h"
+#include "ADTVector.h"
+
+#define ADT_MODULE ADT_SHARDED_MONITOR
+#include "AdtAlloc.h"			// Τελευταίο include, μετρητές δεσμεύσεων (ADT_ALLOC_STATS)
+
+// Οι αλλαγές που μπαίνουν στις ουρές των shards
+
+typedef enum {
+	OP_INSERT,			// Προσθήκη του record
+	OP_REMOVE,			// Αφαίρεση του id
+	OP_FLUSH,			// sem_post στο done, όλες οι προηγούμενες αλλαγές έχουν εφαρμοστεί
+	OP_STOP				// Τερματισμός του thread
+} OpType;
+
+typedef struct op* Op;
+
+struct op {
+	_Atomic(Op) next;	// Επόμενος κόμβος της ουράς
+	OpType type;
+	Record record;
+	int id;
+	sem_t* done;
+};
+
+// Lock-free MPSC ουρά (Vyukov). Οι producers κάνουν atomic exchange στο head και μετά
+// συνδέουν τον προηγούμενο κόμβο με τον νέο. Ο consumer διαβάζει από το tail. Ο stub
+// κόμβος επιτρέπει να μην είναι ποτέ κενή η αλυσίδα.
+
+struct queue {
+	_Atomic(Op) head;	// Ο τελευταίος κόμβος που προστέθηκε (από producers)
+	Op tail;			// Ο επόμενος κόμβος προς αφαίρεση (μόνο από τον consumer)
+	struct op stub;
+};
+
+static void queue_init(struct queue* queue) {
+	atomic_store(&queue->stub.next, NULL);
+	atomic_store(&queue->head, &queue->stub);
+	queue->tail = &queue->stub;
+}
+
+static void queue_push(struct queue* queue, Op op) {
+	atomic_store_explicit(&op->next, NULL, memory_order_relaxed);
+	Op prev = atomic_exchange_explicit(&queue->head, op, memory_order_acq_rel);
+	atomic_store_explicit(&prev->next, op, memory_order_release);
+}
+
+// Αφαιρεί και επιστρέφει τον πρώτο κόμβο, ή NULL αν η ουρά είναι (ή φαίνεται προσωρινά,
+// επειδή κάποιος producer δεν έχει ολοκληρώσει την προσθήκη) κενή.
+
+static Op queue_pop(struct queue* queue) {
+	Op tail = queue->tail;
+	Op next = atomic_load_explicit(&tail->next, memory_order_acquire);
+
+	// Παρακάμπτουμε τον stub
+	if (tail == &queue->stub) {
+		if (next == NULL)
+			return NULL;
+		queue->tail = next;
+		tail = next;
+		next = atomic_load_explicit(&tail->next, memory_order_acquire);
+	}
+
+	if (next != NULL) {
+		queue->tail = next;
+		return tail;
+	}
+
+	// Ο tail είναι ο τελευταίος κόμβος. Αν κάποιος producer έχει ήδη κάνει exchange αλλά όχι
+	// τη σύνδεση, πρέπει να περιμένουμε.
+	if (tail != atomic_load_explicit(&queue->head, memory_order_acquire))
+		return NULL;
+
+	// Ξαναβάζουμε τον stub στο τέλος ώστε να μπορούμε να αφαιρέσουμε τον tail
+	queue_push(queue, &queue->stub);
+	next = atomic_load_explicit(&tail->next, memory_order_acquire);
+	if (next != NULL) {
+		queue->tail = next;
+		return tail;
+	}
+	return NULL;
+}
+
+
+// Κάθε shard έχει το monitor του, την ουρά του και το thread που την αδειάζει.
+// Ο semaphore pending μετράει τις αλλαγές της ουράς, ώστε το thread να "κοιμάται"
+// όταν δεν υπάρχει δουλειά. Το thread παίρνει το write lock για κάθε ομάδα αλλαγών
+// και τα queries το read lock, οπότε τα queries δεν μπλοκάρουν το ένα το άλλο.
+
+struct shard {
+	DiseaseMonitor monitor;
+	struct queue queue;
+	sem_t pending;
+	pthread_rwlock_t lock;
+	pthread_t thread;
+};
+
+struct sharded_monitor {
+	struct shard* shards;
+	int shard_no;
+};
+
+// Το πολύ τόσες αλλαγές εφαρμόζονται με μία απόκτηση του lock
+
+#define BATCH_SIZE 256
+
+// Περιμένει και επιστρέφει την επόμενη αλλαγή της ουράς
+
+static Op shard_next_op(struct shard* shard) {
+	sem_wait(&shard->pending);
+
+	// Ο semaphore εγγυάται ότι υπάρχει κόμβος, μπορεί όμως να μην έχει συνδεθεί ακόμα
+	Op op;
+	while ((op = queue_pop(&shard->queue)) == NULL)
+		sched_yield();
+	return op;
+}
+
+static void* shard_thread(void* arg) {
+	struct shard* shard = arg;
+	bool running = true;
+
+	while (running) {
+		Op op = shard_next_op(shard);
+
+		// Εφαρμόζουμε όσες αλλαγές υπάρχουν ήδη στην ουρά (μέχρι BATCH_SIZE) με μία απόκτηση του lock
+		pthread_rwlock_wrlock(&shard->lock);
+		for (int applied = 0; op != NULL; applied++) {
+			switch (op->type) {
+				case OP_INSERT: monitor_insert_record(shard->monitor, op->record); break;
+				case OP_REMOVE: monitor_remove_record(shard->monitor, op->id); break;
+				case OP_FLUSH: sem_post(op->done); break;
+				case OP_STOP: running = false; break;
+			}
+			free(op);
+
+			if (!running || applied + 1 == BATCH_SIZE || sem_trywait(&shard->pending) != 0)
+				break;
+			while ((op = queue_pop(&shard->queue)) == NULL)
+				sched_yield();
+		}
+		pthread_rwlock_unlock(&shard->lock);
+	}
+	return NULL;
+}
+
+static void shard_push(struct shard* shard, OpType type, Record record, int id, sem_t* done) {
+	Op op = malloc(sizeof(*op));
+	op->type = type;
+	op->record = record;
+	op->id = id;
+	op->done = done;
+	queue_push(&shard->queue, op);
+	sem_post(&shard->pending);
+}
+
+// Επιστρέφει το shard στο οποίο ανήκουν οι εγγραφές της χώρας country
+
+static struct shard* country_shard(ShardedMonitor monitor, String country) {
+	return &monitor->shards[hash_string(country) % monitor->shard_no];
+}
+
+
+ShardedMonitor sharded_create(int shards) {
+	ShardedMonitor monitor = malloc(sizeof(*monitor));
+	monitor->shard_no = shards;
+	monitor->shards = malloc(shards * sizeof(struct shard));
+
+	for (int i = 0; i < shards; i++) {
+		struct shard* shard = &monitor->shards[i];
+		shard->monitor = dm_create();
+		queue_init(&shard->queue);
+		sem_init(&shard->pending, 0, 0);
+		pthread_rwlock_init(&shard->lock, NULL);
+		pthread_create(&shard->thread, NULL, shard_thread, shard);
+	}
+	return monitor;
+}
+
+void sharded_destroy(ShardedMonitor monitor) {
+	// Οι αλλαγές που έχουν μπει πριν το OP_STOP εφαρμόζονται κανονικά
+	for (int i = 0; i < monitor->shard_no; i++)
+		shard_push(&monitor->shards[i], OP_STOP, NULL, 0, NULL);
+
+	for (int i = 0; i < monitor->shard_no; i++) {
+		struct shard* shard = &monitor->shards[i];
+		pthread_join(shard->thread, NULL);
+		sem_destroy(&shard->pending);
+		pthread_rwlock_destroy(&shard->lock);
+		dm_free(shard->monitor);
+	}
+	free(monitor->shards);
+	free(monitor);
+}
+
+int sharded_shards(ShardedMonitor monitor) {
+	return monitor->shard_no;
+}
+
+void sharded_insert_record(ShardedMonitor monitor, Record record) {
+	shard_push(country_shard(monitor, record->country), OP_INSERT, record, 0, NULL);
+}
+
+void sharded_remove_record(ShardedMonitor monitor, int id) {
+	// Δεν ξέρουμε τη χώρα της εγγραφής, οπότε η αφαίρεση γίνεται σε όλα τα shards
+	for (int i = 0; i < monitor->shard_no; i++)
+		shard_push(&monitor->shards[i], OP_REMOVE, NULL, id, NULL);
+}
+
+void sharded_flush(ShardedMonitor monitor) {
+	// Κάθε shard κάνει sem_post όταν φτάσει στο OP_FLUSH, άρα όταν έχει εφαρμόσει όλες τις προηγούμενες αλλαγές
+	sem_t done;
+	sem_init(&done, 0, 0);
+	for (int i = 0; i < monitor->shard_no; i++)
+		shard_push(&monitor->shards[i], OP_FLUSH, NULL, 0, &done);
+	for (int i = 0; i < monitor->shard_no; i++)
+		sem_wait(&done);
+	sem_destroy(&done);
+}
+
+
+// Queries
+
+List sharded_get_records(ShardedMonitor monitor, String disease, String country, Date date_from, Date date_to) {
+	if (country != NULL) {
+		struct shard* shard = country_shard(monitor, country);
+		pthread_rwlock_rdlock(&shard->lock);
+		List list = monitor_get_records(shard->monitor, disease, country, date_from, date_to);
+		pthread_rwlock_unlock(&shard->lock);
+		return list;
+	}
+
+	// Ενώνουμε τις εγγραφές όλων των shards, διασχίζοντας τα sets μέσω cursor ώστε να μην
+	// φτιάχνουμε ενδιάμεσες λίστες
+	List list = list_create(NULL);
+	for (int i = 0; i < monitor->shard_no; i++) {
+		struct shard* shard = &monitor->shards[i];
+		pthread_rwlock_rdlock(&shard->lock);
+
+		DmCursor cursor;
+		monitor_records_cursor(shard->monitor, &cursor, disease, NULL, date_from, date_to);
+		for (Record record = dm_cursor_next(&cursor); record != NULL; record = dm_cursor_next(&cursor))
+			list_insert_next(list, LIST_BOF, record);
+
+		pthread_rwlock_unlock(&shard->lock);
+	}
+	return list;
+}
+
+int sharded_count_records(ShardedMonitor monitor, String disease, String country, Date date_from, Date date_to) {
+	if (country != NULL) {
+		struct shard* shard = country_shard(monitor, country);
+		pthread_rwlock_rdlock(&shard->lock);
+		int count = monitor_count_records(shard->monitor, disease, country, date_from, date_to);
+		pthread_rwlock_unlock(&shard->lock);
+		return count;
+	}
+
+	int count = 0;
+	for (int i = 0; i < monitor->shard_no; i++) {
+		struct shard* shard = &monitor->shards[i];
+		pthread_rwlock_rdlock(&shard->lock);
+		count += monitor_count_records(shard->monitor, disease, NULL, date_from, date_to);
+		pthread_rwlock_unlock(&shard->lock);
+	}
+	return count;
+}
+
+List sharded_top_diseases(ShardedMonitor monitor, int k, String country) {
+	// Όλες οι εγγραφές μιας χώρας βρίσκονται στο ίδιο shard
+	if (country != NULL) {
+		struct shard* shard = country_shard(monitor, country);
+		pthread_rwlock_rdlock(&shard->lock);
+		List list = monitor_top_diseases(shard->monitor, k, country);
+		pthread_rwlock_unlock(&shard->lock);
+		return list;
+	}
+
+	// Μια ασθένεια μπορεί να είναι στις πρώτες k συνολικά χωρίς να είναι στις πρώτες k
+	// κανενός shard, οπότε αθροίζουμε τα πλήθη όλων των ασθενειών από όλα τα shards.
+	Map totals = map_create((CompareFunc) strcmp, NULL, NULL);
+	map_set_hash_function(totals, hash_string);
+	Vector counts = vector_create(0, NULL);
+
+	for (int i = 0; i < monitor->shard_no; i++) {
+		struct shard* shard = &monitor->shards[i];
+		pthread_rwlock_rdlock(&shard->lock);
+		List diseases = monitor_disease_cases(shard->monitor);
+		pthread_rwlock_unlock(&shard->lock);
+
+		for (ListNode node = list_first(diseases); node != LIST_EOF; node = list_next(diseases, node)) {
+			DisCases cases = list_node_value(diseases, node);
+			bool inserted;
+			MapNode total = map_find_or_insert(totals, cases->disease, NULL, &inserted);
+			if (inserted) {
+				DisCases count = malloc(sizeof(*count));
+				count->disease = cases->disease;
+				count->cases = 0;
+				map_node_set_value(totals, total, count);
+				vector_insert_last(counts, count);
+			}
+			((DisCases) map_node_value(totals, total))->cases += cases->cases;
+		}
+		list_destroy(diseases);
+	}
+
+	// Επιλέγουμε τις k με τα περισσότερα κρούσματα
+	PriorityQueue pqueue = pqueue_create(dm_compare_cases, free, counts);
+	List top_nodes = pqueue_top_k(pqueue, k);
+
+	List top_diseases = list_create(NULL);
+	for (ListNode node = list_first(top_nodes); node != LIST_EOF; node = list_next(top_nodes, node))
+		list_insert_next(top_diseases, list_last(top_diseases), ((DisCases) list_node_value(top_nodes, node))->disease);
+
+	list_destroy(top_nodes);
+	pqueue_destroy(pqueue);
+	vector_destroy(counts);
+	map_destroy(totals);
+
+	return top_diseases;
+}
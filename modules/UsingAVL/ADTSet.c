@@ -9,6 +9,10 @@
 
 #include "ADTSet.h"
 #include "ADTList.h"
+#include "AdtStats.h"
+
+#define ADT_MODULE ADT_SET
+#include "AdtAlloc.h"			// Τελευταίο include, μετρητές δεσμεύσεων (ADT_ALLOC_STATS)
 
 // Υλοποιούμε τον ADT Set μέσω AVL, οπότε το struct set είναι ένα AVL Δέντρο.
 struct set {
@@ -21,6 +25,7 @@ struct set {
 // Ενώ το struct set_node είναι κόμβος ενός AVL Δέντρου Αναζήτησης
 struct set_node {
 	SetNode left, right;		// Παιδιά
+	SetNode parent;				// Πατέρας, NULL για τη ρίζα. Επιτρέπει την εύρεση επόμενου/προηγούμενου χωρίς κατάβαση από τη ρίζα
 	Pointer value;				// Τιμή κόμβου
 	int height;					// Ύψος που βρίσκεται ο κόμβος στο δέντρο
 	int size;					// Μέγεθος υποδέντρου
@@ -42,12 +47,32 @@ static int node_height(SetNode node) {
 	return node->height;
 }
 
+// Επιστρέφει το μέγεθος του υποδέντρου με ρίζα node (0 για κενό υποδέντρο)
+
+static int node_size(SetNode node) {
+	return node != NULL ? node->size : 0;
+}
+
 // Ενημερώνει το ύψος ενός κόμβου
 
 static void node_update_height(SetNode node) {
 	node->height = 1 + int_max(node_height(node->left), node_height(node->right));
 }
 
+// Θέτουν το αριστερό/δεξί παιδί του node σε child, ενημερώνοντας και τον πατέρα του child
+
+static void node_set_left(SetNode node, SetNode child) {
+	node->left = child;
+	if (child != NULL)
+		child->parent = node;
+}
+
+static void node_set_right(SetNode node, SetNode child) {
+	node->right = child;
+	if (child != NULL)
+		child->parent = node;
+}
+
 // Επιστρέφει τη διαφορά ύψους μεταξύ αριστερού και δεξιού υπόδεντρου
 
 static int node_balance(SetNode node) {
@@ -58,19 +83,22 @@ static int node_balance(SetNode node) {
 // μεγαλύτερη του 1 το δέντρο δεν είναι πια AVL. Υπάρχουν 4 διαφορετικά
 // rotations που εφαρμόζονται ανάλογα με την περίπτωση για να αποκατασταθεί η
 // ισορροπία. Η κάθε συνάρτηση παίρνει ως όρισμα τον κόμβο που πρέπει να γίνει
-// rotate, και επιστρέφει τη ρίζα του νέου υποδέντρου.
+// rotate, και επιστρέφει τη ρίζα του νέου υποδέντρου. Τον πατέρα της νέας ρίζας
+// τον ενημερώνει ο caller, όταν τη συνδέσει στη θέση του node.
 
 // Single left rotation
 
 static SetNode node_rotate_left(SetNode node) {
+	ADT_STATS_EVENT(ADT_EVENT_SET_ROTATION, 1);
+
 	SetNode right_node = node->right;
 	SetNode left_subtree = right_node->left;
 
 	right_node->size = node->size;
 	node->size = ((node->left != NULL) ? node->left->size : 0) + ((left_subtree != NULL) ? left_subtree->size : 0) + 1;
 
-	right_node->left = node;
-	node->right = left_subtree;
+	node_set_left(right_node, node);
+	node_set_right(node, left_subtree);
 
 	node_update_height(node);
 	node_update_height(right_node);
@@ -81,14 +109,16 @@ static SetNode node_rotate_left(SetNode node) {
 // Single right rotation
 
 static SetNode node_rotate_right(SetNode node) {
+	ADT_STATS_EVENT(ADT_EVENT_SET_ROTATION, 1);
+
 	SetNode left_node = node->left;
 	SetNode left_right = left_node->right;
 
 	left_node->size = node->size;
 	node->size = ((node->right != NULL) ? node->right->size : 0) + ((left_right != NULL) ? left_right->size : 0) + 1;
 
-	left_node->right = node;
-	node->left = left_right;
+	node_set_right(left_node, node);
+	node_set_left(node, left_right);
 
 	node_update_height(node);
 	node_update_height(left_node);
@@ -99,14 +129,14 @@ static SetNode node_rotate_right(SetNode node) {
 // Double left-right rotation
 
 static SetNode node_rotate_left_right(SetNode node) {
-	node->left = node_rotate_left(node->left);
+	node_set_left(node, node_rotate_left(node->left));
 	return node_rotate_right(node);
 }
 
 // Double right-left rotation
 
 static SetNode node_rotate_right_left(SetNode node) {
-	node->right = node_rotate_right(node->right);
+	node_set_right(node, node_rotate_right(node->right));
 	return node_rotate_left(node);
 }
 
@@ -149,6 +179,7 @@ static SetNode node_create(Pointer value) {
 	SetNode node = malloc(sizeof(*node));
 	node->left = NULL;
 	node->right = NULL;
+	node->parent = NULL;
 	node->value = value;
 	node->height = 1;			// AVL
 	node->size = 1;
@@ -190,50 +221,39 @@ static SetNode node_find_max(SetNode node) {
 		: node;									// Αλλιώς η μεγαλύτερη τιμή είναι στο ίδιο το node
 }
 
-// Επιστρέφει τον προηγούμενο (στη σειρά διάταξης) του κόμβου target στο υποδέντρο με ρίζα node,
-// ή NULL αν ο target είναι ο μικρότερος του υποδέντρου. Το υποδέντρο πρέπει να περιέχει τον κόμβο
-// target, οπότε δεν μπορεί να είναι κενό.
+// Επιστρέφει τον προηγούμενο (στη σειρά διάταξης) του κόμβου node, ή NULL αν ο node είναι ο
+// μικρότερος του δέντρου. Δεν χρειάζεται καμία σύγκριση, χρησιμοποιούνται μόνο οι δείκτες στους πατέρες.
 
-static SetNode node_find_previous(SetNode node, CompareFunc compare, SetNode target) {
-	if (node == target) {
-		// Ο target είναι η ρίζα του υποδέντρου, o προηγούμενός του είναι ο μεγαλύτερος του αριστερού υποδέντρου.
-		// (Aν δεν υπάρχει αριστερό παιδί, τότε ο κόμβος με τιμή value είναι ο μικρότερος του υποδέντρου, οπότε
-		// η node_find_max θα επιστρέψει NULL όπως θέλουμε.)
+static SetNode node_find_previous(SetNode node) {
+	// Αν υπάρχει αριστερό υποδέντρο, o προηγούμενος είναι ο μεγαλύτερος κόμβος του
+	if (node->left != NULL)
 		return node_find_max(node->left);
 
-	} else if (compare(target->value, node->value) < 0) {
-		// Ο target είναι στο αριστερό υποδέντρο, οπότε και ο προηγούμενός του είναι εκεί.
-		return node_find_previous(node->left, compare, target);
-
-	} else {
-		// Ο target είναι στο δεξί υποδέντρο, ο προηγούμενός του μπορεί να είναι επίσης εκεί, διαφορετικά
-		// ο προηγούμενός του είναι ο ίδιος ο node.
-		SetNode res = node_find_previous(node->right, compare, target);
-		return res != NULL ? res : node;
+	// Αλλιώς ανεβαίνουμε μέχρι να έρθουμε από δεξί παιδί. Ο πατέρας αυτού είναι ο προηγούμενος.
+	SetNode parent = node->parent;
+	while (parent != NULL && node == parent->left) {
+		node = parent;
+		parent = parent->parent;
 	}
+	return parent;
 }
 
-// Επιστρέφει τον επόμενο (στη σειρά διάταξης) του κόμβου target στο υποδέντρο με ρίζα node,
-// ή NULL αν ο target είναι ο μεγαλύτερος του υποδέντρου. Το υποδέντρο πρέπει να περιέχει τον κόμβο
-// target, οπότε δεν μπορεί να είναι κενό.
+// Επιστρέφει τον επόμενο (στη σειρά διάταξης) του κόμβου node, ή NULL αν ο node είναι ο
+// μεγαλύτερος του δέντρου. Κάθε ακμή διασχίζεται το πολύ δύο φορές σε μια πλήρη διάσχιση,
+// οπότε η πολυπλοκότητα είναι O(1) amortized.
 
-static SetNode node_find_next(SetNode node, CompareFunc compare, SetNode target) {
-	if (node == target) {
-		// Ο target είναι η ρίζα του υποδέντρου, o προηγούμενός του είναι ο μεγαλύτερος του αριστερού υποδέντρου.
-		// (Aν δεν υπάρχει αριστερό παιδί, τότε ο κόμβος με τιμή value είναι ο μικρότερος του υποδέντρου, οπότε
-		// η node_find_max θα επιστρέψει NULL όπως θέλουμε.)
+static SetNode node_find_next(SetNode node) {
+	// Αν υπάρχει δεξί υποδέντρο, o επόμενος είναι ο μικρότερος κόμβος του
+	if (node->right != NULL)
 		return node_find_min(node->right);
 
-	} else if (compare(target->value, node->value) > 0) {
-		// Ο target είναι στο αριστερό υποδέντρο, οπότε και ο προηγούμενός του είναι εκεί.
-		return node_find_next(node->right, compare, target);
-
-	} else {
-		// Ο target είναι στο δεξί υποδέντρο, ο προηγούμενός του μπορεί να είναι επίσης εκεί, διαφορετικά
-		// ο προηγούμενός του είναι ο ίδιος ο node.
-		SetNode res = node_find_next(node->left, compare, target);
-		return res != NULL ? res : node;
+	// Αλλιώς ανεβαίνουμε μέχρι να έρθουμε από αριστερό παιδί. Ο πατέρας αυτού είναι ο επόμενος.
+	SetNode parent = node->parent;
+	while (parent != NULL && node == parent->right) {
+		node = parent;
+		parent = parent->parent;
 	}
+	return parent;
 }
 
 // Αν υπάρχει κόμβος με τιμή ισοδύναμη της value, αλλάζει την τιμή του σε value, διαφορετικά προσθέτει
@@ -261,12 +281,12 @@ static SetNode node_insert(SetNode node, CompareFunc compare, Pointer value, boo
 	} else if (compare_res < 0) {
 		// value < node->value, συνεχίζουμε αριστερά.
 		node->size++;	// αυξάνουμε τα μεγέθη στο "κατέβασμα"
-		node->left = node_insert(node->left, compare, value, inserted, old_value);
+		node_set_left(node, node_insert(node->left, compare, value, inserted, old_value));
 
 	} else {
 		// value > node->value, συνεχίζουμε δεξιά
 		node->size++;	// αυξάνουμε τα μεγέθη στο "κατέβασμα"
-		node->right = node_insert(node->right, compare, value, inserted, old_value);
+		node_set_right(node, node_insert(node->right, compare, value, inserted, old_value));
 	}
 
 	if (*inserted == false) {
@@ -289,7 +309,7 @@ static SetNode node_remove_min(SetNode node, SetNode* min_node) {
 		// Εχουμε αριστερό υποδέντρο, οπότε η μικρότερη τιμή είναι εκεί. Συνεχίζουμε αναδρομικά
 		// και ενημερώνουμε το node->left με τη νέα ρίζα του υποδέντρου.
 		node->size--;
-		node->left = node_remove_min(node->left, min_node);
+		node_set_left(node, node_remove_min(node->left, min_node));
 
 		return node_repair_balance(node);	// AVL
 	}
@@ -327,11 +347,11 @@ static SetNode node_remove(SetNode node, CompareFunc compare, Pointer value, boo
 			// αφαιρείται. Η συνάρτηση node_remove_min κάνει ακριβώς αυτή τη δουλειά.
 
 			SetNode min_right;
-			node->right = node_remove_min(node->right, &min_right);
+			node_set_right(node, node_remove_min(node->right, &min_right));
 
 			// Σύνδεση του min_right στη θέση του node
-			min_right->left = node->left;
-			min_right->right = node->right;
+			node_set_left(min_right, node->left);
+			node_set_right(min_right, node->right);
 
 			min_right->size = node->size - 1;
 
@@ -344,11 +364,11 @@ static SetNode node_remove(SetNode node, CompareFunc compare, Pointer value, boo
 	// compare_res != 0, συνεχίζουμε στο αριστερό ή δεξί υποδέντρο, η ρίζα δεν αλλάζει.
 	if (compare_res < 0) {
 		node->size--;
-		node->left  = node_remove(node->left,  compare, value, removed, old_value);
+		node_set_left(node, node_remove(node->left, compare, value, removed, old_value));
 	}
 	else {
 		node->size--;
-		node->right = node_remove(node->right, compare, value, removed, old_value);
+		node_set_right(node, node_remove(node->right, compare, value, removed, old_value));
 	}
 	if (*removed == false) {
 		node->size++;
@@ -390,6 +410,29 @@ Set set_create(CompareFunc compare, DestroyFunc destroy_value) {
 	return set;
 }
 
+// Δημιουργεί ένα ισοζυγισμένο δέντρο από τις size ταξινομημένες τιμές values, με ρίζα
+// τη μεσαία τιμή. Τα ύψη των δύο υποδέντρων κάθε κόμβου διαφέρουν το πολύ κατά 1.
+
+static SetNode node_create_from_sorted(Pointer values[], int size) {
+	if (size == 0)
+		return NULL;
+
+	int middle = size / 2;
+	SetNode node = node_create(values[middle]);
+	node_set_left(node, node_create_from_sorted(values, middle));
+	node_set_right(node, node_create_from_sorted(values + middle + 1, size - middle - 1));
+	node->size = size;
+	node_update_height(node);
+	return node;
+}
+
+Set set_create_from_sorted(CompareFunc compare, DestroyFunc destroy_value, Pointer values[], int size) {
+	Set set = set_create(compare, destroy_value);
+	set->root = node_create_from_sorted(values, size);
+	set->size = size;
+	return set;
+}
+
 int set_size(Set set) {
 	return set->size;
 } 
@@ -398,6 +441,7 @@ void set_insert(Set set, Pointer value) {
 	bool inserted;
 	Pointer old_value;
 	set->root = node_insert(set->root, set->compare, value, &inserted, &old_value);
+	set->root->parent = NULL;
 	
 	// Το size αλλάζει μόνο αν μπει νέος κόμβος. Στα updates κάνουμε destroy την παλιά τιμή
 	if (inserted) {
@@ -412,6 +456,8 @@ bool set_remove(Set set, Pointer value) {
 	bool removed;
 	Pointer old_value = NULL;
 	set->root = node_remove(set->root, set->compare, value, &removed, &old_value);
+	if (set->root != NULL)
+		set->root->parent = NULL;
 
 	// Το size αλλάζει μόνο αν πραγματικά αφαιρεθεί ένας κόμβος
 	if (removed) {
@@ -440,6 +486,29 @@ void set_destroy(Set set) {
 	free(set);
 }
 
+// Επιστρέφει αντίγραφο του υποδέντρου με ρίζα node (με την ίδια ακριβώς δομή)
+
+static SetNode node_copy(SetNode node) {
+	if (node == NULL)
+		return NULL;
+
+	SetNode copy = node_create(node->value);
+	copy->height = node->height;
+	copy->size = node->size;
+	node_set_left(copy, node_copy(node->left));
+	node_set_right(copy, node_copy(node->right));
+	return copy;
+}
+
+Set set_snapshot(Set set) {
+	// Οι κόμβοι δεν μοιράζονται, οπότε αντιγράφεται όλο το δέντρο σε O(n)
+	Set snapshot = set_create(set->compare, NULL);
+	snapshot->root = node_copy(set->root);
+	snapshot->size = set->size;
+
+	return snapshot;
+}
+
 SetNode set_first(Set set) {
 	return node_find_min(set->root);
 }
@@ -449,11 +518,11 @@ SetNode set_last(Set set) {
 }
 
 SetNode set_previous(Set set, SetNode node) {
-	return node_find_previous(set->root, set->compare, node);
+	return node_find_previous(node);
 }
 
 SetNode set_next(Set set, SetNode node) {
-	return node_find_next(set->root, set->compare, node);
+	return node_find_next(node);
 }
 
 Pointer set_node_value(Set set, SetNode node) {
@@ -464,6 +533,25 @@ SetNode set_find_node(Set set, Pointer value) {
 	return node_find_equal(set->root, set->compare, value);
 }
 
+SetNode set_lower_bound(Set set, Pointer value) {
+	// Κρατάμε τον τελευταίο κόμβο >= value που συναντήσαμε στην κατάβαση
+	SetNode result = SET_EOF;
+	SetNode node = set->root;
+	while (node != NULL) {
+		int compare_res = set->compare(node->value, value);
+		if (compare_res == 0) {
+			return node;
+		} else if (compare_res > 0) {
+			// Ο node είναι υποψήφιος, αλλά μπορεί να υπάρχει μικρότερος στο αριστερό υποδέντρο
+			result = node;
+			node = node->left;
+		} else {
+			node = node->right;
+		}
+	}
+	return result;
+}
+
 
 
 // Συναρτήσεις που δεν υπάρχουν στο public interface αλλά χρησιμοποιούνται στα tests
@@ -484,6 +572,12 @@ bool node_is_avl(SetNode node, CompareFunc compare) {
 	if(node->right != NULL)
 		res = res && compare(node->right->value, node->value) > 0 && compare(node_find_min(node->right)->value, node->value) > 0;
 
+	// Οι δείκτες στους πατέρες είναι σωστοί
+	res = res && (node->left == NULL || node->left->parent == node) && (node->right == NULL || node->right->parent == node);
+
+	// Το μέγεθος του υποδέντρου είναι σωστό
+	res = res && node->size == 1 + node_size(node->left) + node_size(node->right);
+
 	// Το ύψος είναι σωστό
 	res = res && node->height == 1 + int_max(node_height(node->left), node_height(node->right));
 
@@ -500,7 +594,7 @@ bool node_is_avl(SetNode node, CompareFunc compare) {
 }
 
 bool set_is_proper(Set node) {
-	return node_is_avl(node->root, node->compare);
+	return (node->root == NULL || node->root->parent == NULL) && node_is_avl(node->root, node->compare);
 }
 
 // LCOV_EXCL_STOP
@@ -597,4 +691,107 @@ static int node_count_less_than(Set set, SetNode node, Pointer min) {
 int set_count_less_than(Set set, Pointer min) {
 	// Καλούμε την αντίστοιχη αναδρομική συνάρτηση για την ρίζα
 	return node_count_less_than(set, set->root, min);
-}
\ No newline at end of file
+}
+
+//// Συναρτήσεις διάταξης (order statistics) ////////////////////////////////////////////////
+//
+// Βασίζονται στο size κάθε κόμβου, οπότε αρκεί μία κατάβαση από τη ρίζα.
+
+SetNode set_select(Set set, int k) {
+	if (k < 0 || k >= set->size)
+		return SET_EOF;
+
+	SetNode node = set->root;
+	while (node != NULL) {
+		int left_size = node_size(node->left);
+		if (k < left_size) {
+			// Το k-οστό στοιχείο είναι στο αριστερό υποδέντρο
+			node = node->left;
+		} else if (k == left_size) {
+			// Ακριβώς left_size στοιχεία είναι μικρότερα από τον node
+			return node;
+		} else {
+			// Το k-οστό στοιχείο είναι στο δεξί υποδέντρο, παραλείπουμε το αριστερό και τον ίδιο τον node
+			k -= left_size + 1;
+			node = node->right;
+		}
+	}
+	return SET_EOF;		// LCOV_EXCL_LINE (δεν φτάνει ποτέ εδώ αφού 0 <= k < size)
+}
+
+int set_rank(Set set, Pointer value) {
+	int rank = 0;
+	SetNode node = set->root;
+	while (node != NULL) {
+		int compare_res = set->compare(node->value, value);
+		if (compare_res < 0) {
+			// Ο node και όλο το αριστερό του υποδέντρο είναι μικρότερα από value
+			rank += node_size(node->left) + 1;
+			node = node->right;
+		} else if (compare_res == 0) {
+			// Μικρότερα είναι μόνο τα στοιχεία του αριστερού υποδέντρου
+			return rank + node_size(node->left);
+		} else {
+			node = node->left;
+		}
+	}
+	return rank;
+}
+
+// Μετράει τα στοιχεία του υποδέντρου με ρίζα node που είναι >= from (όλα, αν from == NULL)
+
+static int node_count_from(SetNode node, CompareFunc compare, Pointer from) {
+	if (from == NULL)
+		return node_size(node);
+
+	int count = 0;
+	while (node != NULL) {
+		if (compare(node->value, from) >= 0) {
+			// Ο node και όλο το δεξί του υποδέντρο είναι μέσα στο όριο
+			count += node_size(node->right) + 1;
+			node = node->left;
+		} else {
+			node = node->right;
+		}
+	}
+	return count;
+}
+
+// Μετράει τα στοιχεία του υποδέντρου με ρίζα node που είναι <= to (όλα, αν to == NULL)
+
+static int node_count_to(SetNode node, CompareFunc compare, Pointer to) {
+	if (to == NULL)
+		return node_size(node);
+
+	int count = 0;
+	while (node != NULL) {
+		if (compare(node->value, to) <= 0) {
+			// Ο node και όλο το αριστερό του υποδέντρο είναι μέσα στο όριο
+			count += node_size(node->left) + 1;
+			node = node->right;
+		} else {
+			node = node->left;
+		}
+	}
+	return count;
+}
+
+int set_range_count(Set set, Pointer from, Pointer to) {
+	// Κατεβαίνουμε μέχρι τον πρώτο κόμβο που βρίσκεται μέσα στα όρια. Από εκεί και πέρα
+	// τα όρια "χωρίζονται": το from αφορά μόνο το αριστερό υποδέντρο και το to μόνο το δεξί.
+	SetNode node = set->root;
+	while (node != NULL) {
+		if (from != NULL && set->compare(node->value, from) < 0)
+			node = node->right;
+		else if (to != NULL && set->compare(node->value, to) > 0)
+			node = node->left;
+		else
+			break;
+	}
+
+	// Κανένα στοιχείο μέσα στα όρια
+	if (node == NULL)
+		return 0;
+
+	return 1 + node_count_from(node->left, set->compare, from) + node_count_to(node->right, set->compare, to);
+}
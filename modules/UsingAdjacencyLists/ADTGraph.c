@@ -7,10 +7,13 @@
 #include "ADTGraph.h"
 #include "common_types.h"
 #include "ADTList.h"			// Ορισμένες συναρτήσεις επιστρέφουν λίστες
-#include "ADTPriorityQueue.h"
+#include "ADTTypedPriorityQueue.h"
 #include <stdlib.h>
 #include <limits.h>
 
+#define ADT_MODULE ADT_GRAPH
+#include "AdtAlloc.h"			// Τελευταίο include, μετρητές δεσμεύσεων (ADT_ALLOC_STATS)
+
 // Ένας γράφος αναπαριστάται από τον τύπο Graph
 
 struct graph {
@@ -183,35 +186,36 @@ List graph_get_adjacent(Graph graph, Pointer vertex) {
 // κάθε κληση και είναι ευθύνη του χρήστη να κάνει list_destroy.
 
 // Ο τύπος SearchNode χρησιμοποιείται για τον αλγόριθμο του Dijkstra και αποθηκεύει
-// μια κορυφή, την προηγούμενή της στο μονοπάτι, τον κόμβο της μέσα στην pqueue,
-// την απόσταση από την αρχή προς αυτήν και το αν είναι μέσα στο "ψαγμένο" σύνολο ή όχι
+// μια κορυφή, την προηγούμενή της στο μονοπάτι, την απόσταση από την αρχή προς αυτήν
+// και το αν είναι μέσα στο "ψαγμένο" σύνολο ή όχι
 
 typedef struct search_node* SearchNode;
 
 struct search_node {
     Pointer vertex;             // κορυφή
     SearchNode prev;            // προηγούμενη στο μονοπάτι
-    PriorityQueueNode pqnode;   // κόμβος στην pqueue
     uint dist;                  // απόσταση
     bool in;                    // αν είναι μέσα στο σύνολο ή όχι
 };
 
-// Συνάρτηση που συγκρίνει αποστάσεις, για την pqueue
+// Η pqueue κρατάει (by value) ζεύγη απόστασης και κορυφής, με inline σύγκριση. Οταν
+// μειώνεται η απόσταση μιας κορυφής προστίθεται νέο ζεύγος, και τα παλιά αγνοούνται
+// όταν βγουν από την pqueue (η dist τους δεν είναι πια η dist της κορυφής).
 
-int compare_distances(Pointer a, Pointer b) {
-    // Δεν γίνεται αφαίρεση για να μην υπάρχει πρόβλημα
-    // με την αλλαγή τύπου από uint σε int
-    if (((SearchNode) b)->dist > ((SearchNode) a)->dist) {
-        return 1;
-    }
-    else if (((SearchNode) b)->dist < ((SearchNode) a)->dist) {
-        return -1;
-    }
-    else {
-        return 0;
-    }
+typedef struct {
+    uint dist;
+    SearchNode node;
+} SearchEntry;
+
+// Μεγαλύτερη προτεραιότητα έχει η μικρότερη απόσταση. Δεν γίνεται αφαίρεση
+// για να μην υπάρχει πρόβλημα με την αλλαγή τύπου από uint σε int
+
+static inline int compare_distances(SearchEntry a, SearchEntry b) {
+    return (b.dist > a.dist) - (b.dist < a.dist);
 }
 
+DEFINE_PQUEUE(SearchEntry, compare_distances)
+
 List graph_shortest_path(Graph graph, Pointer source, Pointer target) {
     List path = list_create(NULL);
     // search_map: map: vertex --> searchnode
@@ -225,26 +229,30 @@ List graph_shortest_path(Graph graph, Pointer source, Pointer target) {
         searchnode->in = false;
         searchnode->prev = NULL;
         searchnode->vertex = map_node_key(graph->vertex_list_map, mapnode);
-        searchnode->pqnode = NULL;
         map_insert(search_map, searchnode->vertex, searchnode);
     }
     // Αρχικοποιούμε την dist_pqueue και προσθέτουμε το source με απόσταση 0
-    PriorityQueue dist_pqueue = pqueue_create(compare_distances, NULL, NULL);
+    PriorityQueue_SearchEntry dist_pqueue = pqueue_SearchEntry_create(NULL, 0);
     (searchnode = map_find(search_map, source))->dist = 0;
-    searchnode->pqnode = pqueue_insert(dist_pqueue, searchnode);
+    pqueue_SearchEntry_insert(dist_pqueue, (SearchEntry){ 0, searchnode });
 
     // Κυρίως αλγόριθμος
     List edges;
     uint alt;
     SearchNode neighb;
-    while (pqueue_size(dist_pqueue)) {
-        // Επιλέγουμε την πιο "κοντινή" κορυφή
+    while (pqueue_SearchEntry_size(dist_pqueue)) {
+        // Επιλέγουμε την πιο "κοντινή" κορυφή και την αφαιρούμε από την pqueue
+        SearchEntry entry = pqueue_SearchEntry_max(dist_pqueue);
+        pqueue_SearchEntry_remove_max(dist_pqueue);
+        searchnode = entry.node;
+        // Παλιό ζεύγος, η κορυφή έχει ήδη βγει με μικρότερη απόσταση
+        if (searchnode->in || entry.dist != searchnode->dist) {
+            continue;
+        }
         // Αν φτάσουμε στην κορυφή-προορισμό σταματάμε
-        if ((searchnode = pqueue_max(dist_pqueue))->vertex == target) {
+        if (searchnode->vertex == target) {
             break;
         }
-        // Την αφαιρούμε από την pqueue
-        pqueue_remove_max(dist_pqueue);
         // Την βάζουμε στο σύνολο
         searchnode->in = true;
         // Παίρουμε την λίστα των γειτόνων
@@ -262,17 +270,12 @@ List graph_shortest_path(Graph graph, Pointer source, Pointer target) {
             if (alt < neighb->dist) {
                 neighb->dist = alt;
                 neighb->prev = searchnode;
-                if (neighb->pqnode) {
-                    pqueue_update_order(dist_pqueue, neighb->pqnode);
-                }
-                else {
-                    neighb->pqnode = pqueue_insert(dist_pqueue, neighb);
-                }
+                pqueue_SearchEntry_insert(dist_pqueue, (SearchEntry){ alt, neighb });
             }
         }
     }
     // Δεν χρειαζόμασε άλλο την pqueue
-    pqueue_destroy(dist_pqueue);
+    pqueue_SearchEntry_destroy(dist_pqueue);
     // Επιστρέφουμε την λίστα
     if ((searchnode = map_find(search_map, target))->prev == NULL) {
         map_destroy(search_map);
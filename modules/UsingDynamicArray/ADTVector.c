@@ -9,6 +9,9 @@
 
 #include "ADTVector.h"
 
+#define ADT_MODULE ADT_VECTOR
+#include "AdtAlloc.h"			// Τελευταίο include, μετρητές δεσμεύσεων (ADT_ALLOC_STATS)
+
 
 // Το αρχικό μέγεθος που δεσμεύουμε
 #define VECTOR_MIN_CAPACITY 10
@@ -5,9 +5,15 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "ADTMap.h"
 #include "ADTList.h"
+#include "AdtHash.h"
+#include "AdtStats.h"
+
+#define ADT_MODULE ADT_MAP
+#include "AdtAlloc.h"			// Τελευταίο include, μετρητές δεσμεύσεων (ADT_ALLOC_STATS)
 
 // Το μέγεθος του Hash Table ιδανικά θέλουμε να είναι πρώτος αριθμός σύμφωνα με την θεωρία.
 // Η παρακάτω λίστα περιέχει πρώτους οι οποίοι έχουν αποδεδιγμένα καλή συμπεριφορά ως μεγέθη.
@@ -19,16 +25,21 @@ int prime_sizes[] = {53, 97, 193, 389, 769, 1543, 3079, 6151, 12289, 24593, 4915
 // τον load factor του  hash table μικρότερο ή ίσο του 0.5, για να έχουμε αποδoτικές πράξεις
 #define MAX_LOAD_FACTOR 0.9
 
+// Αρχικό μέγεθος με MAP_SIZING_POW2, κάθε rehash το διπλασιάζει
+#define POW2_INITIAL_CAPACITY 64
+
 // Δομή του κάθε κόμβου που έχει το hash table (με το οποίο υλοιποιούμε το map)
 struct map_node {
 	Pointer key;		// Το κλειδί που χρησιμοποιείται για να hash-αρουμε
 	Pointer value;  	// Η τιμή που αντισtοιχίζεται στο παραπάνω κλειδί
+	uint hash;			// Το hash του key, ώστε να μην υπολογίζεται ξανά (rehash, remove, next)
 };
 
 // Δομή του Map (περιέχει όλες τις πληροφορίες που χρεαζόμαστε για το HashTable)
 struct map {
 	List *list_array;			// Ο πίνακας δεικτών σε λίστες που θα χρησιμοποιήσουμε για το map (remember, φτιάχνουμε ένα hash table με separate chaining)
 	int capacity;				// Πόσο χώρο έχουμε δεσμεύσει.
+	uint mask;					// capacity - 1 με MAP_SIZING_POW2, 0 με MAP_SIZING_PRIME
 	int size;					// Πόσα στοιχεία έχουμε προσθέσει
 	CompareFunc compare;		// Συνάρτηση για σύγκρηση δεικτών, που πρέπει να δίνεται απο τον χρήστη
 	HashFunc hash_function;		// Συνάρτηση για να παίρνουμε το hash code του κάθε αντικειμένου.
@@ -47,6 +58,7 @@ Map map_create(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy
 	for (int i = 0; i < map->capacity; i++)
 		map->list_array[i] = list_create(NULL);	// Destroy θα κάνουμε εμείς και όχι η λίστα
 
+	map->mask = 0;
 	map->size = 0;
 	map->compare = compare;
 	map->destroy_key = destroy_key;
@@ -60,45 +72,71 @@ int map_size(Map map) {
 	return map->size;
 }
 
-// Συνάρτηση για την επέκταση του Hash Table σε περίπτωση που ο load factor μεγαλώσει πολύ.
-static void rehash(Map map) {
+// Το bucket στο οποίο ανήκει ένα κλειδί με το συγκεκριμένο hash
+
+static inline uint bucket_of(Map map, uint hash) {
+	return map->mask != 0 ? hash & map->mask : hash % map->capacity;
+}
+
+// Μεταφέρει όλα τα entries σε νέο hash table με χωρητικότητα capacity
+
+static void resize(Map map, int capacity) {
 	// Αποθήκευση των παλιών δεδομένων
 	int old_capacity = map->capacity;
 	List *old_list_array = map->list_array;
 
-	// Βρίσκουμε τη νέα χωρητικότητα, διασχίζοντας τη λίστα των πρώτων ώστε να βρούμε τον επόμενο. 
-	int prime_no = sizeof(prime_sizes) / sizeof(int);	// το μέγεθος του πίνακα
-	for (int i = 0; i < prime_no; i++) {					// LCOV_EXCL_LINE
-		if (prime_sizes[i] > old_capacity) {
-			map->capacity = prime_sizes[i]; 
-			break;
-		}
-	}
-	// Αν έχουμε εξαντλήσει όλους τους πρώτους, διπλασιάζουμε
-	if (map->capacity == old_capacity)					// LCOV_EXCL_LINE
-		map->capacity *= 2;								// LCOV_EXCL_LINE
-
-	// Δημιουργούμε ένα μεγαλύτερο hash table
+	// Δημιουργούμε το νέο hash table
+	map->capacity = capacity;
+	map->mask = map->mask != 0 ? capacity - 1 : 0;
 	map->list_array = malloc(map->capacity * sizeof(List));
 	for (int i = 0; i < map->capacity; i++)
 		map->list_array[i] = list_create(NULL);
 
-	// Τοποθετούμε τα παλιά entries
-	map->size = 0;
+	// Μεταφέρουμε τους παλιούς κόμβους (χωρίς compare, τα κλειδιά είναι διαφορετικά μεταξύ τους),
+	// οπότε οι MapNodes μένουν οι ίδιοι και μετά το rehash
 	for (int i = 0; i < old_capacity; i++) {
 		for (ListNode node = list_first(old_list_array[i]) ; node != LIST_EOF ; node = list_next(old_list_array[i], node)) {
-			map_insert(map, ((MapNode) list_node_value(old_list_array[i], node))->key, ((MapNode) list_node_value(old_list_array[i], node))->value);////////////////////////
+			MapNode mapnode = list_node_value(old_list_array[i], node);
+			list_insert_next(map->list_array[bucket_of(map, mapnode->hash)], LIST_BOF, mapnode);
 		}
+		list_destroy(old_list_array[i]);
 	}
+	free(old_list_array);
+}
 
-	// Αποδεσμεύουμε τον παλιό πίνακα ώστε να μήν έχουμε leaks
-	for (uint i = 0 ; i < old_capacity ; i++) {
-		for (ListNode node = list_first(old_list_array[i]) ; node != LIST_EOF ; node = list_next(old_list_array[i], node)) {////////////
-			free(list_node_value(old_list_array[i], node));	// free MapNode
+// Επιστρέφει την πρώτη χωρητικότητα (από τη λίστα των πρώτων, ή τη διπλάσια με
+// MAP_SIZING_POW2) μεγαλύτερη από capacity
+
+static int next_capacity(Map map, int capacity) {
+	if (map->mask != 0)
+		return capacity * 2;
+
+	// Διασχίζουμε τη λίστα των πρώτων ώστε να βρούμε τον επόμενο
+	int prime_no = sizeof(prime_sizes) / sizeof(int);	// το μέγεθος του πίνακα
+	for (int i = 0; i < prime_no; i++) {					// LCOV_EXCL_LINE
+		if (prime_sizes[i] > capacity) {
+			return prime_sizes[i];
 		}
-		list_destroy(old_list_array[i]);
 	}
-	free(old_list_array);
+	// Αν έχουμε εξαντλήσει όλους τους πρώτους, διπλασιάζουμε
+	return capacity * 2;								// LCOV_EXCL_LINE
+}
+
+// Συνάρτηση για την επέκταση του Hash Table σε περίπτωση που ο load factor μεγαλώσει πολύ.
+static void rehash(Map map) {
+	ADT_STATS_START(start);
+	resize(map, next_capacity(map, map->capacity));
+	ADT_STATS_EVENT(ADT_EVENT_MAP_REHASH, ADT_STATS_ELAPSED(start));
+}
+
+void map_reserve(Map map, int size) {
+	// Βρίσκουμε τη μικρότερη χωρητικότητα στην οποία χωράνε size στοιχεία χωρίς rehash
+	int capacity = map->capacity;
+	while ((float)size / capacity > MAX_LOAD_FACTOR)
+		capacity = next_capacity(map, capacity);
+
+	if (capacity != map->capacity)
+		resize(map, capacity);
 }
 
 // Εισαγωγή στο hash table του ζευγαριού (key, item). Αν το key υπάρχει,
@@ -106,49 +144,62 @@ static void rehash(Map map) {
 
 void map_insert(Map map, Pointer key, Pointer value) {
 	// Hash στο κλειδί για να βρούμε την κατάλληλη λίστα
-	uint pos = map->hash_function(key) % map->capacity;
-	List target_list = map->list_array[pos];
+	uint hash = map->hash_function(key);
+	List target_list = map->list_array[bucket_of(map, hash)];
 
 	// Ψάχνουμε στην λίστα για κόμβο με ισοδύναμο κλειδί και αν τον βρούμε ενημερώνουμε με τα key και value του
 	ListNode listnode;
 	for (listnode = list_first(target_list) ; listnode != LIST_EOF ; listnode = list_next(target_list, listnode)) {
-		if (!map->compare(((MapNode)list_node_value(target_list, listnode))->key, key)) {
-			if (((MapNode)list_node_value(target_list, listnode))->key != key && map->destroy_key != NULL) {
-				map->destroy_key(((MapNode)list_node_value(target_list, listnode))->key);
+		MapNode mapnode = list_node_value(target_list, listnode);
+		if (mapnode->hash == hash && !map->compare(mapnode->key, key)) {
+			if (mapnode->key != key && map->destroy_key != NULL) {
+				map->destroy_key(mapnode->key);
 			}
-			((MapNode)list_node_value(target_list, listnode))->key = key;
-			if (((MapNode)list_node_value(target_list, listnode))->value != value && map->destroy_value != NULL) {
-				map->destroy_value(((MapNode)list_node_value(target_list, listnode))->value);
+			mapnode->key = key;
+			if (mapnode->value != value && map->destroy_value != NULL) {
+				map->destroy_value(mapnode->value);
 			}
-			((MapNode)list_node_value(target_list, listnode))->value = value;
+			mapnode->value = value;
 			break;
 		}
 	}
 
 	// Αλλιώς δημιουργούμε και προσθέτουμε νέο κόμβο
-	if (listnode == LIST_EOF) {
-		MapNode newnode = malloc(sizeof(*newnode));
-		newnode->key = key;
-		newnode->value = value;
-		list_insert_next(target_list, LIST_BOF, newnode);
-		map->size++;
-	}
+	if (listnode == LIST_EOF)
+		map_insert_with(map, hash, key, value);
+}
+
+// Προσθέτει νέο κόμβο χωρίς να ελέγξει αν το key υπάρχει ήδη
+
+MapNode map_insert_with(Map map, uint hash, Pointer key, Pointer value) {
+	MapNode newnode = malloc(sizeof(*newnode));
+	newnode->key = key;
+	newnode->value = value;
+	newnode->hash = hash;
+	list_insert_next(map->list_array[bucket_of(map, hash)], LIST_BOF, newnode);
+	map->size++;
 
 	// Αν με την νέα εισαγωγή ξεπερνάμε το μέγιστο load factor, πρέπει να κάνουμε rehash
 	float load_factor = (float)map->size / map->capacity;
 	if (load_factor > MAX_LOAD_FACTOR)
 		rehash(map);
+
+	return newnode;
 }
 
 // Διαργραφή απο το Hash Table του κλειδιού με τιμή key
 bool map_remove(Map map, Pointer key) {
+	return map_remove_with(map, map->hash_function(key), key, map->compare);
+}
+
+bool map_remove_with(Map map, uint hash, Pointer probe, CompareFunc eq) {
 	// Ψάχνουμε το node που περιέχει το key
-	MapNode node = map_find_node(map, key);
+	MapNode node = map_find_node_with(map, hash, probe, eq);
 	// Αν δεν το βρούμε επιστρέφουμε false
 	if (node == MAP_EOF)
 		return false;
 	// Βρίσκουμε την λίστα-πατέρα του node
-	List node_parent = map->list_array[map->hash_function(node->key) % map->capacity];
+	List node_parent = map->list_array[bucket_of(map, node->hash)];
 	// Αφαιρούμε τον node από την λίστα
 	if (((MapNode)list_node_value(node_parent, list_first(node_parent))) == node) {
 		list_remove_next(node_parent, LIST_BOF);
@@ -182,8 +233,12 @@ bool map_remove(Map map, Pointer key) {
 // Αναζήτηση στο map, με σκοπό να επιστραφεί το value του κλειδιού που περνάμε σαν όρισμα.
 
 Pointer map_find(Map map, Pointer key) {
+	return map_find_with(map, map->hash_function(key), key, map->compare);
+}
+
+Pointer map_find_with(Map map, uint hash, Pointer probe, CompareFunc eq) {
 	// Ψάχνουμε τον κόμβο
-	MapNode node = map_find_node(map, key);
+	MapNode node = map_find_node_with(map, hash, probe, eq);
 	// Αν τον βρούμε, επιστρέφουμε το value
 	if (node != MAP_EOF) {
 		return node->value;
@@ -243,7 +298,7 @@ MapNode map_first(Map map) {
 
 MapNode map_next(Map map, MapNode node) {
 	// Βρίσκουμε με hash την λίστα όπου είναι το node
-	uint pos = map->hash_function(node->key) % map->capacity;
+	uint pos = bucket_of(map, node->hash);
 	List parent = map->list_array[pos];
 	// Ψάχνουμε στην λίστα το node και επιστρέφουμε το επόμενο
 	for (ListNode listnode = list_first(parent) ; listnode != LIST_EOF ; listnode = list_next(parent, listnode)) {
@@ -273,12 +328,34 @@ Pointer map_node_value(Map map, MapNode node) {
 }
 
 MapNode map_find_node(Map map, Pointer key) {
+	return map_find_node_with(map, map->hash_function(key), key, map->compare);
+}
+
+MapNode map_find_or_insert(Map map, Pointer key, Pointer (*make)(Pointer key), bool* inserted) {
+	uint hash = map->hash_function(key);
+	MapNode node = map_find_node_with(map, hash, key, map->compare);
+
+	bool found = node != MAP_EOF;
+	if (!found)
+		node = map_insert_with(map, hash, key, make != NULL ? make(key) : NULL);
+
+	if (inserted != NULL)
+		*inserted = !found;
+	return node;
+}
+
+void map_node_set_value(Map map, MapNode node, Pointer value) {
+	node->value = value;
+}
+
+MapNode map_find_node_with(Map map, uint hash, Pointer probe, CompareFunc eq) {
 	// Βρίσκουμε με hash την λίστα όπου είναι το key
-	List target_list = map->list_array[map->hash_function(key) % map->capacity];
-	// Ψάχνουμε το αντίχτοιχο node και το επιστρέφουμε
+	List target_list = map->list_array[bucket_of(map, hash)];
+	// Ψάχνουμε το αντίχτοιχο node και το επιστρέφουμε. Η eq καλείται μόνο για κόμβους με το ίδιο hash.
 	for (ListNode listnode = list_first(target_list) ; listnode != LIST_EOF ; listnode = list_next(target_list, listnode)) {
-		if (!map->compare(((MapNode) list_node_value(target_list, listnode))->key, key)) {
-			return list_node_value(target_list, listnode);
+		MapNode mapnode = list_node_value(target_list, listnode);
+		if (mapnode->hash == hash && !eq(mapnode->key, probe)) {
+			return mapnode;
 		}
 	}
 
@@ -290,20 +367,26 @@ void map_set_hash_function(Map map, HashFunc func) {
 	map->hash_function = func;
 }
 
+void map_set_sizing(Map map, MapSizing sizing) {
+	// Το map είναι κενό, οπότε απλά φτιάχνουμε νέο πίνακα με το αρχικό μέγεθος
+	map->mask = sizing == MAP_SIZING_POW2 ? POW2_INITIAL_CAPACITY - 1 : 0;
+	resize(map, sizing == MAP_SIZING_POW2 ? POW2_INITIAL_CAPACITY : prime_sizes[0]);
+}
+
 uint hash_string(Pointer value) {
-	// djb2 hash function, απλή, γρήγορη, και σε γενικές γραμμές αποδοτική
-    uint hash = 5381;
-    for (char* s = value; *s != '\0'; s++)
-		hash = (hash << 5) + hash + *s;			// hash = (hash * 33) + *s. Το foo << 5 είναι γρηγορότερη εκδοχή του foo * 32.
-    return hash;
+	// Το strlen διαβάζει πολλά bytes τη φορά, και μετά το hash παίρνει 8 bytes τη φορά
+	// αντί για ένα (το djb2 που χρησιμοποιούσαμε είχε ένα πολλαπλασιασμό ανά χαρακτήρα)
+	return adt_hash_bytes(value, strlen(value), 0);
 }
 
 uint hash_int(Pointer value) {
-	return *(int*)value;
+	return adt_hash_u64(*(uint*)value);
 }
 
 uint hash_pointer(Pointer value) {
-	return (size_t)value;				// cast σε sizt_t, που έχει το ίδιο μήκος με έναν pointer
+	// Ολα τα bits περνάνε από την ανάμειξη, αφού η ευθυγράμμιση του pointer δεν είναι γνωστή
+	// (πχ διαδοχικοί char* διαφέρουν μόνο στα χαμηλά bits)
+	return adt_hash_u64((uintptr_t)value);
 }
 
 HashFunc map_get_hash_function(Map map) {
@@ -312,4 +395,29 @@ HashFunc map_get_hash_function(Map map) {
 
 CompareFunc map_get_compare(Map map) {
 	return map->compare;
+}
+
+MapStats map_stats(Map map) {
+	MapStats stats = { .size = map->size, .capacity = map->capacity };
+	stats.load_factor = (float)map->size / map->capacity;
+
+	// Για μια αλυσίδα μήκους n, τα στοιχεία της βρίσκονται με 1 + 2 + ... + n συγκρίσεις
+	int chains = 0;
+	long probes = 0;
+	for (int i = 0; i < map->capacity; i++) {
+		int length = list_size(map->list_array[i]);
+		stats.chains[length < MAP_STATS_CHAINS ? length : MAP_STATS_CHAINS - 1]++;
+
+		if (length > stats.max_chain)
+			stats.max_chain = length;
+		if (length > 0)
+			chains++;
+		probes += (long)length * (length + 1) / 2;
+	}
+
+	if (map->size > 0) {
+		stats.mean_chain = (float)map->size / chains;
+		stats.mean_probes = (float)probes / map->size;
+	}
+	return stats;
 }
\ No newline at end of file
@@ -10,6 +10,10 @@
 #include "ADTPriorityQueue.h"
 #include "ADTVector.h"			// Η υλοποίηση του PriorityQueue χρησιμοποιεί Vector
 #include "ADTList.h"
+#include "AdtStats.h"
+
+#define ADT_MODULE ADT_PQUEUE
+#include "AdtAlloc.h"			// Τελευταίο include, μετρητές δεσμεύσεων (ADT_ALLOC_STATS)
 
 // Ενα PriorityQueue είναι pointer σε αυτό το struct
 struct priority_queue {
@@ -28,22 +32,6 @@ struct priority_queue_node {
 	int id;
 };
 
-// Με την ίδια μεθοδολογία με αυτήν του UsingADTSet_ADTPriorityQueue, επειδή για απλοποίηση
-// του αλγορίθμου (και ομοιότητα με την υλοποίηση του μαθήματος) θα γίνει απελευθέρωση μνήμης
-// μέσω του vector, χρησιμοποιούνται η συνάρτηση destroy_nodeκαι η εξωτερική μεταβλητή temp_destroy
-
-static DestroyFunc temp_destroy;
-
-static void destroy_node(Pointer node) {
-    PriorityQueueNode pnode = (PriorityQueueNode) node;
-    // Απελευθερνουμε την τιμή
-    if (temp_destroy != NULL) {
-        temp_destroy(pnode->value);
-    }
-    // Απελευθερώνουμε τον κόμβο
-    free(pnode);
-}
-
 // Βοηθητικές συναρτήσεις ////////////////////////////////////////////////////////////////////////////
 
 // Προσοχή: στην αναπαράσταση ενός complete binary tree με πίνακα, είναι βολικό τα ids των κόμβων να
@@ -76,18 +64,23 @@ static void node_swap(PriorityQueue pqueue, int node_id1, int node_id2) {
 // Πριν: όλοι οι κόμβοι ικανοποιούν την ιδιότητα του σωρού, εκτός από
 //       τον node_id που μπορεί να είναι _μεγαλύτερος_ από τον πατέρα του.
 // Μετά: όλοι οι κόμβοι ικανοποιούν την ιδιότητα του σωρού.
+// Το depth είναι τα επίπεδα που έχει ήδη ανέβει ο κόμβος (0 στην αρχική κλήση).
 
-static void bubble_up(PriorityQueue pqueue, int node_id) {
+static void bubble_up(PriorityQueue pqueue, int node_id, int depth) {
 	// Αν φτάσαμε στη ρίζα, σταματάμε
-	if (node_id == 1)
+	if (node_id == 1) {
+		ADT_STATS_EVENT(ADT_EVENT_PQUEUE_SIFT_UP, depth);
 		return;
+	}
 
 	int parent = node_id / 2;		// Ο πατέρας του κόμβου. Τα node_ids είναι 1-based
 
 	// Αν ο πατέρας έχει μικρότερη τιμή από τον κόμβο, swap και συνεχίζουμε αναδρομικά προς τα πάνω
 	if (pqueue->compare(((PriorityQueueNode) node_value(pqueue, parent))->value, ((PriorityQueueNode) node_value(pqueue, node_id))->value) < 0) {
 		node_swap(pqueue, parent, node_id);
-		bubble_up(pqueue, parent);
+		bubble_up(pqueue, parent, depth + 1);
+	} else {
+		ADT_STATS_EVENT(ADT_EVENT_PQUEUE_SIFT_UP, depth);
 	}
 }
 
@@ -95,15 +88,18 @@ static void bubble_up(PriorityQueue pqueue, int node_id) {
 // Πριν: όλοι οι κόμβοι ικανοποιούν την ιδιότητα του σωρού, εκτός από τον
 //       node_id που μπορεί να είναι _μικρότερος_ από κάποιο από τα παιδιά του.
 // Μετά: όλοι οι κόμβοι ικανοποιούν την ιδιότητα του σωρού.
+// Το depth είναι τα επίπεδα που έχει ήδη κατέβει ο κόμβος (0 στην αρχική κλήση).
 
-static void bubble_down(PriorityQueue pqueue, int node_id) {
+static void bubble_down(PriorityQueue pqueue, int node_id, int depth) {
 	// βρίσκουμε τα παιδιά του κόμβου (αν δεν υπάρχουν σταματάμε)
 	int left_child = 2 * node_id;
 	int right_child = left_child + 1;
 
 	int size = pqueue_size(pqueue);
-	if (left_child > size)
+	if (left_child > size) {
+		ADT_STATS_EVENT(ADT_EVENT_PQUEUE_SIFT_DOWN, depth);
 		return;
+	}
 
 	// βρίσκουμε το μέγιστο από τα 2 παιδιά
 	int max_child = left_child;
@@ -113,7 +109,9 @@ static void bubble_down(PriorityQueue pqueue, int node_id) {
 	// Αν ο κόμβος είναι μικρότερος από το μέγιστο παιδί, swap και συνεχίζουμε προς τα κάτω
 	if (pqueue->compare(((PriorityQueueNode) node_value(pqueue, node_id))->value, ((PriorityQueueNode) node_value(pqueue, max_child))->value) < 0) {
 		node_swap(pqueue, node_id, max_child);
-		bubble_down(pqueue, max_child);
+		bubble_down(pqueue, max_child, depth + 1);
+	} else {
+		ADT_STATS_EVENT(ADT_EVENT_PQUEUE_SIFT_DOWN, depth);
 	}
 }
 
@@ -132,7 +130,7 @@ static void heapify(PriorityQueue pqueue, Vector values) {
 	}
 	// καλούμε την bubble_down για κάθε εσωτερικό κόμβο από κάτω προς την ρίζα
 	for (int i = vector_size(values)/2 ; i > 0 ; i--) {
-		bubble_down(pqueue, i);
+		bubble_down(pqueue, i, 0);
 	}
 }
 
@@ -176,7 +174,7 @@ PriorityQueueNode pqueue_insert(PriorityQueue pqueue, Pointer value) {
  	// Ολοι οι κόμβοι ικανοποιούν την ιδιότητα του σωρού εκτός από τον τελευταίο, που μπορεί να είναι
 	// μεγαλύτερος από τον πατέρα του. Αρα μπορούμε να επαναφέρουμε την ιδιότητα του σωρού καλώντας
 	// τη bubble_up γα τον τελευταίο κόμβο (του οποίου το 1-based id ισούται με το νέο μέγεθος του σωρού).
-	bubble_up(pqueue, pqueue_size(pqueue));
+	bubble_up(pqueue, pqueue_size(pqueue), 0);
 
 	return pqnode;
 }
@@ -202,7 +200,7 @@ void pqueue_remove_max(PriorityQueue pqueue) {
  	// Ολοι οι κόμβοι ικανοποιούν την ιδιότητα του σωρού εκτός από τη νέα ρίζα
  	// που μπορεί να είναι μικρότερη από κάποιο παιδί της. Αρα μπορούμε να
  	// επαναφέρουμε την ιδιότητα του σωρού καλώντας τη bubble_down για τη ρίζα.
-	bubble_down(pqueue, 1);
+	bubble_down(pqueue, 1, 0);
 }
 
 DestroyFunc pqueue_set_destroy_value(PriorityQueue pqueue, DestroyFunc destroy_value) {
@@ -212,10 +210,17 @@ DestroyFunc pqueue_set_destroy_value(PriorityQueue pqueue, DestroyFunc destroy_v
 }
 
 void pqueue_destroy(PriorityQueue pqueue) {
-	temp_destroy = pqueue->destroy_value;
-	// Αντί να κάνουμε εμείς destroy τα στοιχεία, είναι απλούστερο να
-	// προσθέσουμε τη destroy_value στο vector ώστε να κληθεί κατά το vector_destroy.
-	vector_set_destroy_value(pqueue->vector, destroy_node);
+	// Καταστρέφουμε τις τιμές και τους κόμβους απευθείας. (Δεν χρησιμοποιούμε τη destroy_value
+	// του vector, γιατί θα χρειαζόταν global μεταβλητή για την pqueue->destroy_value, κάτι που
+	// δεν επιτρέπει την ταυτόχρονη καταστροφή pqueues από διαφορετικά threads.)
+	int size = vector_size(pqueue->vector);
+	for (int i = 0; i < size; i++) {
+		PriorityQueueNode pqnode = vector_get_at(pqueue->vector, i);
+		if (pqueue->destroy_value != NULL) {
+			pqueue->destroy_value(pqnode->value);
+		}
+		free(pqnode);
+	}
 	vector_destroy(pqueue->vector);
 
 	free(pqueue);
@@ -241,8 +246,8 @@ void pqueue_remove_node(PriorityQueue pqueue, PriorityQueueNode node) {
 	// ή μεγαλύτερος από τον πατέρα του. Αρα μπορούμε να επαναφέρουμε την ιδιότητα του
  	// σωρού καλώντας τη bubble_down και την bubble_up για τη τον κόμβο.
 	if (vector_size(pqueue->vector) != id - 1) {	// Αν ο κόμβος που αφαιρέθηκε δεν ήταν τελευταίος
-		bubble_up(pqueue, id);
-		bubble_down(pqueue, id);
+		bubble_up(pqueue, id, 0);
+		bubble_down(pqueue, id, 0);
 	}
 
 	if (pqueue->destroy_value != NULL) {
@@ -263,8 +268,8 @@ static void pqueue_remove_node_nofree(PriorityQueue pqueue, PriorityQueueNode no
 	// ή μεγαλύτερος από τον πατέρα του. Αρα μπορούμε να επαναφέρουμε την ιδιότητα του
  	// σωρού καλώντας τη bubble_down και την bubble_up για τη τον κόμβο.
 	if (vector_size(pqueue->vector) != id - 1) {	// Αν ο κόμβος που αφαιρέθηκε δεν ήταν τελευταίος
-		bubble_up(pqueue, id);
-		bubble_down(pqueue, id);
+		bubble_up(pqueue, id, 0);
+		bubble_down(pqueue, id, 0);
 	}
 }
 
@@ -277,7 +282,7 @@ static void pqueue_insert_node(PriorityQueue pqueue, PriorityQueueNode node) {
  	// Ολοι οι κόμβοι ικανοποιούν την ιδιότητα του σωρού εκτός από τον τελευταίο, που μπορεί να είναι
 	// μεγαλύτερος από τον πατέρα του. Αρα μπορούμε να επαναφέρουμε την ιδιότητα του σωρού καλώντας
 	// τη bubble_up γα τον τελευταίο κόμβο (του οποίου το 1-based id ισούται με το νέο μέγεθος του σωρού).
-	bubble_up(pqueue, pqueue_size(pqueue));
+	bubble_up(pqueue, pqueue_size(pqueue), 0);
 }
 
 // Ενημερώνει την pqueue σε περίπτωση αλλαγής του περιεχομένου της τιμής του κόμβου node
@@ -288,55 +293,64 @@ void pqueue_update_order(PriorityQueue pqueue, PriorityQueueNode node) {
 	pqueue_insert_node(pqueue, node);
 }
 
-// Αφαιρεί και επιστρέφει τον μέγιστο κόμβο χωρίς να απελευθερώσει μνήμη
-
-static PriorityQueueNode pqueue_remove_and_return_max(PriorityQueue pqueue) {
-	int last_node = pqueue_size(pqueue);
-	assert(last_node != 0);		// LCOV_EXCL_LINE
-
-	PriorityQueueNode max_node = node_value(pqueue, 1);
+// Συγκρίνει τις τιμές των κόμβων node_id1 και node_id2
 
-	// Αντικαθιστούμε τον πρώτο κόμβο με τον τελευταίο και αφαιρούμε τον τελευταίο
-	node_swap(pqueue, 1, last_node);
-	vector_remove_last(pqueue->vector);
-
- 	// Ολοι οι κόμβοι ικανοποιούν την ιδιότητα του σωρού εκτός από τη νέα ρίζα
- 	// που μπορεί να είναι μικρότερη από κάποιο παιδί της. Αρα μπορούμε να
- 	// επαναφέρουμε την ιδιότητα του σωρού καλώντας τη bubble_down για τη ρίζα.
-	bubble_down(pqueue, 1);
-
-	// Επιστρέφουμε τον πρώην μέγιστο κόμβο
-	return max_node;
+static int node_compare(PriorityQueue pqueue, int node_id1, int node_id2) {
+	return pqueue->compare(((PriorityQueueNode) node_value(pqueue, node_id1))->value, ((PriorityQueueNode) node_value(pqueue, node_id2))->value);
 }
 
 // Επιστρέφει μια ταξινομημένη λίστα με τις max{k, pqueue_size}
-// μέγιστες εγγραφές στην pqueue με πολυπλοκότητα Ο(k*logn)
+// μέγιστες εγγραφές στην pqueue με πολυπλοκότητα Ο(k*logk)
 
 List pqueue_top_k(PriorityQueue pqueue, int k) {
 	List top = list_create(NULL);
 
-	// Vector για να κρατάμε τους κόμβους που αφαιρέσαμε για να τους ξαναπροσθέσουμε
-	Vector removed_nodes = vector_create(0, NULL);
-
-	// Προσθέτουμε στο τέλος της λίστας το μέγιστο και μετά το αφαιρούμε, k ή pqueue_size φορές
-	if (vector_size(pqueue->vector)) {
-		list_insert_next(top, LIST_BOF, ((PriorityQueueNode) node_value(pqueue, 1))->value);
-		vector_insert_last(removed_nodes, pqueue_remove_and_return_max(pqueue));
-	}
-	int i;
-	ListNode listnode;
-	for (i = 0, listnode = list_first(top) ; i < k - 1 ; i++, listnode = list_next(top, listnode)) {
-		if (vector_size(pqueue->vector) == 0) {
-			break;
+	int size = pqueue_size(pqueue);
+	if (k > size)
+		k = size;
+	if (k <= 0)
+		return top;
+
+	// Ο σωρός δεν αλλάζει, ώστε η pqueue_top_k να μπορεί να καλείται ταυτόχρονα από πολλά threads.
+	// Κρατάμε έναν βοηθητικό σωρό με τα ids των υποψήφιων κόμβων: ο επόμενος μέγιστος είναι πάντα
+	// παιδί κάποιου κόμβου που έχει ήδη επιλεγεί. Ο βοηθητικός σωρός έχει το πολύ k + 1 στοιχεία.
+	int* candidates = malloc((k + 1) * sizeof(int));
+	int candidate_no = 1;
+	candidates[0] = 1;
+
+	ListNode last = LIST_BOF;
+	for (int i = 0; i < k; i++) {
+		// Ο μέγιστος υποψήφιος είναι στη ρίζα του βοηθητικού σωρού
+		int max = candidates[0];
+		list_insert_next(top, last, ((PriorityQueueNode) node_value(pqueue, max))->value);
+		last = list_last(top);
+
+		// Τον αντικαθιστούμε με τον τελευταίο υποψήφιο, τον οποίο κατεβάζουμε όσο χρειάζεται
+		int node = candidates[--candidate_no];
+		int pos = 0;
+		while (2 * pos + 1 < candidate_no) {
+			int child = 2 * pos + 1;
+			if (child + 1 < candidate_no && node_compare(pqueue, candidates[child], candidates[child + 1]) < 0)
+				child++;
+			if (node_compare(pqueue, node, candidates[child]) >= 0)
+				break;
+			candidates[pos] = candidates[child];
+			pos = child;
+		}
+		if (candidate_no > 0)
+			candidates[pos] = node;
+
+		// Τα παιδιά του κόμβου που επιλέχθηκε γίνονται υποψήφιοι
+		for (int child = 2 * max; child <= 2 * max + 1 && child <= size; child++) {
+			pos = candidate_no++;
+			while (pos > 0 && node_compare(pqueue, candidates[(pos - 1) / 2], child) < 0) {
+				candidates[pos] = candidates[(pos - 1) / 2];
+				pos = (pos - 1) / 2;
+			}
+			candidates[pos] = child;
 		}
-		list_insert_next(top, listnode, ((PriorityQueueNode) node_value(pqueue, 1))->value);
-		vector_insert_last(removed_nodes, pqueue_remove_and_return_max(pqueue));
 	}
 
-	// Ξαναπροσθέτουμε τους κόμβους που αφαιρέσαμε
-	for (i = 0 ; i < vector_size(removed_nodes) ; i++) {
-		pqueue_insert_node(pqueue, vector_get_at(removed_nodes, i));
-	}
-	vector_destroy(removed_nodes);
+	free(candidates);
 	return top;
-}
\ No newline at end of file
+}
@@ -9,6 +9,9 @@
 
 #include "ADTList.h"
 
+#define ADT_MODULE ADT_LIST
+#include "AdtAlloc.h"			// Τελευταίο include, μετρητές δεσμεύσεων (ADT_ALLOC_STATS)
+
 
 // Ενα List είναι pointer σε αυτό το struct
 struct list {
@@ -0,0 +1,746 @@
+///////////////////////////////////////////////////////////
+//
+// Υλοποίηση του ADT Set μέσω persistent AVL Tree
+//
+// Οι κόμβοι μοιράζονται ανάμεσα σε διαφορετικές εκδοχές
+// (snapshots) του ίδιου set. Κάθε αλλαγή αντιγράφει μόνο
+// τους κόμβους του μονοπατιού από τη ρίζα (path copying),
+// οπότε η set_snapshot είναι O(1).
+//
+///////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <assert.h>
+#include <stdatomic.h>
+
+#include "ADTSet.h"
+#include "ADTList.h"
+#include "AdtStats.h"
+
+#define ADT_MODULE ADT_SET
+#include "AdtAlloc.h"			// Τελευταίο include, μετρητές δεσμεύσεων (ADT_ALLOC_STATS)
+
+// Υλοποιούμε τον ADT Set μέσω AVL, οπότε το struct set είναι ένα AVL Δέντρο.
+struct set {
+	SetNode root;				// η ρίζα, NULL αν είναι κενό δέντρο
+	int size;					// μέγεθος, ώστε η set_size να είναι Ο(1)
+	CompareFunc compare;		// η διάταξη
+	DestroyFunc destroy_value;	// Συνάρτηση που καταστρέφει ένα στοιχείο του set
+};
+
+// Ενώ το struct set_node είναι κόμβος ενός AVL Δέντρου Αναζήτησης. Ενας κόμβος μπορεί να
+// είναι παιδί κόμβων διαφορετικών εκδοχών του δέντρου, οπότε δεν κρατάει δείκτη στον πατέρα.
+struct set_node {
+	SetNode left, right;		// Παιδιά
+	Pointer value;				// Τιμή κόμβου
+	int height;					// Ύψος που βρίσκεται ο κόμβος στο δέντρο
+	int size;					// Μέγεθος υποδέντρου
+	atomic_int refs;			// Πλήθος γονέων (ή sets, για τη ρίζα) που δείχνουν στον κόμβο
+};
+
+
+//// Διαχείριση κοινών κόμβων ///////////////////////////////////////////////////////////////////
+//
+// Ενας κόμβος με refs == 1 ανήκει μόνο σε ένα δέντρο και μπορεί να αλλάξει επιτόπου. Αν refs > 1
+// τον μοιράζονται περισσότερες εκδοχές, οπότε πριν από κάθε αλλαγή αντιγράφεται. Το αντίγραφο
+// μοιράζεται με τον αρχικό κόμβο τα παιδιά του, άρα και αυτά θα αντιγραφούν αν χρειαστεί να αλλάξουν.
+// Ετσι κανένας κόμβος που είναι προσβάσιμος από ένα snapshot δεν αλλάζει ποτέ.
+
+static void node_retain(SetNode node) {
+	if (node != NULL)
+		atomic_fetch_add_explicit(&node->refs, 1, memory_order_relaxed);
+}
+
+// Αφήνει μια αναφορά στον node. Αν ήταν η τελευταία ο κόμβος απελευθερώνεται (χωρίς να
+// καταστραφεί η τιμή του, την οποία μπορεί να χρησιμοποιούν ακόμα άλλες εκδοχές).
+
+static void node_release(SetNode node) {
+	if (node != NULL && atomic_fetch_sub_explicit(&node->refs, 1, memory_order_acq_rel) == 1) {
+		node_release(node->left);
+		node_release(node->right);
+		free(node);
+	}
+}
+
+// Επιστρέφει έναν κόμβο ίδιο με τον node που μπορεί να αλλάξει επιτόπου: τον ίδιο τον node
+// αν δεν τον μοιράζεται κανείς, αλλιώς ένα αντίγραφο που παίρνει τη θέση του.
+
+static SetNode node_mutable(SetNode node) {
+	if (node == NULL || atomic_load_explicit(&node->refs, memory_order_acquire) == 1)
+		return node;
+
+	SetNode copy = malloc(sizeof(*copy));
+	copy->left = node->left;
+	copy->right = node->right;
+	copy->value = node->value;
+	copy->height = node->height;
+	copy->size = node->size;
+	atomic_init(&copy->refs, 1);
+
+	node_retain(copy->left);
+	node_retain(copy->right);
+	node_release(node);
+
+	return copy;
+}
+
+
+//// Συναρτήσεις που υλοποιούν επιπλέον λειτουργίες του AVL σε σχέση με ένα απλό BST /////////////////////////////////////
+
+// Επιστρέφει τη max τιμή μεταξύ 2 ακεραίων
+
+static int int_max(int a, int b) {
+	return (a > b) ? a : b ;
+}
+
+// Επιστρέφει το ύψος που βρίσκεται ο κόμβος στο δέντρο
+
+static int node_height(SetNode node) {
+	if (!node) return 0;
+	return node->height;
+}
+
+// Επιστρέφει το μέγεθος του υποδέντρου με ρίζα node (0 για κενό υποδέντρο)
+
+static int node_size(SetNode node) {
+	return node != NULL ? node->size : 0;
+}
+
+// Ενημερώνει το ύψος ενός κόμβου
+
+static void node_update_height(SetNode node) {
+	node->height = 1 + int_max(node_height(node->left), node_height(node->right));
+}
+
+// Επιστρέφει τη διαφορά ύψους μεταξύ αριστερού και δεξιού υπόδεντρου
+
+static int node_balance(SetNode node) {
+	return node_height(node->left) - node_height(node->right);
+}
+
+// Rotations : Όταν η διαφορά ύψους μεταξύ αριστερού και δεξιού υπόδεντρου είναι
+// μεγαλύτερη του 1 το δέντρο δεν είναι πια AVL. Υπάρχουν 4 διαφορετικά
+// rotations που εφαρμόζονται ανάλογα με την περίπτωση για να αποκατασταθεί η
+// ισορροπία. Η κάθε συνάρτηση παίρνει ως όρισμα τον κόμβο που πρέπει να γίνει
+// rotate (ο οποίος πρέπει να μπορεί να αλλάξει επιτόπου), και επιστρέφει τη ρίζα
+// του νέου υποδέντρου. Ο κόμβος που ανεβαίνει αλλάζει, οπότε αντιγράφεται αν χρειάζεται.
+
+// Single left rotation
+
+static SetNode node_rotate_left(SetNode node) {
+	ADT_STATS_EVENT(ADT_EVENT_SET_ROTATION, 1);
+
+	SetNode right_node = node->right = node_mutable(node->right);
+	SetNode left_subtree = right_node->left;
+
+	right_node->size = node->size;
+	node->size = node_size(node->left) + node_size(left_subtree) + 1;
+
+	right_node->left = node;
+	node->right = left_subtree;
+
+	node_update_height(node);
+	node_update_height(right_node);
+
+	return right_node;
+}
+
+// Single right rotation
+
+static SetNode node_rotate_right(SetNode node) {
+	ADT_STATS_EVENT(ADT_EVENT_SET_ROTATION, 1);
+
+	SetNode left_node = node->left = node_mutable(node->left);
+	SetNode left_right = left_node->right;
+
+	left_node->size = node->size;
+	node->size = node_size(node->right) + node_size(left_right) + 1;
+
+	left_node->right = node;
+	node->left = left_right;
+
+	node_update_height(node);
+	node_update_height(left_node);
+
+	return left_node;
+}
+
+// Double left-right rotation
+
+static SetNode node_rotate_left_right(SetNode node) {
+	node->left = node_rotate_left(node_mutable(node->left));
+	return node_rotate_right(node);
+}
+
+// Double right-left rotation
+
+static SetNode node_rotate_right_left(SetNode node) {
+	node->right = node_rotate_right(node_mutable(node->right));
+	return node_rotate_left(node);
+}
+
+// Επισκευή του AVL property αν δεν ισχύει
+
+static SetNode node_repair_balance(SetNode node) {
+	node_update_height(node);
+
+	int balance = node_balance(node);
+	if (balance > 1) {
+		// το αριστερό υπόδεντρο είναι unbalanced
+		if (node_balance(node->left) >= 0)
+			return node_rotate_right(node);
+		else
+			return node_rotate_left_right(node);
+
+	} else if (balance < -1) {
+		// το δεξί υπόδεντρο είναι unbalanced
+		if (node_balance(node->right) <= 0)
+			return node_rotate_left(node);
+		else
+			return node_rotate_right_left(node);
+	}
+
+	// δεν χρειάστηκε να πραγματοποιηθεί rotation
+	return node;
+}
+
+
+//// Συναρτήσεις που είναι (σχεδόν) _ολόιδιες_ με τις αντίστοιχες της AVL υλοποίησης ////////////////
+//
+// Οι διαφορές είναι ότι κάθε κόμβος περνάει από τη node_mutable πριν αλλάξει, και ότι ο
+// επόμενος/προηγούμενος βρίσκεται με κατάβαση από τη ρίζα (δεν υπάρχουν δείκτες στους πατέρες).
+
+// Δημιουργεί και επιστρέφει έναν κόμβο με τιμή value (χωρίς παιδιά)
+
+static SetNode node_create(Pointer value) {
+	SetNode node = malloc(sizeof(*node));
+	node->left = NULL;
+	node->right = NULL;
+	node->value = value;
+	node->height = 1;
+	node->size = 1;
+	atomic_init(&node->refs, 1);
+	return node;
+}
+
+// Επιστρέφει τον κόμβο με τιμή ίση με value στο υποδέντρο με ρίζα node, διαφορετικά NULL
+
+static SetNode node_find_equal(SetNode node, CompareFunc compare, Pointer value) {
+	while (node != NULL) {
+		int compare_res = compare(value, node->value);
+		if (compare_res == 0)
+			return node;
+		node = (compare_res < 0) ? node->left : node->right;
+	}
+	return NULL;
+}
+
+// Επιστρέφει τον μικρότερο κόμβο του υποδέντρου με ρίζα node
+
+static SetNode node_find_min(SetNode node) {
+	return node != NULL && node->left != NULL
+		? node_find_min(node->left)				// Υπάρχει αριστερό υποδέντρο, η μικρότερη τιμή βρίσκεται εκεί
+		: node;									// Αλλιώς η μικρότερη τιμή είναι στο ίδιο το node
+}
+
+// Επιστρέφει τον μεγαλύτερο κόμβο του υποδέντρου με ρίζα node
+
+static SetNode node_find_max(SetNode node) {
+	return node != NULL && node->right != NULL
+		? node_find_max(node->right)			// Υπάρχει δεξί υποδέντρο, η μεγαλύτερη τιμή βρίσκεται εκεί
+		: node;									// Αλλιώς η μεγαλύτερη τιμή είναι στο ίδιο το node
+}
+
+// Επιστρέφει τον προηγούμενο (στη σειρά διάταξης) του κόμβου target στο υποδέντρο με
+// ρίζα node, ή NULL αν ο target είναι ο μικρότερος του υποδέντρου.
+
+static SetNode node_find_previous(SetNode node, CompareFunc compare, SetNode target) {
+	// Αν υπάρχει αριστερό υποδέντρο, o προηγούμενος είναι ο μεγαλύτερος κόμβος του
+	if (target->left != NULL)
+		return node_find_max(target->left);
+
+	// Αλλιώς είναι ο τελευταίος κόμβος στην κατάβαση προς τον target από τον οποίο πήγαμε δεξιά
+	SetNode previous = NULL;
+	while (node != target) {
+		if (compare(target->value, node->value) < 0) {
+			node = node->left;
+		} else {
+			previous = node;
+			node = node->right;
+		}
+	}
+	return previous;
+}
+
+// Επιστρέφει τον επόμενο (στη σειρά διάταξης) του κόμβου target στο υποδέντρο με
+// ρίζα node, ή NULL αν ο target είναι ο μεγαλύτερος του υποδέντρου.
+
+static SetNode node_find_next(SetNode node, CompareFunc compare, SetNode target) {
+	// Αν υπάρχει δεξί υποδέντρο, o επόμενος είναι ο μικρότερος κόμβος του
+	if (target->right != NULL)
+		return node_find_min(target->right);
+
+	// Αλλιώς είναι ο τελευταίος κόμβος στην κατάβαση προς τον target από τον οποίο πήγαμε αριστερά
+	SetNode next = NULL;
+	while (node != target) {
+		if (compare(target->value, node->value) < 0) {
+			next = node;
+			node = node->left;
+		} else {
+			node = node->right;
+		}
+	}
+	return next;
+}
+
+// Αν υπάρχει κόμβος με τιμή ισοδύναμη της value, αλλάζει την τιμή του σε value, διαφορετικά προσθέτει
+// νέο κόμβο με τιμή value. Επιστρέφει τη νέα ρίζα του υποδέντρου, και θέτει το *inserted σε true
+// αν έγινε προσθήκη, ή false αν έγινε ενημέρωση.
+
+static SetNode node_insert(SetNode node, CompareFunc compare, Pointer value, bool* inserted, Pointer* old_value) {
+	// Αν το υποδέντρο είναι κενό, δημιουργούμε νέο κόμβο ο οποίος γίνεται ρίζα του υποδέντρου
+	if (node == NULL) {
+		*inserted = true;			// κάναμε προσθήκη
+		return node_create(value);
+	}
+
+	// Ο κόμβος θα αλλάξει σε κάθε περίπτωση (τιμή, μέγεθος ή παιδί)
+	node = node_mutable(node);
+
+	int compare_res = compare(value, node->value);
+	if (compare_res == 0) {
+		// βρήκαμε ισοδύναμη τιμή, κάνουμε update
+		*inserted = false;
+		*old_value = node->value;
+		node->value = value;
+		return node;
+
+	} else if (compare_res < 0) {
+		// value < node->value, συνεχίζουμε αριστερά.
+		node->left = node_insert(node->left, compare, value, inserted, old_value);
+
+	} else {
+		// value > node->value, συνεχίζουμε δεξιά
+		node->right = node_insert(node->right, compare, value, inserted, old_value);
+	}
+
+	if (*inserted) {
+		node->size++;
+	}
+
+	return node_repair_balance(node);	// AVL
+}
+
+// Αφαιρεί και αποθηκεύει στο min_node τον μικρότερο κόμβο του υποδέντρου με ρίζα node.
+// Επιστρέφει τη νέα ρίζα του υποδέντρου. Ο min_node επιστρέφεται έτοιμος να αλλάξει επιτόπου.
+
+static SetNode node_remove_min(SetNode node, SetNode* min_node) {
+	node = node_mutable(node);
+
+	if (node->left == NULL) {
+		// Δεν έχουμε αριστερό υποδέντρο, οπότε ο μικρότερος είναι ο ίδιος ο node
+		*min_node = node;
+		return node->right;		// νέα ρίζα είναι το δεξιό παιδί
+
+	} else {
+		// Εχουμε αριστερό υποδέντρο, οπότε η μικρότερη τιμή είναι εκεί. Συνεχίζουμε αναδρομικά
+		// και ενημερώνουμε το node->left με τη νέα ρίζα του υποδέντρου.
+		node->size--;
+		node->left = node_remove_min(node->left, min_node);
+
+		return node_repair_balance(node);	// AVL
+	}
+}
+
+// Διαγράφει το κόμβο με τιμή ισοδύναμη της value, ο οποίος πρέπει να υπάρχει στο υποδέντρο.
+// Επιστρέφει τη νέα ρίζα του υποδέντρου. Η αναζήτηση γίνεται πριν (στη set_remove) ώστε να μην
+// αντιγράφονται κόμβοι αν δεν υπάρχει η τιμή.
+
+static SetNode node_remove(SetNode node, CompareFunc compare, Pointer value, Pointer* old_value) {
+	node = node_mutable(node);
+
+	int compare_res = compare(value, node->value);
+	if (compare_res == 0) {
+		*old_value = node->value;
+
+		// Τα παιδιά του node περνάνε στον κόμβο που παίρνει τη θέση του, οπότε ο node
+		// απελευθερώνεται χωρίς node_release (που θα άφηνε και τις αναφορές στα παιδιά)
+		if (node->left == NULL) {
+			SetNode right = node->right;	// αποθήκευση πριν το free!
+			free(node);
+			return right;
+
+		} else if (node->right == NULL) {
+			SetNode left = node->left;		// αποθήκευση πριν το free!
+			free(node);
+			return left;
+
+		} else {
+			// Υπάρχουν και τα δύο παιδιά. Στη θέση του node μπαίνει ο μικρότερος κόμβος του δεξιού υποδέντρου.
+			SetNode min_right;
+			node->right = node_remove_min(node->right, &min_right);
+
+			min_right->left = node->left;
+			min_right->right = node->right;
+			min_right->size = node->size - 1;
+
+			free(node);
+
+			return node_repair_balance(min_right);	// AVL
+		}
+	}
+
+	// compare_res != 0, συνεχίζουμε στο αριστερό ή δεξί υποδέντρο, η ρίζα δεν αλλάζει.
+	node->size--;
+	if (compare_res < 0)
+		node->left = node_remove(node->left, compare, value, old_value);
+	else
+		node->right = node_remove(node->right, compare, value, old_value);
+
+	return node_repair_balance(node);	// AVL
+}
+
+// Καλεί τη destroy_value για κάθε τιμή του υποδέντρου με ρίζα node
+
+static void node_destroy_values(SetNode node, DestroyFunc destroy_value) {
+	if (node == NULL)
+		return;
+
+	node_destroy_values(node->left, destroy_value);
+	node_destroy_values(node->right, destroy_value);
+	destroy_value(node->value);
+}
+
+
+//// Συναρτήσεις του ADT Set. Γενικά πολύ απλές, αφού καλούν τις αντίστοιχες node_* //////////////////////////////////
+
+Set set_create(CompareFunc compare, DestroyFunc destroy_value) {
+	assert(compare != NULL);	// LCOV_EXCL_LINE
+
+	// δημιουργούμε το stuct
+	Set set = malloc(sizeof(*set));
+	set->root = NULL;			// κενό δέντρο
+	set->size = 0;
+	set->compare = compare;
+	set->destroy_value = destroy_value;
+
+	return set;
+}
+
+// Δημιουργεί ένα ισοζυγισμένο δέντρο από τις size ταξινομημένες τιμές values, με ρίζα
+// τη μεσαία τιμή. Τα ύψη των δύο υποδέντρων κάθε κόμβου διαφέρουν το πολύ κατά 1.
+
+static SetNode node_create_from_sorted(Pointer values[], int size) {
+	if (size == 0)
+		return NULL;
+
+	int middle = size / 2;
+	SetNode node = node_create(values[middle]);
+	node->left = node_create_from_sorted(values, middle);
+	node->right = node_create_from_sorted(values + middle + 1, size - middle - 1);
+	node->size = size;
+	node_update_height(node);
+	return node;
+}
+
+Set set_create_from_sorted(CompareFunc compare, DestroyFunc destroy_value, Pointer values[], int size) {
+	Set set = set_create(compare, destroy_value);
+	set->root = node_create_from_sorted(values, size);
+	set->size = size;
+	return set;
+}
+
+int set_size(Set set) {
+	return set->size;
+}
+
+void set_insert(Set set, Pointer value) {
+	bool inserted;
+	Pointer old_value;
+	set->root = node_insert(set->root, set->compare, value, &inserted, &old_value);
+
+	// Το size αλλάζει μόνο αν μπει νέος κόμβος. Στα updates κάνουμε destroy την παλιά τιμή
+	if (inserted) {
+		set->size++;
+	}
+	else if (set->destroy_value != NULL) {
+		set->destroy_value(old_value);
+	}
+}
+
+bool set_remove(Set set, Pointer value) {
+	// Αν δεν υπάρχει η τιμή δεν αλλάζει τίποτα (ούτε αντιγράφονται κόμβοι)
+	if (node_find_equal(set->root, set->compare, value) == NULL)
+		return false;
+
+	Pointer old_value;
+	set->root = node_remove(set->root, set->compare, value, &old_value);
+	set->size--;
+
+	if (set->destroy_value != NULL)
+		set->destroy_value(old_value);
+
+	return true;
+}
+
+Pointer set_find(Set set, Pointer value) {
+	SetNode node = node_find_equal(set->root, set->compare, value);
+	return node == NULL ? NULL : node->value;
+}
+
+DestroyFunc set_set_destroy_value(Set vec, DestroyFunc destroy_value) {
+	DestroyFunc old = vec->destroy_value;
+	vec->destroy_value = destroy_value;
+	return old;
+}
+
+void set_destroy(Set set) {
+	if (set->destroy_value != NULL)
+		node_destroy_values(set->root, set->destroy_value);
+
+	// Οι κόμβοι απελευθερώνονται μόνο αν δεν τους χρησιμοποιεί κάποιο snapshot
+	node_release(set->root);
+	free(set);
+}
+
+Set set_snapshot(Set set) {
+	// Το snapshot μοιράζεται ολόκληρο το δέντρο. Οι επόμενες αλλαγές σε οποιοδήποτε από τα
+	// δύο sets θα αντιγράψουν τους κόμβους που αλλάζουν.
+	Set snapshot = set_create(set->compare, NULL);
+	snapshot->root = set->root;
+	snapshot->size = set->size;
+	node_retain(snapshot->root);
+
+	return snapshot;
+}
+
+SetNode set_first(Set set) {
+	return node_find_min(set->root);
+}
+
+SetNode set_last(Set set) {
+	return node_find_max(set->root);
+}
+
+SetNode set_previous(Set set, SetNode node) {
+	return node_find_previous(set->root, set->compare, node);
+}
+
+SetNode set_next(Set set, SetNode node) {
+	return node_find_next(set->root, set->compare, node);
+}
+
+Pointer set_node_value(Set set, SetNode node) {
+	return node->value;
+}
+
+SetNode set_find_node(Set set, Pointer value) {
+	return node_find_equal(set->root, set->compare, value);
+}
+
+SetNode set_lower_bound(Set set, Pointer value) {
+	// Κρατάμε τον τελευταίο κόμβο >= value που συναντήσαμε στην κατάβαση
+	SetNode result = SET_EOF;
+	SetNode node = set->root;
+	while (node != NULL) {
+		int compare_res = set->compare(node->value, value);
+		if (compare_res == 0) {
+			return node;
+		} else if (compare_res > 0) {
+			// Ο node είναι υποψήφιος, αλλά μπορεί να υπάρχει μικρότερος στο αριστερό υποδέντρο
+			result = node;
+			node = node->left;
+		} else {
+			node = node->right;
+		}
+	}
+	return result;
+}
+
+
+
+// Συναρτήσεις που δεν υπάρχουν στο public interface αλλά χρησιμοποιούνται στα tests
+// Ελέγχουν ότι το δέντρο είναι ένα σωστό AVL.
+
+// LCOV_EXCL_START (δε μας ενδιαφέρει το coverage των test εντολών, και επιπλέον μόνο τα true branches εξετάζονται σε ένα επιτυχημένο test)
+
+bool node_is_avl(SetNode node, CompareFunc compare) {
+	if (node == NULL)
+		return true;
+
+	// Ελέγχουμε την ιδιότητα:
+	// κάθε κόμβος είναι > αριστερό παιδί, > δεξιότερο κόμβο του αριστερού υποδέντρου, < δεξί παιδί, < αριστερότερο κόμβο του δεξιού υποδέντρου.
+	// Είναι ισοδύναμη με την BST ιδιότητα (κάθε κόμβος είναι > αριστερό υποδέντρο και < δεξί υποδέντρο) αλλά ευκολότερο να ελεγθεί.
+	bool res = true;
+	if(node->left != NULL)
+		res = res && compare(node->left->value, node->value) < 0 && compare(node_find_max(node->left)->value, node->value) < 0;
+	if(node->right != NULL)
+		res = res && compare(node->right->value, node->value) > 0 && compare(node_find_min(node->right)->value, node->value) > 0;
+
+	// Κάθε κόμβος έχει τουλάχιστον μία αναφορά
+	res = res && atomic_load(&node->refs) >= 1;
+
+	// Το μέγεθος του υποδέντρου είναι σωστό
+	res = res && node->size == 1 + node_size(node->left) + node_size(node->right);
+
+	// Το ύψος είναι σωστό
+	res = res && node->height == 1 + int_max(node_height(node->left), node_height(node->right));
+
+	// Ο κόμβος έχει την AVL ιδιότητα
+	int balance = node_balance(node);
+	res = res && balance >= -1 && balance <= 1;
+
+	// Τα υποδέντρα είναι σωστά
+	res = res &&
+		node_is_avl(node->left, compare) &&
+		node_is_avl(node->right, compare);
+
+	return res;
+}
+
+bool set_is_proper(Set node) {
+	return node_size(node->root) == node->size && node_is_avl(node->root, node->compare);
+}
+
+// LCOV_EXCL_STOP
+
+// Επιστρέφει μια λίστα με τα στοιχεία από το from μέχρι το to (σύμφωνα με την compare) με πολυπλοκότητα O(logn)
+// (σε αυτήν την υλοποίηση) για σταθερό m, με n όλα τα στοιχεία και m αυτά που θα επιστραφούν.
+// Αν from ή to είναι NULL δεν τίθεται κάτω ή πάνω όριο, αντίστοιχα.
+
+static void node_return_from_to(Set set, SetNode node, Pointer from, Pointer to, List list) {
+	// Σταματάμε αν φτάσουμε στον "πάτο"
+	if (node == NULL) {
+		return;
+	}
+	// Κατεβαίνουμε δεξιά μόνο αν δεν έχουμε φτάσει το πάνω όριο
+	if ((to == NULL) || (set->compare(node->value, to) < 0)) {
+		node_return_from_to(set, node->right, from, to, list);
+	}
+	// Αν ο κόμβος είναι μέσα στα όριο προστίθεται στην λίστα
+	if (((from == NULL) || (set->compare(node->value, from) >= 0)) && ((to == NULL) || (set->compare(node->value, to) <= 0))) {
+		list_insert_next(list, LIST_BOF, node->value);
+	}
+	// Κατεβαίνουμε αριστερά μόνο αν δεν έχουμε φτάσει το κάτω όριο
+	if ((from == NULL) || (set->compare(node->value, from) > 0)) {
+		node_return_from_to(set, node->left, from, to, list);
+	}
+}
+
+List set_return_from_to(Set set, Pointer from, Pointer to) {
+	List list = list_create(NULL);
+
+	// Καλούμε την αντίστοιχη αναδρομική συνάρτηση για την ρίζα και της δίνουμε την λίστα
+	node_return_from_to(set, set->root, from, to, list);
+	return list;
+}
+
+void set_visit(Set set, VisitFunc visit) {
+	for (SetNode node = set_first(set); node != SET_EOF; node = set_next(set, node))
+		visit(node->value);
+}
+
+//// Συναρτήσεις διάταξης (order statistics) ////////////////////////////////////////////////
+//
+// Βασίζονται στο size κάθε κόμβου, οπότε αρκεί μία κατάβαση από τη ρίζα.
+
+SetNode set_select(Set set, int k) {
+	if (k < 0 || k >= set->size)
+		return SET_EOF;
+
+	SetNode node = set->root;
+	while (node != NULL) {
+		int left_size = node_size(node->left);
+		if (k < left_size) {
+			node = node->left;
+		} else if (k == left_size) {
+			return node;
+		} else {
+			k -= left_size + 1;
+			node = node->right;
+		}
+	}
+	return SET_EOF;		// LCOV_EXCL_LINE (δεν φτάνει ποτέ εδώ αφού 0 <= k < size)
+}
+
+int set_rank(Set set, Pointer value) {
+	int rank = 0;
+	SetNode node = set->root;
+	while (node != NULL) {
+		int compare_res = set->compare(node->value, value);
+		if (compare_res < 0) {
+			rank += node_size(node->left) + 1;
+			node = node->right;
+		} else if (compare_res == 0) {
+			return rank + node_size(node->left);
+		} else {
+			node = node->left;
+		}
+	}
+	return rank;
+}
+
+int set_count_greater_than(Set set, Pointer max) {
+	// Τα στοιχεία > max είναι όσα δεν είναι <= max
+	return set->size - set_rank(set, max) - (node_find_equal(set->root, set->compare, max) != NULL);
+}
+
+int set_count_less_than(Set set, Pointer min) {
+	return set_rank(set, min);
+}
+
+// Μετράει τα στοιχεία του υποδέντρου με ρίζα node που είναι >= from (όλα, αν from == NULL)
+
+static int node_count_from(SetNode node, CompareFunc compare, Pointer from) {
+	if (from == NULL)
+		return node_size(node);
+
+	int count = 0;
+	while (node != NULL) {
+		if (compare(node->value, from) >= 0) {
+			count += node_size(node->right) + 1;
+			node = node->left;
+		} else {
+			node = node->right;
+		}
+	}
+	return count;
+}
+
+// Μετράει τα στοιχεία του υποδέντρου με ρίζα node που είναι <= to (όλα, αν to == NULL)
+
+static int node_count_to(SetNode node, CompareFunc compare, Pointer to) {
+	if (to == NULL)
+		return node_size(node);
+
+	int count = 0;
+	while (node != NULL) {
+		if (compare(node->value, to) <= 0) {
+			count += node_size(node->left) + 1;
+			node = node->right;
+		} else {
+			node = node->left;
+		}
+	}
+	return count;
+}
+
+int set_range_count(Set set, Pointer from, Pointer to) {
+	// Κατεβαίνουμε μέχρι τον πρώτο κόμβο που βρίσκεται μέσα στα όρια. Από εκεί και πέρα
+	// τα όρια "χωρίζονται": το from αφορά μόνο το αριστερό υποδέντρο και το to μόνο το δεξί.
+	SetNode node = set->root;
+	while (node != NULL) {
+		if (from != NULL && set->compare(node->value, from) < 0)
+			node = node->right;
+		else if (to != NULL && set->compare(node->value, to) > 0)
+			node = node->left;
+		else
+			break;
+	}
+
+	// Κανένα στοιχείο μέσα στα όρια
+	if (node == NULL)
+		return 0;
+
+	return 1 + node_count_from(node->left, set->compare, from) + node_count_to(node->right, set->compare, to);
+}
@@ -0,0 +1,526 @@
+///////////////////////////////////////////////////////////
+//
+// Υλοποίηση του ADT ConcurrentMap μέσω split-ordered list
+// (Shalev & Shavit).
+//
+// Ολα τα στοιχεία βρίσκονται σε μία lock-free ταξινομημένη λίστα
+// (Harris/Michael), με σειρά τα αντεστραμμένα bits του hash. Ετσι τα
+// κλειδιά κάθε bucket είναι συνεχόμενα στη λίστα, και κάθε bucket είναι
+// απλά ένας δείκτης σε έναν dummy κόμβο στην αρχή των κλειδιών του.
+// Ο διπλασιασμός των buckets δεν μετακινεί κανένα κόμβο: το bucket b + n
+// προστίθεται (την πρώτη φορά που χρειάζεται) ως dummy κόμβος μέσα στα
+// κλειδιά του bucket b.
+//
+// Οι κόμβοι που αφαιρούνται ελευθερώνονται με epoch-based reclamation.
+//
+///////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "ADTConcurrentMap.h"
+
+#define ADT_MODULE ADT_CONCURRENT_MAP
+#include "AdtAlloc.h"			// Τελευταίο include, μετρητές δεσμεύσεων (ADT_ALLOC_STATS)
+
+
+// Κόμβοι της λίστας. Το χαμηλό bit του next είναι 1 όταν ο κόμβος έχει αφαιρεθεί λογικά
+// (και μετά αποσυνδέεται από όποιο thread τον συναντήσει).
+
+typedef struct cmap_node* CMapNode;
+
+struct cmap_node {
+	_Atomic(uintptr_t) next;	// Επόμενος κόμβος, με το bit MARKED
+	uint64_t order;				// Θέση στη λίστα: αντεστραμμένο hash, περιττό για κλειδιά, άρτιο για dummy
+	Pointer key;
+	Pointer value;
+
+	// Μόνο για κόμβους που έχουν αφαιρεθεί (το map μπορεί να έχει καταστραφεί μέχρι το free)
+	CMapNode retired_next;
+	DestroyFunc destroy_key;
+	DestroyFunc destroy_value;
+};
+
+#define MARKED 1
+
+static inline CMapNode node_of(uintptr_t next) {
+	return (CMapNode)(next & ~(uintptr_t)MARKED);
+}
+
+// Τα buckets χωρίζονται σε segments που δεσμεύονται όταν χρειαστούν: το segment 0 έχει
+// το bucket 0, και το segment s > 0 τα buckets [2^(s-1), 2^s). Ετσι ο διπλασιασμός δεν
+// αντιγράφει τίποτα.
+
+typedef _Atomic(CMapNode) Bucket;
+
+#define SEGMENT_NO 33
+#define MIN_BUCKETS 16
+#define MAX_BUCKETS (1u << 31)
+#define MAX_LOAD 2				// Μέσος αριθμός κλειδιών ανά bucket πριν το διπλασιασμό
+
+struct concurrent_map {
+	_Atomic(Bucket*) segments[SEGMENT_NO];
+	_Atomic uint bucket_no;		// Πλήθος buckets σε χρήση (δύναμη του 2)
+	CompareFunc compare;
+	HashFunc hash;
+	DestroyFunc destroy_key;
+	DestroyFunc destroy_value;
+
+	// Σε δική του cache line, ώστε οι αλλαγές του size να μην επηρεάζουν τις αναζητήσεις
+	char padding[64];
+	_Atomic int size;
+};
+
+
+// Epochs
+//
+// Ενας global μετρητής epoch, και για κάθε thread το epoch στο οποίο βρίσκεται (state =
+// epoch << 1 | active). Το epoch αυξάνεται μόνο όταν όλα τα active threads βρίσκονται στο
+// τρέχον. Ενας κόμβος που αποσυνδέθηκε όταν το epoch ήταν e μπορεί να έχει βρεθεί μόνο από
+// critical sections με epoch <= e, οπότε ελευθερώνεται όταν το epoch γίνει e + 2.
+//
+// Κάθε thread κρατάει τους κόμβους που αφαίρεσε σε 3 λίστες, μία για κάθε epoch mod 3.
+
+#define RETIRE_LISTS 3
+#define RETIRE_BATCH 64			// Ανά τόσες αφαιρέσεις γίνεται προσπάθεια να αυξηθεί το epoch
+
+struct retire_list {
+	CMapNode nodes;
+	uint64_t epoch;
+};
+
+struct epoch_thread {
+	_Atomic uint64_t state;
+	int depth;					// Φωλιασμένα cmap_enter
+	int retired_no;				// Αφαιρέσεις από την τελευταία προσπάθεια αύξησης
+	struct retire_list retired[RETIRE_LISTS];
+	bool in_use;				// Οι εγγραφές threads που έκαναν unregister ξαναχρησιμοποιούνται
+	struct epoch_thread* next;
+	char padding[64];			// Κάθε state σε δική του cache line
+};
+
+static _Atomic uint64_t global_epoch = 0;
+
+// Ολες οι εγγραφές threads (δεν αποδεσμεύονται ποτέ), και οι κόμβοι που δεν είχαν
+// ελευθερωθεί από threads που έκαναν unregister. Προστατεύονται από το registry_lock.
+
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct epoch_thread* threads = NULL;
+static struct retire_list orphans[RETIRE_LISTS];
+
+static _Thread_local struct epoch_thread* self = NULL;
+
+static void free_nodes(CMapNode node) {
+	while (node != NULL) {
+		CMapNode next = node->retired_next;
+		if (node->destroy_key != NULL)
+			node->destroy_key(node->key);
+		if (node->destroy_value != NULL)
+			node->destroy_value(node->value);
+		free(node);
+		node = next;
+	}
+}
+
+// Ελευθερώνει τις λίστες που έχουν αφαιρεθεί τουλάχιστον 2 epochs πριν το epoch
+
+static void reclaim(struct retire_list* lists, uint64_t epoch) {
+	for (int i = 0; i < RETIRE_LISTS; i++) {
+		if (lists[i].nodes != NULL && lists[i].epoch + 2 <= epoch) {
+			free_nodes(lists[i].nodes);
+			lists[i].nodes = NULL;
+		}
+	}
+}
+
+// Προσθέτει τη λίστα from (με κόμβους του epoch from->epoch) στη λίστα to του ίδιου epoch mod 3
+
+static void retire_list_append(struct retire_list* to, struct retire_list* from) {
+	if (from->nodes == NULL)
+		return;
+
+	CMapNode last = from->nodes;
+	while (last->retired_next != NULL)
+		last = last->retired_next;
+	last->retired_next = to->nodes;
+	to->nodes = from->nodes;
+
+	// Το μεγαλύτερο epoch, ώστε να μην ελευθερωθεί κανένας κόμβος νωρίτερα
+	if (from->epoch > to->epoch)
+		to->epoch = from->epoch;
+	from->nodes = NULL;
+}
+
+// Αυξάνει το epoch αν όλα τα active threads βρίσκονται στο τρέχον. Επιστρέφει true αν αυξήθηκε.
+
+static bool epoch_try_advance() {
+	pthread_mutex_lock(&registry_lock);
+
+	uint64_t epoch = atomic_load(&global_epoch);
+	bool advance = true;
+	for (struct epoch_thread* thread = threads; thread != NULL && advance; thread = thread->next) {
+		uint64_t state = atomic_load(&thread->state);
+		advance = !(state & 1) || state >> 1 == epoch;
+	}
+	if (advance) {
+		atomic_store(&global_epoch, epoch + 1);
+		reclaim(orphans, epoch + 1);
+	}
+
+	pthread_mutex_unlock(&registry_lock);
+	return advance;
+}
+
+void cmap_thread_register() {
+	assert(self == NULL);		// LCOV_EXCL_LINE
+
+	pthread_mutex_lock(&registry_lock);
+
+	struct epoch_thread* thread = threads;
+	while (thread != NULL && thread->in_use)
+		thread = thread->next;
+
+	if (thread == NULL) {
+		thread = calloc(1, sizeof(*thread));
+		thread->next = threads;
+		threads = thread;
+	}
+	thread->in_use = true;
+	atomic_store(&thread->state, 0);
+
+	pthread_mutex_unlock(&registry_lock);
+	self = thread;
+}
+
+void cmap_thread_unregister() {
+	struct epoch_thread* thread = self;
+	assert(thread != NULL && thread->depth == 0);		// LCOV_EXCL_LINE
+
+	pthread_mutex_lock(&registry_lock);
+
+	// Οι κόμβοι που δεν έχουν ελευθερωθεί ακόμα περνάνε στα orphans
+	for (int i = 0; i < RETIRE_LISTS; i++)
+		retire_list_append(&orphans[i], &thread->retired[i]);
+	thread->retired_no = 0;
+	thread->in_use = false;
+
+	pthread_mutex_unlock(&registry_lock);
+	self = NULL;
+}
+
+void cmap_enter() {
+	struct epoch_thread* thread = self;
+	assert(thread != NULL);		// LCOV_EXCL_LINE
+
+	if (thread->depth++ > 0)
+		return;
+
+	uint64_t epoch = atomic_load(&global_epoch);
+	atomic_store(&thread->state, epoch << 1 | 1);
+	reclaim(thread->retired, epoch);
+}
+
+void cmap_leave() {
+	struct epoch_thread* thread = self;
+	if (--thread->depth > 0)
+		return;
+
+	uint64_t state = atomic_load_explicit(&thread->state, memory_order_relaxed);
+	atomic_store_explicit(&thread->state, state & ~(uint64_t)1, memory_order_release);
+}
+
+void cmap_synchronize() {
+	struct epoch_thread* thread = self;
+	assert(thread != NULL && thread->depth == 0);		// LCOV_EXCL_LINE
+
+	// Μετά από 2 αυξήσεις κανένα critical section δεν έχει ξεκινήσει πριν την κλήση
+	uint64_t target = atomic_load(&global_epoch) + 2;
+	while (atomic_load(&global_epoch) < target)
+		if (!epoch_try_advance())
+			sched_yield();
+
+	reclaim(thread->retired, atomic_load(&global_epoch));
+	thread->retired_no = 0;
+}
+
+// Ο κόμβος έχει αποσυνδεθεί από τη λίστα, θα ελευθερωθεί όταν δεν μπορεί να τον διαβάζει κανείς.
+// Καλείται μέσα σε critical section.
+
+static void retire(ConcurrentMap map, CMapNode node) {
+	struct epoch_thread* thread = self;
+	node->destroy_key = map->destroy_key;
+	node->destroy_value = map->destroy_value;
+
+	// Η λίστα του epoch mod 3 μπορεί να έχει κόμβους του epoch - 3 (ή παλαιότερους), που
+	// ελευθερώνονται πρώτα
+	uint64_t epoch = atomic_load(&global_epoch);
+	struct retire_list* list = &thread->retired[epoch % RETIRE_LISTS];
+	if (list->nodes != NULL && list->epoch != epoch) {
+		free_nodes(list->nodes);
+		list->nodes = NULL;
+	}
+	node->retired_next = list->nodes;
+	list->nodes = node;
+	list->epoch = epoch;
+
+	if (++thread->retired_no >= RETIRE_BATCH) {
+		thread->retired_no = 0;
+		epoch_try_advance();
+	}
+}
+
+
+// Σειρά στη λίστα
+
+static uint reverse_bits(uint value) {
+	value = ((value >> 1) & 0x55555555) | ((value & 0x55555555) << 1);
+	value = ((value >> 2) & 0x33333333) | ((value & 0x33333333) << 2);
+	value = ((value >> 4) & 0x0F0F0F0F) | ((value & 0x0F0F0F0F) << 4);
+	return __builtin_bswap32(value);
+}
+
+static uint64_t key_order(uint hash) {
+	return (uint64_t)reverse_bits(hash) << 1 | 1;
+}
+
+static uint64_t dummy_order(uint bucket) {
+	return (uint64_t)reverse_bits(bucket) << 1;
+}
+
+// Το bucket είναι τα χαμηλά bits του hash, οπότε το hash του χρήστη αναμειγνύεται ξανά
+// (όπως στο UsingSwissTable), για να δουλεύουν και συναρτήσεις όπως το id μιας εγγραφής.
+
+static uint mix_hash(ConcurrentMap map, Pointer key) {
+	return ((uint64_t)map->hash(key) * 0x9E3779B97F4A7C15ULL) >> 32;
+}
+
+static CMapNode node_create(uint64_t order, Pointer key, Pointer value) {
+	CMapNode node = malloc(sizeof(*node));
+	atomic_init(&node->next, 0);
+	node->order = order;
+	node->key = key;
+	node->value = value;
+	return node;
+}
+
+
+// Λίστα
+//
+// Η list_find ψάχνει, ξεκινώντας από τον dummy κόμβο head, τον κόμβο με το order (και για
+// κλειδιά ισοδύναμο με key). Αν βρεθεί επιστρέφει true και τον κόμβο στο *curr. Αλλιώς
+// επιστρέφει false, και το *curr είναι ο πρώτος κόμβος μετά τη θέση του κλειδιού (ή NULL).
+// Σε κάθε περίπτωση το *prev είναι το next του προηγούμενου κόμβου. Οσους κόμβους έχουν
+// αφαιρεθεί λογικά τους αποσυνδέει.
+
+static bool list_find(ConcurrentMap map, CMapNode head, uint64_t order, Pointer key,
+	_Atomic(uintptr_t)** prev_out, CMapNode* curr_out) {
+
+retry:;
+	_Atomic(uintptr_t)* prev = &head->next;
+	CMapNode curr = node_of(atomic_load(prev));
+
+	while (curr != NULL) {
+		uintptr_t next = atomic_load(&curr->next);
+
+		if (next & MARKED) {
+			// Αν το prev έχει αλλάξει (πχ αφαιρέθηκε και ο προηγούμενος κόμβος) ξεκινάμε από την αρχή
+			uintptr_t expected = (uintptr_t)curr;
+			if (!atomic_compare_exchange_strong(prev, &expected, next & ~(uintptr_t)MARKED))
+				goto retry;
+			retire(map, curr);
+			curr = node_of(next);
+			continue;
+		}
+
+		if (curr->order > order)
+			break;
+
+		// Τα dummies έχουν άρτιο order, μοναδικό για κάθε bucket
+		if (curr->order == order && (!(order & 1) || map->compare(curr->key, key) == 0)) {
+			*prev_out = prev;
+			*curr_out = curr;
+			return true;
+		}
+
+		prev = &curr->next;
+		curr = node_of(next);
+	}
+
+	*prev_out = prev;
+	*curr_out = curr;
+	return false;
+}
+
+// Προσθέτει τον node μετά το head, αν δεν υπάρχει ήδη ισοδύναμος κόμβος. Επιστρέφει
+// τον κόμβο που βρίσκεται πλέον στη λίστα (τον node ή τον υπάρχοντα).
+
+static CMapNode list_insert(ConcurrentMap map, CMapNode head, CMapNode node) {
+	_Atomic(uintptr_t)* prev;
+	CMapNode curr;
+
+	while (true) {
+		if (list_find(map, head, node->order, node->key, &prev, &curr))
+			return curr;
+
+		atomic_store_explicit(&node->next, (uintptr_t)curr, memory_order_relaxed);
+		uintptr_t expected = (uintptr_t)curr;
+		if (atomic_compare_exchange_strong(prev, &expected, (uintptr_t)node))
+			return node;
+	}
+}
+
+static bool list_remove(ConcurrentMap map, CMapNode head, uint64_t order, Pointer key) {
+	_Atomic(uintptr_t)* prev;
+	CMapNode curr;
+
+	while (true) {
+		if (!list_find(map, head, order, key, &prev, &curr))
+			return false;
+
+		// Λογική αφαίρεση: μόνο ένα thread μπορεί να σημειώσει τον κόμβο
+		uintptr_t next = atomic_load(&curr->next);
+		if (next & MARKED)
+			continue;
+		if (!atomic_compare_exchange_strong(&curr->next, &next, next | MARKED))
+			continue;
+
+		// Φυσική αφαίρεση. Αν αποτύχει, η list_find τον αποσυνδέει (εκείνη ή κάποιο άλλο thread)
+		uintptr_t expected = (uintptr_t)curr;
+		if (atomic_compare_exchange_strong(prev, &expected, next))
+			retire(map, curr);
+		else
+			list_find(map, head, order, key, &prev, &curr);
+		return true;
+	}
+}
+
+
+// Buckets
+
+static Bucket* bucket_slot(ConcurrentMap map, uint bucket) {
+	int segment = bucket == 0 ? 0 : 32 - __builtin_clz(bucket);
+	uint first = segment == 0 ? 0 : 1u << (segment - 1);
+
+	Bucket* buckets = atomic_load(&map->segments[segment]);
+	if (buckets == NULL) {
+		Bucket* new_buckets = calloc(segment == 0 ? 1 : first, sizeof(Bucket));
+		if (atomic_compare_exchange_strong(&map->segments[segment], &buckets, new_buckets))
+			buckets = new_buckets;
+		else
+			free(new_buckets);		// Το δέσμευσε ταυτόχρονα άλλο thread
+	}
+	return &buckets[bucket - first];
+}
+
+// Επιστρέφει τον dummy κόμβο του bucket. Την πρώτη φορά τον προσθέτει στη λίστα, μέσα στα
+// κλειδιά του "πατέρα" του (το bucket χωρίς το μεγαλύτερο bit, που έχει αρχικοποιηθεί πρώτο).
+
+static CMapNode bucket_head(ConcurrentMap map, uint bucket) {
+	Bucket* slot = bucket_slot(map, bucket);
+	CMapNode head = atomic_load(slot);
+	if (head != NULL)
+		return head;
+
+	uint parent = bucket & ~(1u << (31 - __builtin_clz(bucket)));
+	CMapNode dummy = node_create(dummy_order(bucket), NULL, NULL);
+
+	head = list_insert(map, bucket_head(map, parent), dummy);
+	if (head != dummy)
+		free(dummy);				// Τον πρόσθεσε ταυτόχρονα άλλο thread, δεν τον έχει δει κανείς
+
+	atomic_store(slot, head);
+	return head;
+}
+
+static CMapNode head_of(ConcurrentMap map, uint hash) {
+	uint bucket_no = atomic_load_explicit(&map->bucket_no, memory_order_acquire);
+	return bucket_head(map, hash & (bucket_no - 1));
+}
+
+
+ConcurrentMap cmap_create(CompareFunc compare, HashFunc hash, DestroyFunc destroy_key, DestroyFunc destroy_value) {
+	ConcurrentMap map = calloc(1, sizeof(*map));
+	map->compare = compare;
+	map->hash = hash;
+	map->destroy_key = destroy_key;
+	map->destroy_value = destroy_value;
+	atomic_init(&map->bucket_no, MIN_BUCKETS);
+
+	// Το bucket 0 έχει πάντα τον πρώτο κόμβο της λίστας
+	atomic_store(bucket_slot(map, 0), node_create(dummy_order(0), NULL, NULL));
+	return map;
+}
+
+int cmap_size(ConcurrentMap map) {
+	return atomic_load_explicit(&map->size, memory_order_relaxed);
+}
+
+bool cmap_insert(ConcurrentMap map, Pointer key, Pointer value) {
+	cmap_enter();
+
+	uint hash = mix_hash(map, key);
+	CMapNode node = node_create(key_order(hash), key, value);
+	bool inserted = list_insert(map, head_of(map, hash), node) == node;
+
+	if (inserted) {
+		// Διπλασιασμός των buckets (αν αποτύχει το CAS, το έκανε άλλο thread)
+		int size = atomic_fetch_add_explicit(&map->size, 1, memory_order_relaxed) + 1;
+		uint bucket_no = atomic_load(&map->bucket_no);
+		if ((uint)size > MAX_LOAD * bucket_no && bucket_no < MAX_BUCKETS)
+			atomic_compare_exchange_strong(&map->bucket_no, &bucket_no, 2 * bucket_no);
+	} else {
+		free(node);
+	}
+
+	cmap_leave();
+	return inserted;
+}
+
+bool cmap_remove(ConcurrentMap map, Pointer key) {
+	cmap_enter();
+
+	uint hash = mix_hash(map, key);
+	bool removed = list_remove(map, head_of(map, hash), key_order(hash), key);
+	if (removed)
+		atomic_fetch_sub_explicit(&map->size, 1, memory_order_relaxed);
+
+	cmap_leave();
+	return removed;
+}
+
+Pointer cmap_find(ConcurrentMap map, Pointer key) {
+	cmap_enter();
+
+	uint hash = mix_hash(map, key);
+	_Atomic(uintptr_t)* prev;
+	CMapNode node;
+	Pointer value = list_find(map, head_of(map, hash), key_order(hash), key, &prev, &node) ? node->value : NULL;
+
+	cmap_leave();		// Μετά από αυτό ο node μπορεί να ελευθερωθεί
+	return value;
+}
+
+void cmap_destroy(ConcurrentMap map) {
+	// Η λίστα ξεκινάει από τον dummy του bucket 0 και περιέχει όλους τους κόμβους. Οσοι έχουν
+	// αφαιρεθεί έχουν ήδη αποσυνδεθεί και ανήκουν στα epochs.
+	CMapNode node = atomic_load(bucket_slot(map, 0));
+	while (node != NULL) {
+		CMapNode next = node_of(atomic_load(&node->next));
+		if (node->order & 1) {
+			if (map->destroy_key != NULL)
+				map->destroy_key(node->key);
+			if (map->destroy_value != NULL)
+				map->destroy_value(node->value);
+		}
+		free(node);
+		node = next;
+	}
+
+	for (int i = 0; i < SEGMENT_NO; i++)
+		free(atomic_load(&map->segments[i]));
+	free(map);
+}
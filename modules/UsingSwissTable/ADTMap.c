@@ -0,0 +1,458 @@
+/////////////////////////////////////////////////////////////////////////////
+//
+// Υλοποίηση του ADT Map μέσω Hash Table με open addressing και control bytes
+// (Swiss table)
+//
+// Κάθε θέση (slot) του πίνακα έχει ένα control byte: EMPTY, DELETED, ή για
+// γεμάτη θέση τα 7 bits h2 του hash. Μια αναζήτηση εξετάζει 16 θέσεις τη φορά
+// (ένα group): με SSE2 βρίσκει με μία σύγκριση ποιες έχουν το ίδιο h2, και
+// καλεί την compare μόνο γι' αυτές (η πιθανότητα να ταιριάζει το h2 ενός άλλου
+// κλειδιού είναι 1/128). Αν το group έχει κενή θέση το κλειδί δεν υπάρχει,
+// αλλιώς η αναζήτηση συνεχίζει στο επόμενο group της ακολουθίας.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "ADTMap.h"
+#include "AdtHash.h"
+#include "AdtStats.h"
+
+#define ADT_MODULE ADT_MAP
+#include "AdtAlloc.h"			// Τελευταίο include, μετρητές δεσμεύσεων (ADT_ALLOC_STATS)
+
+#define GROUP_WIDTH 16
+
+// Control bytes. Οι γεμάτες θέσεις έχουν τιμές 0..127, οπότε οι ελεύθερες είναι ακριβώς
+// όσες έχουν το πρώτο bit 1.
+#define CTRL_EMPTY ((int8_t) -128)
+#define CTRL_DELETED ((int8_t) -2)
+
+// Το μέγεθος είναι πάντα δύναμη του 2 και τουλάχιστον ένα group
+#define MIN_CAPACITY GROUP_WIDTH
+
+// Μέγιστος load factor 7/8 (μαζί με τις DELETED θέσεις), οπότε υπάρχει πάντα κάποια EMPTY
+// θέση και κάθε αναζήτηση τερματίζει.
+#define MAX_LOAD(capacity) ((capacity) / 8 * 7)
+
+// Οι θέσεις κρατάνε δείκτες σε κόμβους (και όχι τους ίδιους τους κόμβους), ώστε ένας
+// MapNode να μένει ίδιος στα rehash, όπως και στο UsingHashTable.
+struct map_node {
+	Pointer key;
+	Pointer value;
+	uint hash;			// Το hash του key από την hash function του map
+	int slot;			// Η θέση του κόμβου στον πίνακα (για την map_next και την αφαίρεση)
+};
+
+struct map {
+	int8_t* ctrl;				// capacity + GROUP_WIDTH control bytes, τα τελευταία είναι αντίγραφο των πρώτων
+	MapNode* slots;				// Ο κόμβος κάθε γεμάτης θέσης
+	int capacity;
+	int size;
+	int deleted;				// Πλήθος DELETED θέσεων
+	CompareFunc compare;
+	HashFunc hash_function;
+	DestroyFunc destroy_key;
+	DestroyFunc destroy_value;
+};
+
+
+// Το hash της hash function αναμειγνύεται ξανά με ένα πολλαπλασιασμό (Fibonacci hashing), ώστε
+// και συναρτήσεις όπως το id μιας εγγραφής να κατανέμουν ομοιόμορφα τα κλειδιά. Τα υψηλά 32 bits
+// δίνουν την αρχική θέση (h1) και τα 7 από κάτω το control byte (h2).
+
+static inline uint64_t mix(uint hash) {
+	return hash * 0x9E3779B97F4A7C15ULL;
+}
+
+static inline uint h1(uint64_t mixed) {
+	return mixed >> 32;
+}
+
+static inline int8_t h2(uint64_t mixed) {
+	return (mixed >> 25) & 0x7F;
+}
+
+// Bitmask με τις θέσεις του group που ξεκινά από το ctrl και έχουν control byte ίσο με value.
+// Το bit i αντιστοιχεί στη θέση ctrl[i].
+
+static inline uint32_t group_match(const int8_t* ctrl, int8_t value) {
+#ifdef __SSE2__
+	__m128i group = _mm_loadu_si128((const __m128i*) ctrl);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(value)));
+#else
+	uint32_t mask = 0;
+	for (int i = 0; i < GROUP_WIDTH; i++)
+		mask |= (uint32_t) (ctrl[i] == value) << i;
+	return mask;
+#endif
+}
+
+// Οι ελεύθερες (EMPTY ή DELETED) θέσεις του group
+
+static inline uint32_t group_match_free(const int8_t* ctrl) {
+#ifdef __SSE2__
+	// Το movemask παίρνει το πρώτο bit κάθε byte, που είναι 1 μόνο στις ελεύθερες θέσεις
+	return _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) ctrl));
+#else
+	uint32_t mask = 0;
+	for (int i = 0; i < GROUP_WIDTH; i++)
+		mask |= (uint32_t) (ctrl[i] < 0) << i;
+	return mask;
+#endif
+}
+
+// Ορίζει το control byte της θέσης pos. Οι πρώτες GROUP_WIDTH θέσεις υπάρχουν και στο τέλος
+// του ctrl, ώστε ένα group που ξεκινά κοντά στο τέλος να διαβάζεται χωρίς αναδίπλωση.
+
+static inline void set_ctrl(Map map, int pos, int8_t value) {
+	map->ctrl[pos] = value;
+	if (pos < GROUP_WIDTH)
+		map->ctrl[map->capacity + pos] = value;
+}
+
+// Η ακολουθία των groups μιας αναζήτησης: από την αρχική θέση με βήματα 16, 32, 48, ...
+// (triangular probing). Επειδή το μέγεθος είναι δύναμη του 2, περνάει από όλες τις θέσεις.
+
+struct probe {
+	uint pos;
+	uint step;
+	uint mask;
+};
+
+static inline struct probe probe_start(Map map, uint64_t mixed) {
+	uint mask = map->capacity - 1;
+	return (struct probe) { .pos = h1(mixed) & mask, .step = 0, .mask = mask };
+}
+
+static inline void probe_next(struct probe* probe) {
+	probe->step += GROUP_WIDTH;
+	probe->pos = (probe->pos + probe->step) & probe->mask;
+}
+
+// Η πρώτη ελεύθερη θέση της ακολουθίας του hash
+
+static int find_free_slot(Map map, uint64_t mixed) {
+	for (struct probe probe = probe_start(map, mixed); ; probe_next(&probe)) {
+		uint32_t free_slots = group_match_free(map->ctrl + probe.pos);
+		if (free_slots != 0)
+			return (probe.pos + __builtin_ctz(free_slots)) & probe.mask;
+	}
+}
+
+// Τοποθετεί τον node σε ελεύθερη θέση (το key δεν υπάρχει στο map)
+
+static void place_node(Map map, MapNode node) {
+	uint64_t mixed = mix(node->hash);
+	int slot = find_free_slot(map, mixed);
+	if (map->ctrl[slot] == CTRL_DELETED)
+		map->deleted--;
+
+	set_ctrl(map, slot, h2(mixed));
+	map->slots[slot] = node;
+	node->slot = slot;
+}
+
+static void allocate(Map map, int capacity) {
+	map->capacity = capacity;
+	map->ctrl = malloc(capacity + GROUP_WIDTH);
+	memset(map->ctrl, CTRL_EMPTY, capacity + GROUP_WIDTH);
+	map->slots = malloc(capacity * sizeof(MapNode));
+	map->deleted = 0;
+}
+
+// Μεταφέρει όλους τους κόμβους σε νέο πίνακα με χωρητικότητα capacity (και χωρίς DELETED θέσεις)
+
+static void resize(Map map, int capacity) {
+	ADT_STATS_START(start);
+
+	int old_capacity = map->capacity;
+	int8_t* old_ctrl = map->ctrl;
+	MapNode* old_slots = map->slots;
+
+	allocate(map, capacity);
+	for (int i = 0; i < old_capacity; i++)
+		if (old_ctrl[i] >= 0)
+			place_node(map, old_slots[i]);
+
+	free(old_ctrl);
+	free(old_slots);
+
+	ADT_STATS_EVENT(ADT_EVENT_MAP_REHASH, ADT_STATS_ELAPSED(start));
+}
+
+
+Map map_create(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value) {
+	Map map = malloc(sizeof(*map));
+	allocate(map, MIN_CAPACITY);
+	map->size = 0;
+	map->compare = compare;
+	map->hash_function = NULL;
+	map->destroy_key = destroy_key;
+	map->destroy_value = destroy_value;
+	return map;
+}
+
+int map_size(Map map) {
+	return map->size;
+}
+
+MapNode map_find_node_with(Map map, uint hash, Pointer probe, CompareFunc eq) {
+	uint64_t mixed = mix(hash);
+	int8_t tag = h2(mixed);
+
+	for (struct probe p = probe_start(map, mixed); ; probe_next(&p)) {
+		const int8_t* group = map->ctrl + p.pos;
+
+		// Η eq καλείται μόνο για θέσεις με το ίδιο h2 και ίδιο hash
+		for (uint32_t match = group_match(group, tag); match != 0; match &= match - 1) {
+			MapNode node = map->slots[(p.pos + __builtin_ctz(match)) & p.mask];
+			if (node->hash == hash && !eq(node->key, probe))
+				return node;
+		}
+
+		// Αν υπήρχε το κλειδί, θα είχε μπει το αργότερο στην πρώτη EMPTY θέση
+		if (group_match(group, CTRL_EMPTY) != 0)
+			return MAP_EOF;
+	}
+}
+
+MapNode map_find_node(Map map, Pointer key) {
+	return map_find_node_with(map, map->hash_function(key), key, map->compare);
+}
+
+Pointer map_find_with(Map map, uint hash, Pointer probe, CompareFunc eq) {
+	MapNode node = map_find_node_with(map, hash, probe, eq);
+	return node != MAP_EOF ? node->value : NULL;
+}
+
+Pointer map_find(Map map, Pointer key) {
+	return map_find_with(map, map->hash_function(key), key, map->compare);
+}
+
+// Προσθέτει νέο κόμβο χωρίς να ελέγξει αν το key υπάρχει ήδη
+
+MapNode map_insert_with(Map map, uint hash, Pointer key, Pointer value) {
+	// Αν ο πίνακας γέμισε (μαζί με τις DELETED θέσεις) φτιάχνουμε νέο: διπλάσιο αν τα στοιχεία
+	// είναι πάνω από τα μισά του ορίου, αλλιώς ίδιου μεγέθους, που απλά καθαρίζει τις DELETED.
+	if (map->size + map->deleted + 1 > MAX_LOAD(map->capacity))
+		resize(map, map->size + 1 > MAX_LOAD(map->capacity) / 2 ? map->capacity * 2 : map->capacity);
+
+	MapNode node = malloc(sizeof(*node));
+	node->key = key;
+	node->value = value;
+	node->hash = hash;
+	place_node(map, node);
+	map->size++;
+	return node;
+}
+
+void map_insert(Map map, Pointer key, Pointer value) {
+	uint hash = map->hash_function(key);
+	MapNode node = map_find_node_with(map, hash, key, map->compare);
+	if (node == MAP_EOF) {
+		map_insert_with(map, hash, key, value);
+		return;
+	}
+
+	// Υπάρχει ισοδύναμο κλειδί, αντικαθιστούμε τα key και value
+	if (node->key != key && map->destroy_key != NULL)
+		map->destroy_key(node->key);
+	node->key = key;
+	if (node->value != value && map->destroy_value != NULL)
+		map->destroy_value(node->value);
+	node->value = value;
+}
+
+MapNode map_find_or_insert(Map map, Pointer key, Pointer (*make)(Pointer key), bool* inserted) {
+	uint hash = map->hash_function(key);
+	MapNode node = map_find_node_with(map, hash, key, map->compare);
+
+	bool found = node != MAP_EOF;
+	if (!found)
+		node = map_insert_with(map, hash, key, make != NULL ? make(key) : NULL);
+
+	if (inserted != NULL)
+		*inserted = !found;
+	return node;
+}
+
+void map_node_set_value(Map map, MapNode node, Pointer value) {
+	node->value = value;
+}
+
+bool map_remove_with(Map map, uint hash, Pointer probe, CompareFunc eq) {
+	MapNode node = map_find_node_with(map, hash, probe, eq);
+	if (node == MAP_EOF)
+		return false;
+
+	// Η θέση γίνεται DELETED (όχι EMPTY), ώστε να μη σταματούν εκεί οι αναζητήσεις κλειδιών
+	// που πέρασαν από αυτήν όταν προστέθηκαν
+	set_ctrl(map, node->slot, CTRL_DELETED);
+	map->size--;
+	map->deleted++;
+
+	if (map->destroy_key != NULL)
+		map->destroy_key(node->key);
+	if (map->destroy_value != NULL)
+		map->destroy_value(node->value);
+	free(node);
+
+	return true;
+}
+
+bool map_remove(Map map, Pointer key) {
+	return map_remove_with(map, map->hash_function(key), key, map->compare);
+}
+
+DestroyFunc map_set_destroy_key(Map map, DestroyFunc destroy_key) {
+	DestroyFunc old = map->destroy_key;
+	map->destroy_key = destroy_key;
+	return old;
+}
+
+DestroyFunc map_set_destroy_value(Map map, DestroyFunc destroy_value) {
+	DestroyFunc old = map->destroy_value;
+	map->destroy_value = destroy_value;
+	return old;
+}
+
+void map_destroy(Map map) {
+	for (int i = 0; i < map->capacity; i++) {
+		if (map->ctrl[i] < 0)
+			continue;
+
+		MapNode node = map->slots[i];
+		if (map->destroy_key != NULL)
+			map->destroy_key(node->key);
+		if (map->destroy_value != NULL)
+			map->destroy_value(node->value);
+		free(node);
+	}
+
+	free(map->ctrl);
+	free(map->slots);
+	free(map);
+}
+
+
+/////////////////////// Διάσχιση του map μέσω κόμβων ///////////////////////////
+
+// Ο κόμβος της πρώτης γεμάτης θέσης από τη from και μετά
+
+static MapNode first_from(Map map, int from) {
+	for (int i = from; i < map->capacity; i++)
+		if (map->ctrl[i] >= 0)
+			return map->slots[i];
+
+	return MAP_EOF;
+}
+
+MapNode map_first(Map map) {
+	return first_from(map, 0);
+}
+
+MapNode map_next(Map map, MapNode node) {
+	return first_from(map, node->slot + 1);
+}
+
+Pointer map_node_key(Map map, MapNode node) {
+	return node->key;
+}
+
+Pointer map_node_value(Map map, MapNode node) {
+	return node->value;
+}
+
+
+//// Συναρτήσεις για hashing ////////////////////////////////////////////////////
+
+void map_set_hash_function(Map map, HashFunc func) {
+	map->hash_function = func;
+}
+
+HashFunc map_get_hash_function(Map map) {
+	return map->hash_function;
+}
+
+CompareFunc map_get_compare(Map map) {
+	return map->compare;
+}
+
+// Το μέγεθος είναι πάντα δύναμη του 2 και το hash αναμειγνύεται ξανά, οπότε το sizing δεν αλλάζει κάτι
+
+void map_set_sizing(Map map, MapSizing sizing) {
+}
+
+void map_reserve(Map map, int size) {
+	int capacity = map->capacity;
+	while (size > MAX_LOAD(capacity))
+		capacity *= 2;
+
+	if (capacity != map->capacity)
+		resize(map, capacity);
+}
+
+uint hash_string(Pointer value) {
+	return adt_hash_bytes(value, strlen(value), 0);
+}
+
+uint hash_int(Pointer value) {
+	return adt_hash_u64(*(uint*)value);
+}
+
+uint hash_pointer(Pointer value) {
+	return adt_hash_u64((uintptr_t)value);
+}
+
+// Στατιστικά. Ως "αλυσίδα" θεωρούμε τα κλειδιά με την ίδια αρχική θέση (που συγκρούονται), και
+// ως probes τις θέσεις με ίδιο h2 που εξετάζει η αναζήτηση μέχρι να βρει το κλειδί (η compare
+// καλείται μόνο γι' αυτές).
+
+MapStats map_stats(Map map) {
+	MapStats stats = { .size = map->size, .capacity = map->capacity };
+	stats.load_factor = (float)map->size / map->capacity;
+
+	int* chains = calloc(map->capacity, sizeof(int));
+	long probes = 0;
+
+	for (int i = 0; i < map->capacity; i++) {
+		if (map->ctrl[i] < 0)
+			continue;
+
+		MapNode node = map->slots[i];
+		uint64_t mixed = mix(node->hash);
+		struct probe p = probe_start(map, mixed);
+		chains[p.pos]++;
+
+		// Επαναλαμβάνουμε την αναζήτηση του κλειδιού μετρώντας τις θέσεις με ίδιο h2
+		for (bool found = false; !found; probe_next(&p)) {
+			for (uint32_t match = group_match(map->ctrl + p.pos, h2(mixed)); match != 0 && !found; match &= match - 1) {
+				probes++;
+				found = map->slots[(p.pos + __builtin_ctz(match)) & p.mask] == node;
+			}
+		}
+	}
+
+	int nonempty = 0;
+	for (int i = 0; i < map->capacity; i++) {
+		int length = chains[i];
+		stats.chains[length < MAP_STATS_CHAINS ? length : MAP_STATS_CHAINS - 1]++;
+		if (length > stats.max_chain)
+			stats.max_chain = length;
+		if (length > 0)
+			nonempty++;
+	}
+	free(chains);
+
+	if (map->size > 0) {
+		stats.mean_chain = (float)map->size / nonempty;
+		stats.mean_probes = (float)probes / map->size;
+	}
+	return stats;
+}
@@ -0,0 +1,232 @@
+//////////////////////////////////////////////////////////////////
+//
+// Unit tests για τον ADT ConcurrentMap.
+// Οποιαδήποτε υλοποίηση οφείλει να περνάει όλα τα tests.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "acutest.h"			// Απλή βιβλιοθήκη για unit testing
+
+#include "ADTConcurrentMap.h"
+
+
+int compare_ints(Pointer a, Pointer b) {
+	return *(int*)a - *(int*)b;
+}
+
+// Επιστρέφει έναν ακέραιο σε νέα μνήμη με τιμή value
+int* create_int(int value) {
+	int* p = malloc(sizeof(int));
+	*p = value;
+	return p;
+}
+
+// Η ίδια η τιμή ως hash
+uint hash_identity(Pointer value) {
+	return *(int*)value;
+}
+
+// Μετράει τις τιμές που καταστρέφονται
+static _Atomic int destroyed = 0;
+
+void destroy_counted(Pointer value) {
+	atomic_fetch_add(&destroyed, 1);
+	free(value);
+}
+
+
+void test_create(void) {
+	cmap_thread_register();
+
+	ConcurrentMap map = cmap_create(compare_ints, hash_int, NULL, NULL);
+	TEST_ASSERT(map != NULL);
+	TEST_ASSERT(cmap_size(map) == 0);
+
+	int key = 1;
+	TEST_ASSERT(cmap_find(map, &key) == NULL);
+	TEST_ASSERT(!cmap_remove(map, &key));
+
+	cmap_destroy(map);
+	cmap_thread_unregister();
+}
+
+void test_insert_find_remove(void) {
+	cmap_thread_register();
+
+	int N = 10000;
+	ConcurrentMap map = cmap_create(compare_ints, hash_int, free, destroy_counted);
+	atomic_store(&destroyed, 0);
+
+	// Αρκετά κλειδιά ώστε να γίνουν πολλοί διπλασιασμοί των buckets
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT(cmap_insert(map, create_int(i), create_int(i * 10)));
+	TEST_ASSERT(cmap_size(map) == N);
+
+	// Ισοδύναμο κλειδί: το map δεν αλλάζει, τα key/value μένουν σε εμάς
+	int* key = create_int(5);
+	int* value = create_int(0);
+	TEST_ASSERT(!cmap_insert(map, key, value));
+	TEST_ASSERT(*(int*)cmap_find(map, key) == 50);
+	free(key);
+	free(value);
+
+	for (int i = 0; i < N; i++) {
+		int* found = cmap_find(map, &i);
+		TEST_ASSERT(found != NULL && *found == i * 10);
+	}
+	int missing = N;
+	TEST_ASSERT(cmap_find(map, &missing) == NULL);
+
+	// Αφαιρούμε τα άρτια
+	for (int i = 0; i < N; i += 2)
+		TEST_ASSERT(cmap_remove(map, &i));
+	for (int i = 0; i < N; i += 2)
+		TEST_ASSERT(!cmap_remove(map, &i));
+	TEST_ASSERT(cmap_size(map) == N / 2);
+
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT((cmap_find(map, &i) != NULL) == (i % 2 == 1));
+
+	// Οι τιμές καταστρέφονται όταν δεν μπορεί να τις διαβάζει κανείς
+	cmap_synchronize();
+	TEST_ASSERT(atomic_load(&destroyed) == N / 2);
+
+	// Μετά την αφαίρεση το κλειδί μπορεί να ξαναπροστεθεί
+	int zero = 0;
+	TEST_ASSERT(cmap_insert(map, create_int(0), create_int(7)));
+	TEST_ASSERT(*(int*)cmap_find(map, &zero) == 7);
+
+	cmap_destroy(map);
+	TEST_ASSERT(atomic_load(&destroyed) == N + 1);
+
+	cmap_thread_unregister();
+}
+
+void test_hash_identity(void) {
+	cmap_thread_register();
+
+	// Το hash αναμειγνύεται από το map, οπότε και η ίδια η τιμή ως hash δουλεύει
+	static int keys[1000];
+	ConcurrentMap map = cmap_create(compare_ints, hash_identity, NULL, NULL);
+	for (int i = 0; i < 1000; i++) {
+		keys[i] = i * 1024;
+		TEST_ASSERT(cmap_insert(map, &keys[i], &keys[i]));
+	}
+	for (int i = 0; i < 1000; i++)
+		TEST_ASSERT(cmap_find(map, &keys[i]) == &keys[i]);
+
+	cmap_destroy(map);
+	cmap_thread_unregister();
+}
+
+
+// Πολλά threads ταυτόχρονα. Τα κλειδιά [0, STABLE) υπάρχουν πάντα, και κάθε writer
+// προσθέτει και αφαιρεί τα δικά του κλειδιά, ενώ οι readers ελέγχουν τα σταθερά.
+
+#define STABLE 1000
+#define WRITERS 4
+#define READERS 4
+#define ROUNDS 20
+#define WRITER_KEYS 2000
+
+struct worker {
+	ConcurrentMap map;
+	int id;
+	bool ok;
+};
+
+static _Atomic bool writers_done;
+
+static void* writer_thread(void* arg) {
+	struct worker* worker = arg;
+	cmap_thread_register();
+
+	int first = STABLE + worker->id * WRITER_KEYS;
+	for (int round = 0; round < ROUNDS; round++) {
+		for (int i = first; i < first + WRITER_KEYS; i++)
+			worker->ok &= cmap_insert(worker->map, create_int(i), create_int(i));
+		for (int i = first; i < first + WRITER_KEYS; i++)
+			worker->ok &= cmap_remove(worker->map, &i);
+	}
+
+	// Στο τέλος μένουν τα μισά
+	for (int i = first; i < first + WRITER_KEYS; i += 2)
+		worker->ok &= cmap_insert(worker->map, create_int(i), create_int(i));
+
+	cmap_thread_unregister();
+	return NULL;
+}
+
+static void* reader_thread(void* arg) {
+	struct worker* worker = arg;
+	cmap_thread_register();
+
+	do {
+		for (int i = 0; i < STABLE; i++) {
+			cmap_enter();
+			int* value = cmap_find(worker->map, &i);
+			worker->ok &= value != NULL && *value == i;
+			cmap_leave();
+		}
+	} while (!atomic_load(&writers_done));
+
+	cmap_thread_unregister();
+	return NULL;
+}
+
+void test_concurrent(void) {
+	cmap_thread_register();
+
+	ConcurrentMap map = cmap_create(compare_ints, hash_int, free, destroy_counted);
+	atomic_store(&destroyed, 0);
+	atomic_store(&writers_done, false);
+
+	for (int i = 0; i < STABLE; i++)
+		cmap_insert(map, create_int(i), create_int(i));
+
+	struct worker writers[WRITERS], readers[READERS];
+	pthread_t writer_threads[WRITERS], reader_threads[READERS];
+	for (int i = 0; i < READERS; i++) {
+		readers[i] = (struct worker){ map, i, true };
+		pthread_create(&reader_threads[i], NULL, reader_thread, &readers[i]);
+	}
+	for (int i = 0; i < WRITERS; i++) {
+		writers[i] = (struct worker){ map, i, true };
+		pthread_create(&writer_threads[i], NULL, writer_thread, &writers[i]);
+	}
+
+	for (int i = 0; i < WRITERS; i++) {
+		pthread_join(writer_threads[i], NULL);
+		TEST_ASSERT(writers[i].ok);
+	}
+	atomic_store(&writers_done, true);
+	for (int i = 0; i < READERS; i++) {
+		pthread_join(reader_threads[i], NULL);
+		TEST_ASSERT(readers[i].ok);
+	}
+
+	TEST_ASSERT(cmap_size(map) == STABLE + WRITERS * WRITER_KEYS / 2);
+	for (int i = STABLE; i < STABLE + WRITERS * WRITER_KEYS; i++)
+		TEST_ASSERT((cmap_find(map, &i) != NULL) == (i % 2 == 0));
+
+	// Ολες οι αφαιρέσεις των writers (που έκαναν unregister) καταστρέφονται
+	cmap_synchronize();
+	TEST_ASSERT(atomic_load(&destroyed) == WRITERS * WRITER_KEYS * ROUNDS);
+
+	cmap_destroy(map);
+	cmap_thread_unregister();
+}
+
+
+// Λίστα με όλα τα tests προς εκτέλεση
+TEST_LIST = {
+	{ "cmap_create", test_create },
+	{ "cmap_insert_find_remove", test_insert_find_remove },
+	{ "cmap_hash_identity", test_hash_identity },
+	{ "cmap_concurrent", test_concurrent },
+	{ NULL, NULL } // τερματίζουμε τη λίστα με NULL
+};
@@ -5,9 +5,12 @@
 //
 //////////////////////////////////////////////////////////////////
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 #include "acutest.h"			// Απλή βιβλιοθήκη για unit testing
 
 #include "ADTMap.h"
+#include "AdtHash.h"
 
 
 // Δημιουργούμε μια ειδική compare συνάρτηση
@@ -210,6 +213,215 @@ void test_iterate() {
 	map_destroy(map);
 }
 
+// Συνάρτηση κατακερματισμού που στέλνει όλα τα κλειδιά στο ίδιο bucket
+uint hash_constant(Pointer value) {
+	return 42;
+}
+
+void test_stats() {
+	Map map = map_create(compare_ints, free, NULL);
+	map_set_hash_function(map, hash_int);
+
+	// Κενό map
+	MapStats stats = map_stats(map);
+	TEST_ASSERT(stats.size == 0 && stats.max_chain == 0 && stats.mean_probes == 0);
+	TEST_ASSERT(stats.chains[0] == stats.capacity);
+
+	int N = 1000;
+	for (int i = 0; i < N; i++)
+		map_insert(map, create_int(i), NULL);
+
+	stats = map_stats(map);
+	TEST_ASSERT(stats.size == N);
+	TEST_ASSERT(stats.load_factor == (float)N / stats.capacity);
+	TEST_ASSERT(stats.max_chain >= 1 && stats.mean_chain >= 1 && stats.mean_probes >= 1);
+
+	// Το ιστόγραμμα καλύπτει όλα τα buckets
+	int buckets = 0;
+	for (int i = 0; i < MAP_STATS_CHAINS; i++)
+		buckets += stats.chains[i];
+	TEST_ASSERT(buckets == stats.capacity);
+
+	map_destroy(map);
+
+	// Με σταθερή συνάρτηση όλα τα κλειδιά είναι σε μία αλυσίδα
+	map = map_create(compare_ints, free, NULL);
+	map_set_hash_function(map, hash_constant);
+	N = 100;
+	for (int i = 0; i < N; i++)
+		map_insert(map, create_int(i), NULL);
+
+	stats = map_stats(map);
+	TEST_ASSERT(stats.max_chain == N);
+	TEST_ASSERT(stats.mean_chain == N);
+	TEST_ASSERT(stats.mean_probes == (N + 1) / 2.0);
+	TEST_ASSERT(stats.chains[0] == stats.capacity - 1);
+	TEST_ASSERT(stats.chains[MAP_STATS_CHAINS - 1] == 1);
+
+	map_destroy(map);
+}
+
+void test_sizing() {
+	Map map = map_create(compare_ints, free, free);
+	map_set_hash_function(map, hash_int);
+	map_set_sizing(map, MAP_SIZING_POW2);
+
+	int N = 1000;
+	for (int i = 0; i < N; i++)
+		map_insert(map, create_int(i), create_int(2*i));
+
+	// Το μέγεθος είναι δύναμη του 2
+	MapStats stats = map_stats(map);
+	TEST_ASSERT(stats.size == N);
+	TEST_ASSERT((stats.capacity & (stats.capacity - 1)) == 0);
+	TEST_ASSERT(stats.load_factor <= 0.9);
+
+	for (int i = 0; i < N; i++) {
+		int* value = map_find(map, &i);
+		TEST_ASSERT(value != NULL && *value == 2*i);
+	}
+	for (int i = 0; i < N; i += 2)
+		TEST_ASSERT(map_remove(map, &i));
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT((map_find_node(map, &i) == MAP_EOF) == (i % 2 == 0));
+
+	// Η διάσχιση βρίσκει όσα έμειναν
+	int count = 0;
+	for (MapNode node = map_first(map); node != MAP_EOF; node = map_next(map, node))
+		count++;
+	TEST_ASSERT(count == N / 2);
+
+	map_destroy(map);
+}
+
+void test_hash_functions() {
+	// Ισα strings σε διαφορετική μνήμη έχουν το ίδιο hash
+	char a[] = "a somewhat longer string, longer than 16 bytes";
+	char b[] = "a somewhat longer string, longer than 16 bytes";
+	TEST_ASSERT(hash_string(a) == hash_string(b));
+
+	// Strings που διαφέρουν σε ένα χαρακτήρα (σε οποιαδήποτε θέση) ή στο μήκος
+	for (int i = 0; a[i] != '\0'; i++) {
+		b[i]++;
+		TEST_ASSERT(hash_string(a) != hash_string(b));
+		b[i]--;
+	}
+	TEST_ASSERT(hash_string("") != hash_string("a"));
+	TEST_ASSERT(hash_string("ab") != hash_string("ba"));
+
+	// Διαδοχικοί ακέραιοι και pointers δεν έχουν διαδοχικά hashes
+	int x = 1, y = 2;
+	TEST_ASSERT(hash_int(&y) - hash_int(&x) != 1);
+	int array[2];
+	TEST_ASSERT(hash_pointer(&array[0]) != hash_pointer(&array[1]));
+	TEST_ASSERT(hash_pointer(&array[1]) - hash_pointer(&array[0]) != sizeof(int));
+	char chars[16];
+	for (int i = 1; i < 16; i++)
+		TEST_ASSERT(hash_pointer(&chars[0]) != hash_pointer(&chars[i]));
+}
+
+// Ενα τμήμα ενός string (χωρίς '\0' στο τέλος), για αναζήτηση σε map με κλειδιά char*
+struct string_view {
+	char* data;
+	size_t length;
+};
+
+int compare_view(Pointer key, Pointer probe) {
+	struct string_view* view = probe;
+	return strlen(key) != view->length || strncmp(key, view->data, view->length) != 0;
+}
+
+// Ιδιο hash με την hash_string για τα ίδια bytes
+uint hash_view(struct string_view* view) {
+	return adt_hash_bytes(view->data, view->length, 0);
+}
+
+void test_find_with() {
+	Map map = map_create((CompareFunc) strcmp, NULL, NULL);
+	map_set_hash_function(map, hash_string);
+
+	char* keys[] = { "apple", "banana", "cherry", "a much longer key, more than 16 bytes" };
+	int n = sizeof(keys) / sizeof(keys[0]);
+	for (int i = 0; i < n; i++)
+		map_insert(map, keys[i], keys[i]);
+
+	// Κάθε κλειδί βρίσκεται μέσα από ένα μεγαλύτερο string, χωρίς αντιγραφή
+	char text[] = "apple banana cherry a much longer key, more than 16 bytes!";
+	struct string_view views[] = { { text, 5 }, { text + 6, 6 }, { text + 13, 6 }, { text + 20, 37 } };
+	for (int i = 0; i < n; i++) {
+		TEST_ASSERT(map_find_with(map, hash_view(&views[i]), &views[i], compare_view) == keys[i]);
+		MapNode node = map_find_node_with(map, hash_view(&views[i]), &views[i], compare_view);
+		TEST_ASSERT(node != MAP_EOF && map_node_key(map, node) == keys[i]);
+	}
+
+	// Προθέματα των κλειδιών δεν βρίσκονται
+	struct string_view prefix = { text, 4 };
+	TEST_ASSERT(map_find_with(map, hash_view(&prefix), &prefix, compare_view) == NULL);
+	TEST_ASSERT(!map_remove_with(map, hash_view(&prefix), &prefix, compare_view));
+
+	// insert-or-get: νέο κλειδί με ένα hash για την αναζήτηση και την προσθήκη
+	struct string_view date = { "date palm", 4 };
+	uint hash = hash_view(&date);
+	MapNode node = map_find_node_with(map, hash, &date, compare_view);
+	TEST_ASSERT(node == MAP_EOF);
+	node = map_insert_with(map, hash, "date", "value");
+	TEST_ASSERT(map_size(map) == n + 1);
+	TEST_ASSERT(map_find(map, "date") == (Pointer) "value");
+
+	// Ο κόμβος μένει ίδιος μετά από rehash
+	char more[1000][16];
+	for (int i = 0; i < 1000; i++) {
+		sprintf(more[i], "more-%d", i);
+		map_insert(map, more[i], more[i]);
+	}
+	TEST_ASSERT(map_find_node(map, "date") == node);
+	TEST_ASSERT(map_node_value(map, node) == (Pointer) "value");
+
+	// Αφαίρεση μέσω του view
+	TEST_ASSERT(map_remove_with(map, hash_view(&views[1]), &views[1], compare_view));
+	TEST_ASSERT(map_find(map, "banana") == NULL);
+	TEST_ASSERT(map_size(map) == n + 1000);
+
+	map_destroy(map);
+}
+
+// Τιμή για τα νέα κλειδιά της map_find_or_insert: το διπλάσιο του κλειδιού
+Pointer make_double(Pointer key) {
+	return create_int(2 * *(int*)key);
+}
+
+void test_find_or_insert() {
+	Map map = map_create(compare_ints, free, free);
+	map_set_hash_function(map, hash_int);
+
+	int N = 1000;
+	MapNode* nodes = malloc(N * sizeof(*nodes));
+	for (int i = 0; i < N; i++) {
+		bool inserted = false;
+		nodes[i] = map_find_or_insert(map, create_int(i), make_double, &inserted);
+		TEST_ASSERT(inserted);
+		TEST_ASSERT(*(int*)map_node_value(map, nodes[i]) == 2 * i);
+	}
+	TEST_ASSERT(map_size(map) == N);
+
+	// Τα κλειδιά υπάρχουν ήδη: επιστρέφεται ο ίδιος κόμβος (παρά τα rehash), χωρίς make
+	for (int i = 0; i < N; i++) {
+		bool inserted = true;
+		TEST_ASSERT(map_find_or_insert(map, &i, NULL, &inserted) == nodes[i]);
+		TEST_ASSERT(!inserted);
+	}
+	TEST_ASSERT(map_size(map) == N);
+
+	// Χωρίς make η τιμή είναι NULL, και αλλάζει με την map_node_set_value
+	MapNode node = map_find_or_insert(map, create_int(N), NULL, NULL);
+	TEST_ASSERT(map_node_value(map, node) == NULL);
+	map_node_set_value(map, node, create_int(42));
+	TEST_ASSERT(*(int*)map_find(map, &N) == 42);
+
+	map_destroy(map);
+	free(nodes);
+}
+
 // Λίστα με όλα τα tests προς εκτέλεση
 TEST_LIST = {
 	// { "create", test_create },
@@ -219,6 +431,11 @@ TEST_LIST = {
 	{ "map_remove", test_remove },
 	{ "map_find", 	test_find },
 	{ "map_iterate",test_iterate },
+	{ "map_stats",	test_stats },
+	{ "map_set_sizing", test_sizing },
+	{ "hash_functions", test_hash_functions },
+	{ "map_find_with", test_find_with },
+	{ "map_find_or_insert", test_find_or_insert },
 
 	{ NULL, NULL } // τερματίζουμε τη λίστα με NULL
 }; 
\ No newline at end of file
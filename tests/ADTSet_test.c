@@ -0,0 +1,257 @@
+//////////////////////////////////////////////////////////////////
+//
+// Unit tests για τον ADT Set.
+// Οποιαδήποτε υλοποίηση οφείλει να περνάει όλα τα tests.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include "acutest.h"			// Απλή βιβλιοθήκη για unit testing
+
+#include "ADTSet.h"
+
+// Ελέγχει ότι το set είναι σωστό AVL (ορίζεται στην υλοποίηση, δεν είναι μέρος του public interface)
+bool set_is_proper(Set set);
+
+
+int compare_ints(Pointer a, Pointer b) {
+	return *(int*)a - *(int*)b;
+}
+
+// Επιστρέφει έναν ακέραιο σε νέα μνήμη με τιμή value
+int* create_int(int value) {
+	int* p = malloc(sizeof(int));
+	*p = value;
+	return p;
+}
+
+// Βοηθητική συνάρτηση για το ανακάτεμα του πίνακα τιμών
+void shuffle(int* array[], int n) {
+	for (int i = 0; i < n; i++) {
+		int j = i + rand() / (RAND_MAX / (n - i) + 1);
+		int* t = array[j];
+		array[j] = array[i];
+		array[i] = t;
+	}
+}
+
+// Δημιουργεί ένα set με τους άρτιους 0, 2, ..., 2*(n-1), εισηγμένους με τυχαία σειρά
+Set create_even_set(int n) {
+	Set set = set_create(compare_ints, free);
+
+	int** values = malloc(n * sizeof(*values));
+	for (int i = 0; i < n; i++)
+		values[i] = create_int(2 * i);
+	shuffle(values, n);
+
+	for (int i = 0; i < n; i++)
+		set_insert(set, values[i]);
+
+	free(values);
+	return set;
+}
+
+
+void test_create(void) {
+	Set set = set_create(compare_ints, NULL);
+	set_set_destroy_value(set, NULL);
+
+	TEST_ASSERT(set != NULL);
+	TEST_ASSERT(set_size(set) == 0);
+	TEST_ASSERT(set_first(set) == SET_BOF);
+	TEST_ASSERT(set_last(set) == SET_EOF);
+
+	set_destroy(set);
+}
+
+void test_insert_remove(void) {
+	int N = 1000;
+	Set set = create_even_set(N);
+
+	TEST_ASSERT(set_size(set) == N);
+	TEST_ASSERT(set_is_proper(set));
+
+	// Αντικατάσταση ισοδύναμης τιμής, το μέγεθος δεν αλλάζει
+	int* value = create_int(10);
+	set_insert(set, value);
+	TEST_ASSERT(set_size(set) == N);
+	TEST_ASSERT(set_find(set, value) == value);
+
+	// Αφαιρούμε όλα τα πολλαπλάσια του 4
+	for (int i = 0; i < 2 * N; i += 4) {
+		TEST_ASSERT(set_remove(set, &i));
+		TEST_ASSERT(!set_remove(set, &i));
+		TEST_ASSERT(set_find(set, &i) == NULL);
+	}
+	TEST_ASSERT(set_size(set) == N / 2);
+	TEST_ASSERT(set_is_proper(set));
+
+	// Η διάσχιση είναι σωστή και μετά τις αφαιρέσεις
+	int expected = 2;
+	for (SetNode node = set_first(set); node != SET_EOF; node = set_next(set, node)) {
+		TEST_ASSERT(*(int*)set_node_value(set, node) == expected);
+		expected += 4;
+	}
+	for (SetNode node = set_last(set); node != SET_BOF; node = set_previous(set, node)) {
+		expected -= 4;
+		TEST_ASSERT(*(int*)set_node_value(set, node) == expected);
+	}
+	TEST_ASSERT(expected == 2);
+
+	set_destroy(set);
+}
+
+void test_iterate(void) {
+	int N = 1000;
+	Set set = create_even_set(N);
+
+	// Διάσχιση προς τα εμπρός
+	int expected = 0;
+	for (SetNode node = set_first(set); node != SET_EOF; node = set_next(set, node)) {
+		TEST_ASSERT(*(int*)set_node_value(set, node) == expected);
+		expected += 2;
+	}
+	TEST_ASSERT(expected == 2 * N);
+
+	// Διάσχιση προς τα πίσω
+	for (SetNode node = set_last(set); node != SET_BOF; node = set_previous(set, node)) {
+		expected -= 2;
+		TEST_ASSERT(*(int*)set_node_value(set, node) == expected);
+	}
+	TEST_ASSERT(expected == 0);
+
+	set_destroy(set);
+}
+
+void test_order_statistics(void) {
+	int N = 1000;
+	Set set = create_even_set(N);
+
+	// Η set_select επιστρέφει το k-οστό μικρότερο στοιχείο
+	for (int k = 0; k < N; k++)
+		TEST_ASSERT(*(int*)set_node_value(set, set_select(set, k)) == 2 * k);
+	TEST_ASSERT(set_select(set, -1) == SET_EOF);
+	TEST_ASSERT(set_select(set, N) == SET_EOF);
+
+	// Η set_rank επιστρέφει τη θέση που έχει ή θα είχε κάθε τιμή
+	for (int i = -1; i <= 2 * N; i++)
+		TEST_ASSERT(set_rank(set, &i) == (i + 1) / 2);
+
+	// Η set_range_count συμφωνεί με τις set_count_less_than, set_count_greater_than
+	for (int from = -3; from <= 2 * N + 3; from += 7) {
+		for (int to = from - 4; to <= 2 * N + 3; to += 13) {
+			int count = N - set_count_less_than(set, &from) - set_count_greater_than(set, &to);
+			TEST_ASSERT(set_range_count(set, &from, &to) == (count > 0 ? count : 0));
+		}
+		TEST_ASSERT(set_range_count(set, &from, NULL) == N - set_count_less_than(set, &from));
+		TEST_ASSERT(set_range_count(set, NULL, &from) == N - set_count_greater_than(set, &from));
+	}
+	TEST_ASSERT(set_range_count(set, NULL, NULL) == N);
+
+	set_destroy(set);
+}
+
+void test_lower_bound(void) {
+	int N = 1000;
+	Set set = create_even_set(N);
+
+	// Για κάθε τιμή ο lower bound είναι ο μικρότερος άρτιος >= της τιμής
+	for (int i = -1; i < 2 * N - 1; i++) {
+		SetNode node = set_lower_bound(set, &i);
+		TEST_ASSERT(node != SET_EOF);
+		TEST_ASSERT(*(int*)set_node_value(set, node) == (i < 0 ? 0 : i + i % 2));
+	}
+	int max = 2 * N - 1;
+	TEST_ASSERT(set_lower_bound(set, &max) == SET_EOF);
+
+	set_destroy(set);
+}
+
+void test_create_from_sorted(void) {
+	for (int n = 0; n <= 100; n++) {
+		int** values = malloc(n * sizeof(*values));
+		for (int i = 0; i < n; i++)
+			values[i] = create_int(2 * i);
+
+		Set set = set_create_from_sorted(compare_ints, free, (Pointer*) values, n);
+		TEST_ASSERT(set_size(set) == n);
+		TEST_ASSERT(set_is_proper(set));
+
+		// Η σειρά διάσχισης είναι η σειρά του πίνακα
+		int i = 0;
+		for (SetNode node = set_first(set); node != SET_EOF; node = set_next(set, node), i++)
+			TEST_ASSERT(set_node_value(set, node) == values[i]);
+		TEST_ASSERT(i == n);
+
+		// Μπορούν να γίνουν κανονικά αλλαγές
+		set_insert(set, create_int(1));
+		int zero = 0;
+		if (n > 0)
+			TEST_ASSERT(set_remove(set, &zero));
+		TEST_ASSERT(set_is_proper(set));
+
+		set_destroy(set);
+		free(values);
+	}
+}
+
+void test_snapshot(void) {
+	int N = 1000;
+	Set set = create_even_set(N);
+
+	// Το snapshot έχει τα ίδια στοιχεία με το set τη στιγμή της δημιουργίας του
+	Set snapshot = set_snapshot(set);
+	TEST_ASSERT(set_size(snapshot) == N);
+	TEST_ASSERT(set_is_proper(snapshot));
+
+	// Αλλαγές στο set (προσθήκη περιττών, αφαίρεση των πολλαπλάσιων του 4) δεν επηρεάζουν το snapshot.
+	// Οι αφαιρεμένες τιμές δεν γίνονται free εδώ, ώστε να ελεγχθούν μέσω του snapshot.
+	set_set_destroy_value(set, NULL);
+	int** removed = malloc(N * sizeof(*removed));
+	int removed_no = 0;
+	for (int i = 0; i < 2 * N; i += 4) {
+		removed[removed_no] = set_find(set, &i);
+		TEST_ASSERT(set_remove(set, removed[removed_no++]));
+	}
+	for (int i = 1; i < 2 * N; i += 2)
+		set_insert(set, create_int(i));
+	TEST_ASSERT(set_is_proper(set));
+	TEST_ASSERT(set_size(set) == N - removed_no + N);
+
+	TEST_ASSERT(set_is_proper(snapshot));
+	TEST_ASSERT(set_size(snapshot) == N);
+	int i = 0;
+	for (SetNode node = set_first(snapshot); node != SET_EOF; node = set_next(snapshot, node), i += 2)
+		TEST_ASSERT(*(int*)set_node_value(snapshot, node) == i);
+	TEST_ASSERT(i == 2 * N);
+
+	// Ενα δεύτερο snapshot βλέπει τις αλλαγές, και αλλαγές στο snapshot δεν επηρεάζουν το set
+	Set second = set_snapshot(set);
+	int one = 1;
+	TEST_ASSERT(set_remove(second, &one));
+	TEST_ASSERT(set_find(set, &one) != NULL);
+	TEST_ASSERT(set_size(second) == set_size(set) - 1);
+	TEST_ASSERT(set_is_proper(second));
+
+	set_destroy(snapshot);
+	set_destroy(second);
+	set_set_destroy_value(set, free);
+	set_destroy(set);
+	for (int i = 0; i < removed_no; i++)
+		free(removed[i]);
+	free(removed);
+}
+
+
+// Λίστα με όλα τα tests προς εκτέλεση
+TEST_LIST = {
+	{ "set_create", test_create },
+	{ "set_insert_remove", test_insert_remove },
+	{ "set_iterate", test_iterate },
+	{ "set_order_statistics", test_order_statistics },
+	{ "set_lower_bound", test_lower_bound },
+	{ "set_create_from_sorted", test_create_from_sorted },
+	{ "set_snapshot", test_snapshot },
+
+	{ NULL, NULL } // τερματίζουμε τη λίστα με NULL
+};
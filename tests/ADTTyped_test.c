@@ -0,0 +1,227 @@
+//////////////////////////////////////////////////////////////////
+//
+// Unit tests για τα typed ADTs (DEFINE_VECTOR, DEFINE_MAP,
+// DEFINE_SET, DEFINE_PQUEUE).
+//
+//////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+
+#include "acutest.h"			// Απλή βιβλιοθήκη για unit testing
+
+#include "ADTTypedVector.h"
+#include "ADTTypedMap.h"
+#include "ADTTypedSet.h"
+#include "ADTTypedPriorityQueue.h"
+
+
+static int compare_ints(int a, int b) {
+	return a - b;
+}
+
+// Σύνθετος τύπος ως τιμή (by value)
+typedef struct {
+	int id;
+	int cases;
+} Counter;
+
+DEFINE_VECTOR(int)
+DEFINE_VECTOR(Counter)
+DEFINE_MAP(uint32_t, int, hash_u32, eq_u32)
+DEFINE_MAP(String, Counter, hash_str, eq_str)
+DEFINE_SET(int, compare_ints)
+DEFINE_PQUEUE(int, compare_ints)
+
+// Βοηθητική συνάρτηση για το ανακάτεμα του πίνακα τιμών
+static void shuffle(int array[], int n) {
+	for (int i = 0; i < n; i++) {
+		int j = i + rand() % (n - i);
+		int t = array[j];
+		array[j] = array[i];
+		array[i] = t;
+	}
+}
+
+
+void test_vector(void) {
+	Vector_int vec = vector_int_create(3);
+	TEST_ASSERT(vector_int_size(vec) == 3);
+	TEST_ASSERT(vector_int_get_at(vec, 2) == 0);
+
+	for (int i = 0; i < 1000; i++)
+		vector_int_insert_last(vec, i);
+	TEST_ASSERT(vector_int_size(vec) == 1003);
+	TEST_ASSERT(vector_int_get_at(vec, 3 + 500) == 500);
+
+	vector_int_set_at(vec, 0, -1);
+	TEST_ASSERT(vector_int_array(vec)[0] == -1);
+
+	vector_int_remove_last(vec);
+	TEST_ASSERT(vector_int_size(vec) == 1002);
+	TEST_ASSERT(vector_int_get_at(vec, 1001) == 998);
+	vector_int_destroy(vec);
+
+	// Οι τιμές αντιγράφονται
+	Vector_Counter counters = vector_Counter_create(0);
+	Counter counter = { 7, 1 };
+	vector_Counter_insert_last(counters, counter);
+	counter.cases = 2;
+	TEST_ASSERT(vector_Counter_get_at(counters, 0).cases == 1);
+	vector_Counter_array(counters)[0].cases++;
+	TEST_ASSERT(vector_Counter_get_at(counters, 0).cases == 2);
+	vector_Counter_destroy(counters);
+}
+
+void test_map(void) {
+	int N = 10000;
+	int* keys = malloc(N * sizeof(int));
+	for (int i = 0; i < N; i++)
+		keys[i] = i * 1024;			// Με βήμα, ώστε να φανεί αν η ανάμειξη δεν δουλεύει
+	shuffle(keys, N);
+
+	Map_uint32_t_int map = map_uint32_t_int_create();
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT(map_uint32_t_int_insert(map, keys[i], keys[i] + 1));
+	TEST_ASSERT(map_uint32_t_int_size(map) == N);
+
+	// Αντικατάσταση τιμής
+	TEST_ASSERT(!map_uint32_t_int_insert(map, keys[0], -1));
+	TEST_ASSERT(*map_uint32_t_int_find(map, keys[0]) == -1);
+	map_uint32_t_int_insert(map, keys[0], keys[0] + 1);
+
+	for (int i = 0; i < N; i++) {
+		int* value = map_uint32_t_int_find(map, keys[i]);
+		TEST_ASSERT(value != NULL && *value == keys[i] + 1);
+	}
+	TEST_ASSERT(map_uint32_t_int_find(map, 1) == NULL);
+
+	// Αφαιρούμε τα μισά, τα υπόλοιπα πρέπει να βρίσκονται ακόμα (backward shift)
+	for (int i = 0; i < N; i += 2)
+		TEST_ASSERT(map_uint32_t_int_remove(map, keys[i]));
+	TEST_ASSERT(!map_uint32_t_int_remove(map, keys[0]));
+	TEST_ASSERT(map_uint32_t_int_size(map) == N / 2);
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT((map_uint32_t_int_find(map, keys[i]) != NULL) == (i % 2 == 1));
+
+	// Διάσχιση
+	int count = 0;
+	long sum = 0;
+	for (int pos = map_uint32_t_int_next(map, -1); pos != -1; pos = map_uint32_t_int_next(map, pos)) {
+		TEST_ASSERT(*map_uint32_t_int_value_at(map, pos) == (int)map_uint32_t_int_key_at(map, pos) + 1);
+		sum += map_uint32_t_int_key_at(map, pos);
+		count++;
+	}
+	long expected = 0;
+	for (int i = 1; i < N; i += 2)
+		expected += keys[i];
+	TEST_ASSERT(count == N / 2 && sum == expected);
+
+	map_uint32_t_int_destroy(map);
+	free(keys);
+}
+
+void test_map_find_or_insert(void) {
+	// Μετρητές ανά string, χωρίς malloc για τους μετρητές
+	String words[] = { "a", "b", "a", "c", "a", "b" };
+	Map_String_Counter map = map_String_Counter_create();
+
+	for (int i = 0; i < 6; i++) {
+		bool inserted;
+		Counter* counter = map_String_Counter_find_or_insert(map, words[i], &inserted);
+		TEST_ASSERT(inserted == (i < 2 || i == 3));
+		if (inserted)
+			counter->id = i;
+		counter->cases++;
+	}
+	TEST_ASSERT(map_String_Counter_size(map) == 3);
+	TEST_ASSERT(map_String_Counter_find(map, "a")->cases == 3);
+	TEST_ASSERT(map_String_Counter_find(map, "b")->cases == 2);
+	TEST_ASSERT(map_String_Counter_find(map, "c")->id == 3);
+	TEST_ASSERT(map_String_Counter_find(map, "d") == NULL);
+
+	map_String_Counter_destroy(map);
+}
+
+void test_set(void) {
+	int N = 1000;
+	int* values = malloc(N * sizeof(int));
+	for (int i = 0; i < N; i++)
+		values[i] = 2 * i;
+	shuffle(values, N);
+
+	Set_int set = set_int_create();
+	TEST_ASSERT(set_int_first(set) == NULL);
+
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT(set_int_insert(set, values[i]));
+	TEST_ASSERT(!set_int_insert(set, values[0]));
+	TEST_ASSERT(set_int_size(set) == N);
+
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT(*set_int_find(set, values[i]) == values[i]);
+	TEST_ASSERT(set_int_find(set, 1) == NULL);
+
+	// Διάσχιση με τη σειρά
+	int count = 0;
+	for (int* value = set_int_first(set); value != NULL; value = set_int_upper_bound(set, *value))
+		TEST_ASSERT(*value == 2 * count++);
+	TEST_ASSERT(count == N);
+
+	TEST_ASSERT(*set_int_lower_bound(set, 3) == 4);
+	TEST_ASSERT(*set_int_lower_bound(set, 4) == 4);
+	TEST_ASSERT(*set_int_upper_bound(set, 4) == 6);
+	TEST_ASSERT(set_int_lower_bound(set, 2 * N) == NULL);
+
+	// Αφαιρούμε τα μισά με τυχαία σειρά
+	for (int i = 0; i < N; i += 2)
+		TEST_ASSERT(set_int_remove(set, values[i]));
+	TEST_ASSERT(!set_int_remove(set, values[0]));
+	TEST_ASSERT(set_int_size(set) == N / 2);
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT((set_int_find(set, values[i]) != NULL) == (i % 2 == 1));
+
+	// Το δέντρο μένει ισορροπημένο: ύψος AVL <= 1.44 log2(n)
+	TEST_ASSERT(set->root->height <= 14);
+
+	set_int_destroy(set);
+	free(values);
+}
+
+void test_pqueue(void) {
+	int N = 1000;
+	int* values = malloc(N * sizeof(int));
+	for (int i = 0; i < N; i++)
+		values[i] = i;
+	shuffle(values, N);
+
+	// Από πίνακα, και με insert
+	PriorityQueue_int from_array = pqueue_int_create(values, N);
+	PriorityQueue_int pqueue = pqueue_int_create(NULL, 0);
+	for (int i = 0; i < N; i++) {
+		pqueue_int_insert(pqueue, values[i]);
+		TEST_ASSERT(pqueue_int_size(pqueue) == i + 1);
+	}
+
+	for (int i = N - 1; i >= 0; i--) {
+		TEST_ASSERT(pqueue_int_max(pqueue) == i);
+		TEST_ASSERT(pqueue_int_max(from_array) == i);
+		pqueue_int_remove_max(pqueue);
+		pqueue_int_remove_max(from_array);
+	}
+	TEST_ASSERT(pqueue_int_size(pqueue) == 0);
+
+	pqueue_int_destroy(pqueue);
+	pqueue_int_destroy(from_array);
+	free(values);
+}
+
+
+// Λίστα με όλα τα tests προς εκτέλεση
+TEST_LIST = {
+	{ "typed_vector", test_vector },
+	{ "typed_map", test_map },
+	{ "typed_map_find_or_insert", test_map_find_or_insert },
+	{ "typed_set", test_set },
+	{ "typed_pqueue", test_pqueue },
+	{ NULL, NULL } // τερματίζουμε τη λίστα με NULL
+};
@@ -0,0 +1,157 @@
+//////////////////////////////////////////////////////////////////
+//
+// Unit tests για το AdtAlloc.
+//
+// Το test κάνει ό,τι και ένα module με ADT_ALLOC_STATS: ορίζει το
+// ADT_MODULE και κάνει include το AdtAlloc.h τελευταίο, οπότε οι
+// κλήσεις malloc/realloc/free παρακάτω μετράνε στο ADT_VECTOR.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <string.h>
+
+#include "acutest.h"			// Απλή βιβλιοθήκη για unit testing
+
+#ifndef ADT_ALLOC_STATS			// Μπορεί να έχει οριστεί ήδη με CFLAGS=-DADT_ALLOC_STATS
+#define ADT_ALLOC_STATS
+#endif
+#define ADT_MODULE ADT_VECTOR
+#include "AdtAlloc.h"
+
+
+void test_counters() {
+	adt_alloc_stats_reset();
+	AdtAllocStats before = adt_alloc_stats(ADT_VECTOR);
+	AdtAllocStats list_before = adt_alloc_stats(ADT_LIST);
+
+	char* a = malloc(100);
+	int* b = calloc(10, sizeof(int));
+	TEST_ASSERT(a != NULL && b != NULL);
+	for (int i = 0; i < 10; i++)
+		TEST_ASSERT(b[i] == 0);
+
+	AdtAllocStats stats = adt_alloc_stats(ADT_VECTOR);
+	TEST_ASSERT(stats.allocs == before.allocs + 2);
+	TEST_ASSERT(stats.frees == before.frees);
+	TEST_ASSERT(stats.bytes_live == before.bytes_live + 100 + 10 * sizeof(int));
+
+	// Το realloc μετράει ως αποδέσμευση και νέα δέσμευση, και κρατάει τα δεδομένα
+	strcpy(a, "hello");
+	a = realloc(a, 300);
+	TEST_ASSERT(strcmp(a, "hello") == 0);
+
+	stats = adt_alloc_stats(ADT_VECTOR);
+	TEST_ASSERT(stats.allocs == before.allocs + 3);
+	TEST_ASSERT(stats.frees == before.frees + 1);
+	TEST_ASSERT(stats.bytes_live == before.bytes_live + 300 + 10 * sizeof(int));
+	TEST_ASSERT(stats.bytes_peak >= stats.bytes_live);
+
+	free(a);
+	free(b);
+	free(NULL);
+
+	stats = adt_alloc_stats(ADT_VECTOR);
+	TEST_ASSERT(stats.frees == before.frees + 3);
+	TEST_ASSERT(stats.bytes_live == before.bytes_live);
+	TEST_ASSERT(stats.bytes_peak >= before.bytes_live + 300 + 10 * sizeof(int));
+
+	// Τα άλλα modules δεν επηρεάζονται
+	AdtAllocStats list_stats = adt_alloc_stats(ADT_LIST);
+	TEST_ASSERT(list_stats.allocs == list_before.allocs);
+
+	// Το reset μηδενίζει τα πλήθη και το peak γίνεται όσο τα bytes που είναι δεσμευμένα
+	adt_alloc_stats_reset();
+	stats = adt_alloc_stats(ADT_VECTOR);
+	TEST_ASSERT(stats.allocs == 0 && stats.frees == 0);
+	TEST_ASSERT(stats.bytes_peak == stats.bytes_live);
+}
+
+void test_total() {
+	adt_alloc_stats_reset();
+
+	// Περιοχές από διαφορετικά modules μετράνε στο σύνολο
+	Pointer a = adt_malloc(ADT_MAP, 10);
+	Pointer b = adt_malloc(ADT_SET, 20);
+
+	AdtAllocStats total = adt_alloc_stats(ADT_MODULE_NO);
+	TEST_ASSERT(total.allocs == 2);
+	TEST_ASSERT(adt_alloc_stats(ADT_MAP).allocs == 1);
+	TEST_ASSERT(adt_alloc_stats(ADT_SET).allocs == 1);
+
+	// Μια περιοχή μετράει στο module που την δέσμευσε, όποιος κι αν την κάνει free
+	long map_live = adt_alloc_stats(ADT_MAP).bytes_live;
+	free(a);
+	TEST_ASSERT(adt_alloc_stats(ADT_MAP).bytes_live == map_live - 10);
+	TEST_ASSERT(adt_alloc_stats(ADT_VECTOR).frees == 0);
+	adt_free(b);
+
+	TEST_ASSERT(adt_alloc_stats(ADT_MODULE_NO).frees == 2);
+	TEST_ASSERT(strcmp(adt_module_name(ADT_MAP), "map") == 0);
+}
+
+// Bump allocator πάνω σε ένα στατικό buffer: η release δεν κάνει τίποτα, και δεν
+// υπάρχει resize οπότε το realloc γίνεται με alloc + αντιγραφή.
+
+struct bump {
+	char buffer[4096];
+	size_t used;
+	int allocs;
+	int releases;
+};
+
+static Pointer bump_alloc(Pointer context, size_t size) {
+	struct bump* bump = context;
+	size = (size + 15) & ~(size_t)15;
+	if (bump->used + size > sizeof(bump->buffer))
+		return NULL;
+
+	Pointer ptr = bump->buffer + bump->used;
+	bump->used += size;
+	bump->allocs++;
+	return ptr;
+}
+
+static void bump_release(Pointer context, Pointer ptr, size_t size) {
+	struct bump* bump = context;
+	bump->releases++;
+}
+
+void test_allocator() {
+	static struct bump bump __attribute__((aligned(16)));
+	AdtAllocator allocator = { bump_alloc, NULL, bump_release, &bump };
+	adt_set_allocator(&allocator);
+
+	char* a = malloc(64);
+	TEST_ASSERT(a >= bump.buffer && a < bump.buffer + sizeof(bump.buffer));
+	TEST_ASSERT((uintptr_t)a % 16 == 0);
+	TEST_ASSERT(bump.allocs == 1);
+
+	strcpy(a, "bump");
+	a = realloc(a, 128);
+	TEST_ASSERT(strcmp(a, "bump") == 0);
+	TEST_ASSERT(bump.allocs == 2);
+	TEST_ASSERT(bump.releases == 1);
+
+	free(a);
+	TEST_ASSERT(bump.releases == 2);
+
+	// Αν ο allocator αποτύχει επιστρέφεται NULL
+	TEST_ASSERT(malloc(8192) == NULL);
+
+	adt_set_allocator(NULL);
+
+	// Πίσω στο malloc
+	a = malloc(16);
+	TEST_ASSERT(a < bump.buffer || a >= bump.buffer + sizeof(bump.buffer));
+	free(a);
+}
+
+
+// Λίστα με όλα τα tests προς εκτέλεση
+TEST_LIST = {
+	{ "adt_alloc_counters", test_counters },
+	{ "adt_alloc_total", test_total },
+	{ "adt_set_allocator", test_allocator },
+	{ NULL, NULL } // τερματίζουμε τη λίστα με NULL
+};
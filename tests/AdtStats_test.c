@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////
+//
+// Unit tests για το AdtStats.
+//
+// Οι συναρτήσεις του ιστογράμματος και των γεγονότων δουλεύουν
+// πάντα, μόνο οι μακροεντολές ADT_STATS_* χρειάζονται -DADT_STATS.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "acutest.h"			// Απλή βιβλιοθήκη για unit testing
+
+#include "AdtStats.h"
+
+
+// Ελέγχει ότι το found είναι το πολύ 12.5% πάνω από το expected (και ποτέ κάτω)
+
+static bool close_to(uint64_t found, uint64_t expected) {
+	return found >= expected && found <= expected + expected / 8;
+}
+
+void test_histogram() {
+	static AdtHistogram histogram;
+
+	// Κενό ιστόγραμμα
+	TEST_ASSERT(histogram.count == 0);
+	TEST_ASSERT(adt_histogram_percentile(&histogram, 50) == 0);
+
+	// Οι τιμές 1..10000
+	long sum = 0;
+	for (int i = 1; i <= 10000; i++) {
+		adt_histogram_record(&histogram, i);
+		sum += i;
+	}
+	TEST_ASSERT(histogram.count == 10000);
+	TEST_ASSERT(histogram.sum == sum);
+	TEST_ASSERT(histogram.max == 10000);
+
+	TEST_ASSERT(close_to(adt_histogram_percentile(&histogram, 50), 5000));
+	TEST_ASSERT(close_to(adt_histogram_percentile(&histogram, 90), 9000));
+	TEST_ASSERT(close_to(adt_histogram_percentile(&histogram, 99), 9900));
+	TEST_ASSERT(adt_histogram_percentile(&histogram, 100) == 10000);
+
+	// Οι μικρές τιμές είναι ακριβείς
+	TEST_ASSERT(adt_histogram_percentile(&histogram, 0.01) == 1);
+	TEST_ASSERT(adt_histogram_percentile(&histogram, 0.15) == 15);
+
+	// Μεγάλες τιμές (πχ ns) δεν ξεφεύγουν από τον πίνακα
+	adt_histogram_record(&histogram, (uint64_t)1 << 50);
+	TEST_ASSERT(adt_histogram_percentile(&histogram, 100) == (uint64_t)1 << 50);
+	TEST_ASSERT(close_to(adt_histogram_percentile(&histogram, 50), 5000));
+
+	adt_histogram_reset(&histogram);
+	TEST_ASSERT(histogram.count == 0 && histogram.sum == 0 && histogram.max == 0);
+	TEST_ASSERT(adt_histogram_percentile(&histogram, 99) == 0);
+
+	// Μία τιμή: όλα τα percentiles είναι αυτή η τιμή
+	adt_histogram_record(&histogram, 1000);
+	TEST_ASSERT(adt_histogram_percentile(&histogram, 1) == 1000);
+	TEST_ASSERT(adt_histogram_percentile(&histogram, 99.9) == 1000);
+}
+
+void test_events() {
+	adt_stats_reset();
+
+	adt_stats_event(ADT_EVENT_SET_ROTATION, 1);
+	adt_stats_event(ADT_EVENT_SET_ROTATION, 1);
+	adt_stats_event(ADT_EVENT_PQUEUE_SIFT_DOWN, 7);
+
+	TEST_ASSERT(adt_stats_histogram(ADT_EVENT_SET_ROTATION)->count == 2);
+	TEST_ASSERT(adt_stats_histogram(ADT_EVENT_PQUEUE_SIFT_DOWN)->max == 7);
+	TEST_ASSERT(adt_stats_histogram(ADT_EVENT_MAP_REHASH)->count == 0);
+
+	for (int i = 0; i < ADT_EVENT_NO; i++)
+		TEST_ASSERT(adt_event_name(i) != NULL);
+	TEST_ASSERT(strcmp(adt_event_name(ADT_EVENT_MAP_REHASH), "map_rehash_ns") == 0);
+
+	adt_stats_reset();
+	TEST_ASSERT(adt_stats_histogram(ADT_EVENT_SET_ROTATION)->count == 0);
+}
+
+
+// Λίστα με όλα τα tests προς εκτέλεση
+TEST_LIST = {
+	{ "adt_histogram", test_histogram },
+	{ "adt_stats_events", test_events },
+	{ NULL, NULL } // τερματίζουμε τη λίστα με NULL
+};
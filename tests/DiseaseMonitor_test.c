@@ -7,6 +7,11 @@
 
 #include "acutest.h"			// Απλή βιβλιοθήκη για unit testing
 #include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
 
 #include "DiseaseMonitor.h"
 
@@ -159,6 +164,48 @@ void test_get_records(void) {
 	dm_destroy();
 }
 
+// Ελέγχει ότι ο cursor επιστρέφει τις ίδιες εγγραφές με την dm_get_records, σε χρονολογική σειρά
+void cursor_and_test(String disease, String country, Date date_from, Date date_to) {
+	List recs = dm_get_records(disease, country, date_from, date_to);
+	int size = list_size(recs);
+	int ids[size > 0 ? size : 1];
+
+	DmCursor cursor;
+	dm_records_cursor(&cursor, disease, country, date_from, date_to);
+
+	int count = 0;
+	Record last = NULL;
+	for (Record record = dm_cursor_next(&cursor); record != NULL; record = dm_cursor_next(&cursor)) {
+		TEST_ASSERT(count < size);
+		TEST_ASSERT(last == NULL || strcmp(last->date, record->date) <= 0);
+		ids[count++] = record->id;
+		last = record;
+	}
+	TEST_ASSERT(dm_cursor_next(&cursor) == NULL);
+
+	check_record_list(recs, ids, count);
+}
+
+void test_records_cursor(void) {
+	dm_init();
+
+	// insert records
+	for(int i = 0; i < record_no; i++)
+		dm_insert_record(&records[i]);
+
+	cursor_and_test(NULL,        NULL,        NULL,         NULL        );
+	cursor_and_test("Pale Mare", NULL,        NULL,         NULL        );
+	cursor_and_test("Pale Mare", "Targaryen", NULL,         NULL        );
+	cursor_and_test(NULL,        NULL,        "0301-01-01", NULL        );
+	cursor_and_test(NULL,        NULL,        NULL,         "0297-01-01");
+	cursor_and_test("Grayscale", NULL,        "0299-01-01", "0300-01-01");
+	cursor_and_test(NULL,        "Lannister", "0299-01-01", "0301-01-01");
+	cursor_and_test(NULL,        "Lannister", "0303-01-01", NULL        );	// Περίπτωση που δεν υπάρχουν εγγραφές
+	cursor_and_test(NULL,        "Snow",      "0299-01-01", "0301-01-01");
+
+	dm_destroy();
+}
+
 // Εκτελεί τη dm_count_records και ελέγχει ότι επιστρέφει τον ίδιο αριθμό
 // αποτελεσμάτων με την dm_get_records.
 void count_and_test(String disease, String country, Date date_from, Date date_to) {
@@ -189,6 +236,99 @@ void test_count_records(void) {
 	dm_destroy();
 }
 
+void test_percentile_date(void) {
+	dm_init();
+
+	// insert records
+	for(int i = 0; i < record_no; i++)
+		dm_insert_record(&records[i]);
+
+	// Lannister: 0299, 0301, 0302, 0302
+	TEST_ASSERT(strcmp(dm_percentile_date(NULL, "Lannister", NULL, NULL, 0), "0299-01-01") == 0);
+	TEST_ASSERT(strcmp(dm_percentile_date(NULL, "Lannister", NULL, NULL, 25), "0299-01-01") == 0);
+	TEST_ASSERT(strcmp(dm_percentile_date(NULL, "Lannister", NULL, NULL, 50), "0301-01-01") == 0);
+	TEST_ASSERT(strcmp(dm_percentile_date(NULL, "Lannister", NULL, NULL, 51), "0302-01-01") == 0);
+	TEST_ASSERT(strcmp(dm_percentile_date(NULL, "Lannister", NULL, NULL, 100), "0302-01-01") == 0);
+
+	// Pale Mare μετά το 0290: 0300, 0300, 0301, 0301, 0301
+	TEST_ASSERT(strcmp(dm_percentile_date("Pale Mare", NULL, "0290-01-01", NULL, 40), "0300-01-01") == 0);
+	TEST_ASSERT(strcmp(dm_percentile_date("Pale Mare", NULL, "0290-01-01", NULL, 90), "0301-01-01") == 0);
+
+	// Όλες οι εγγραφές μέχρι το 0298: 0271, 0281, 0296, 0298, 0298
+	TEST_ASSERT(strcmp(dm_percentile_date(NULL, NULL, NULL, "0298-01-01", 50), "0296-01-01") == 0);
+
+	// Περιπτώσεις που δεν υπάρχουν εγγραφές
+	TEST_ASSERT(dm_percentile_date(NULL, "Snow", NULL, NULL, 50) == NULL);
+	TEST_ASSERT(dm_percentile_date(NULL, "Stark", "0302-01-01", NULL, 50) == NULL);
+
+	dm_destroy();
+}
+
+void test_count_records_by_day(void) {
+	dm_init();
+
+	// Εγγραφές με ημερομηνίες που διασχίζουν όρια μηνών και ετών (και μία 29η Φεβρουαρίου),
+	// προστιθέμενες σε μη χρονολογική σειρά ώστε οι μετρητές να μεγαλώνουν προς τις δύο πλευρές
+	String dates[] = { "2020-03-01", "2020-02-29", "2019-12-31", "2020-01-01", "2020-02-28", "2021-01-01",
+		"2000-02-29", "2020-03-01", "2019-01-01", "2024-12-31", "2020-02-29", "2020-01-31" };
+	String countries[] = { "Greece", "Italy", "Greece" };
+	String diseases[] = { "COVID-19", "Flu" };
+	int N = sizeof(dates) / sizeof(String);
+
+	struct record day_records[N];
+	for (int i = 0; i < N; i++) {
+		day_records[i] = (struct record) { .id = i, .name = "Name", .date = dates[i], .country = countries[i % 3], .disease = diseases[i % 2] };
+		dm_insert_record(&day_records[i]);
+	}
+
+	for (int i = 0; i < N; i++) {
+		for (int j = 0; j < N; j++) {
+			count_and_test(NULL,       NULL,     dates[i], dates[j]);
+			count_and_test("Flu",      NULL,     dates[i], dates[j]);
+			count_and_test(NULL,       "Greece", dates[i], NULL    );
+			count_and_test("COVID-19", "Italy",  NULL,     dates[j]);
+		}
+	}
+	count_and_test(NULL, NULL, "2020-02-29", "2020-02-29");
+	TEST_ASSERT(dm_count_records(NULL, NULL, "2020-02-29", "2020-02-29") == 2);
+
+	// Εγγραφή πολύ μακριά χρονικά από τις υπόλοιπες, οι μετρήσεις πρέπει να μείνουν σωστές
+	struct record far = { .id = N, .name = "Name", .date = "0300-01-01", .country = "Greece", .disease = "Flu" };
+	dm_insert_record(&far);
+	for (int i = 0; i < N; i++) {
+		count_and_test(NULL,  NULL,     NULL,         dates[i]);
+		count_and_test("Flu", "Greece", "0299-01-01", dates[i]);
+	}
+	dm_remove_record(N);
+	count_and_test(NULL, NULL, "2000-01-01", "2020-12-31");
+
+	// Ημερομηνίες που δεν υπάρχουν στο ημερολόγιο (και ως όρια αναζήτησης): η μέτρηση πρέπει
+	// να δίνει ό,τι και η dm_get_records, που συγκρίνει τα strings
+	struct record odd[] = {
+		{ .id = N + 1, .name = "Name", .date = "2000-01-01", .country = "Odd", .disease = "Flu" },
+		{ .id = N + 2, .name = "Name", .date = "2000-02-99", .country = "Odd", .disease = "Flu" },
+		{ .id = N + 3, .name = "Name", .date = "2000-03-01", .country = "Odd", .disease = "Flu" },
+	};
+	Date bounds[] = { NULL, "1999-12-31", "2000-01-01", "2000-02-30", "2000-02-99", "2000-03-01", "2000-13-01" };
+	int bound_no = sizeof(bounds) / sizeof(Date);
+
+	for (int i = 0; i < 3; i++)
+		dm_insert_record(&odd[i]);
+	for (int removed = 0; removed < 2; removed++) {
+		for (int f = 0; f < bound_no; f++) {
+			for (int t = 0; t < bound_no; t++) {
+				count_and_test(NULL,  "Odd", bounds[f], bounds[t]);
+				count_and_test("Flu", NULL,  bounds[f], bounds[t]);
+				count_and_test(NULL,  NULL,  bounds[f], bounds[t]);
+			}
+		}
+		dm_remove_record(N + 2);
+	}
+	TEST_ASSERT(dm_count_records(NULL, "Odd", "2000-03-01", NULL) == 1);
+
+	dm_destroy();
+}
+
 // Ελεγχος ότι κάθε ασθένεια έχει λιγότερες εγγραφές από την προηγούμενη
 void run_and_test_top_diseases(int k, String country) {
 	List result = dm_top_diseases(k, country);
@@ -232,14 +372,664 @@ void test_top_diseases(void) {
 
 
 
+// Ελεγχος ότι η dm_top_diseases_range επιστρέφει τις σωστές ασθένειες σε φθίνουσα σειρά εγγραφών
+void run_and_test_top_diseases_range(int k, String country, Date date_from, Date date_to) {
+	String diseases[] = { "Grayscale", "Headache", "Pale Mare", "Madness", "Burns", "Eye pain" };
+	int disease_no = sizeof(diseases) / sizeof(String);
+
+	// Οι ασθένειες με τουλάχιστον 1 εγγραφή στο εύρος
+	int expected = 0;
+	for (int i = 0; i < disease_no; i++)
+		if (dm_count_records(diseases[i], country, date_from, date_to) > 0)
+			expected++;
+
+	List result = dm_top_diseases_range(k, country, date_from, date_to);
+	TEST_ASSERT(list_size(result) == (k < expected ? k : expected));
+
+	int last_count = INT_MAX;
+	for (ListNode node = list_first(result); node != LIST_EOF; node = list_next(result, node)) {
+		int count = dm_count_records(list_node_value(result, node), country, date_from, date_to);
+		TEST_ASSERT(count > 0 && count <= last_count);
+		last_count = count;
+	}
+
+	// Καμία ασθένεια εκτός λίστας δεν έχει περισσότερες εγγραφές από την τελευταία της λίστας
+	for (int i = 0; i < disease_no; i++) {
+		bool found = false;
+		for (ListNode node = list_first(result); node != LIST_EOF; node = list_next(result, node))
+			found = found || strcmp(list_node_value(result, node), diseases[i]) == 0;
+		TEST_ASSERT(found || dm_count_records(diseases[i], country, date_from, date_to) <= last_count);
+	}
+
+	list_destroy(result);
+}
+
+void test_top_diseases_range(void) {
+	dm_init();
+
+	// insert records
+	for(int i = 0; i < record_no; i++)
+		dm_insert_record(&records[i]);
+
+	for (int k = 1; k <= 6; k++) {
+		run_and_test_top_diseases_range(k, NULL,        NULL,         NULL        );
+		run_and_test_top_diseases_range(k, NULL,        "0299-01-01", "0300-01-01");
+		run_and_test_top_diseases_range(k, NULL,        "0301-01-01", NULL        );
+		run_and_test_top_diseases_range(k, "Targaryen", NULL,         "0298-01-01");
+		run_and_test_top_diseases_range(k, "Stark",     "0299-01-01", NULL        );
+		run_and_test_top_diseases_range(k, "Snow",      NULL,         NULL        );
+	}
+
+	// Στο 0300 μόνο: Grayscale 1 (Petyr), Pale Mare 2 (Euron, Theon)
+	List result = dm_top_diseases_range(1, NULL, "0300-01-01", "0300-01-01");
+	TEST_ASSERT(list_size(result) == 1);
+	TEST_ASSERT(strcmp(list_node_value(result, list_first(result)), "Pale Mare") == 0);
+	list_destroy(result);
+
+	dm_destroy();
+}
+
+
+void test_disease_cases(void) {
+	DiseaseMonitor monitor = dm_create();
+	for (int i = 0; i < record_no; i++)
+		monitor_insert_record(monitor, &records[i]);
+
+	// Η Madness έχει μόνο την εγγραφή 7, οπότε μετά την αφαίρεση δεν επιστρέφεται
+	monitor_remove_record(monitor, 7);
+
+	List cases = monitor_disease_cases(monitor);
+	TEST_ASSERT(list_size(cases) == 5);
+
+	int total = 0;
+	for (ListNode node = list_first(cases); node != LIST_EOF; node = list_next(cases, node)) {
+		DisCases count = list_node_value(cases, node);
+		TEST_ASSERT(strcmp(count->disease, "Madness") != 0);
+		TEST_ASSERT(count->cases == monitor_count_records(monitor, count->disease, NULL, NULL, NULL));
+		total += count->cases;
+	}
+	TEST_ASSERT(total == record_no - 1);
+
+	list_destroy(cases);
+	dm_free(monitor);
+}
+
+void test_multiple_monitors(void) {
+	DiseaseMonitor first = dm_create();
+	DiseaseMonitor second = dm_create();
+
+	// Οι μισές εγγραφές στο πρώτο monitor και οι άλλες μισές στο δεύτερο
+	for (int i = 0; i < record_no; i++)
+		TEST_ASSERT(!monitor_insert_record(i % 2 ? second : first, &records[i]));
+
+	// Ταυτόχρονα και το default monitor με όλες τις εγγραφές
+	dm_init();
+	for (int i = 0; i < record_no; i++)
+		dm_insert_record(&records[i]);
+
+	// Τα πλήθη των δύο monitors αθροίζονται στο πλήθος του default
+	TEST_ASSERT(monitor_count_records(first, NULL, NULL, NULL, NULL) == record_no / 2);
+	TEST_ASSERT(monitor_count_records(second, NULL, NULL, NULL, NULL) == record_no - record_no / 2);
+	TEST_ASSERT(monitor_count_records(first, "Grayscale", NULL, NULL, NULL) + monitor_count_records(second, "Grayscale", NULL, NULL, NULL)
+		== dm_count_records("Grayscale", NULL, NULL, NULL));
+
+	// Το id 1 υπάρχει μόνο στο πρώτο
+	TEST_ASSERT(!monitor_remove_record(second, 1));
+	TEST_ASSERT(monitor_remove_record(first, 1));
+	TEST_ASSERT(dm_count_records(NULL, NULL, NULL, NULL) == record_no);
+
+	List list = monitor_get_records(second, NULL, "Stark", NULL, NULL);
+	int ids[] = {4, 6, 10};
+	check_record_list(list, ids, 3);
+
+	dm_free(first);
+	dm_free(second);
+	dm_destroy();
+}
+
+// Thread που εκτελεί queries σε concurrent monitor μέχρι να γίνει true το done
+
+struct reader {
+	DiseaseMonitor monitor;
+	_Atomic bool* done;
+	int queries;
+	bool consistent;
+};
+
+static void* reader_thread(void* arg) {
+	struct reader* reader = arg;
+
+	while (!*reader->done) {
+		// Τα queries βλέπουν πάντα ολόκληρες ομάδες προσθηκών
+		int count = monitor_count_records(reader->monitor, NULL, NULL, NULL, NULL);
+		if (count % 5 != 0 && count % 5 != 4)
+			reader->consistent = false;
+
+		List list = monitor_get_records(reader->monitor, "Grayscale", NULL, NULL, NULL);
+		if (list_size(list) > 10)
+			reader->consistent = false;
+		list_destroy(list);
+
+		List top = monitor_top_diseases(reader->monitor, 2, NULL);
+		if (list_size(top) > 0 && count > 4 && strcmp(list_node_value(top, list_first(top)), "Grayscale") != 0)
+			reader->consistent = false;
+		list_destroy(top);
+
+		// Διάσχιση με cursor, κρατώντας το read lock
+		monitor_read_lock(reader->monitor);
+		DmCursor cursor;
+		int cursor_count = 0;
+		monitor_records_cursor(reader->monitor, &cursor, NULL, NULL, NULL, NULL);
+		for (Record record = dm_cursor_next(&cursor), prev = NULL; record != NULL; prev = record, record = dm_cursor_next(&cursor)) {
+			if (prev != NULL && strcmp(prev->date, record->date) > 0)
+				reader->consistent = false;
+			cursor_count++;
+		}
+		monitor_read_unlock(reader->monitor);
+		if (cursor_count > record_no)
+			reader->consistent = false;
+
+		reader->queries++;
+	}
+	return NULL;
+}
+
+void test_concurrent(void) {
+	DiseaseMonitor monitor = dm_create_concurrent();
+
+	_Atomic bool done = false;
+	struct reader readers[3];
+	pthread_t threads[3];
+	for (int i = 0; i < 3; i++) {
+		readers[i] = (struct reader) { .monitor = monitor, .done = &done, .queries = 0, .consistent = true };
+		pthread_create(&threads[i], NULL, reader_thread, &readers[i]);
+	}
+
+	// Προσθέτουμε και αφαιρούμε εγγραφές σε ομάδες ενώ εκτελούνται τα queries
+	Record batch[record_no];
+	for (int i = 0; i < record_no; i++)
+		batch[i] = &records[i];
+
+	for (int round = 0; round < 200; round++) {
+		for (int i = 0; i < record_no; i += 5)
+			TEST_ASSERT(monitor_insert_records(monitor, &batch[i], 5) == (round == 0 ? 0 : 5 - (i / 5 == round % 4)));
+		TEST_ASSERT(monitor_remove_record(monitor, 1 + 5 * ((round + 1) % 4)));
+	}
+	done = true;
+
+	for (int i = 0; i < 3; i++) {
+		pthread_join(threads[i], NULL);
+		TEST_ASSERT(readers[i].consistent);
+	}
+
+	// Η τελευταία αφαίρεση ήταν του id 1 + 5 * (200 % 4) = 1
+	TEST_ASSERT(monitor_count_records(monitor, NULL, NULL, NULL, NULL) == record_no - 1);
+	TEST_ASSERT(monitor_count_records(monitor, "Grayscale", NULL, NULL, NULL) == 9);
+
+	dm_free(monitor);
+}
+
+// Thread που προσθέτει και αφαιρεί εγγραφές στο monitor μέχρι να γίνει true το done
+
+struct writer {
+	DiseaseMonitor monitor;
+	_Atomic bool* done;
+};
+
+static void* writer_thread(void* arg) {
+	struct writer* writer = arg;
+
+	for (int round = 0; !*writer->done; round++) {
+		monitor_remove_record(writer->monitor, records[round % record_no].id);
+		monitor_insert_record(writer->monitor, &records[(round + record_no / 2) % record_no]);
+	}
+	return NULL;
+}
+
+void test_snapshot(void) {
+	dm_init();
+	for (int i = 0; i < record_no; i++)
+		dm_insert_record(&records[i]);
+
+	DiseaseMonitor snapshot = dm_snapshot();
+
+	// Αλλαγές στο monitor μετά το snapshot
+	dm_insert_record(&same_id);
+	for (int i = 1; i < record_no; i += 2)
+		dm_remove_record(records[i].id);
+	TEST_ASSERT(dm_count_records(NULL, NULL, NULL, NULL) == record_no / 2);
+
+	// Το snapshot έχει όλες τις αρχικές εγγραφές
+	TEST_ASSERT(monitor_count_records(snapshot, NULL, NULL, NULL, NULL) == record_no);
+	TEST_ASSERT(monitor_count_records(snapshot, "Grayscale", NULL, NULL, NULL) == 10);
+	TEST_ASSERT(monitor_count_records(snapshot, NULL, "Stark", "0299-01-01", NULL) == 3);
+	TEST_ASSERT(monitor_count_records(snapshot, "Random", NULL, NULL, NULL) == 0);
+	TEST_ASSERT(strcmp(monitor_percentile_date(snapshot, NULL, NULL, NULL, NULL, 50), "0300-01-01") == 0);
+
+	List list = monitor_get_records(snapshot, NULL, "Stark", NULL, NULL);
+	int ids[] = {4, 6, 10, 11};
+	check_record_list(list, ids, 4);
+
+	List top = monitor_top_diseases(snapshot, 2, NULL);
+	TEST_ASSERT(list_size(top) == 2);
+	TEST_ASSERT(strcmp(list_node_value(top, list_first(top)), "Grayscale") == 0);
+	TEST_ASSERT(strcmp(list_node_value(top, list_next(top, list_first(top))), "Pale Mare") == 0);
+	list_destroy(top);
+
+	top = monitor_top_diseases(snapshot, 5, "Targaryen");
+	TEST_ASSERT(list_size(top) == 3);
+	TEST_ASSERT(strcmp(list_node_value(top, list_first(top)), "Grayscale") == 0);
+	list_destroy(top);
+
+	dm_free(snapshot);
+	dm_destroy();
+
+	// Queries σε snapshot ενώ άλλο thread αλλάζει το monitor
+	DiseaseMonitor monitor = dm_create_concurrent();
+	for (int i = 0; i < record_no; i++)
+		monitor_insert_record(monitor, &records[i]);
+
+	_Atomic bool done = false;
+	struct writer writer = { monitor, &done };
+	pthread_t thread;
+	pthread_create(&thread, NULL, writer_thread, &writer);
+
+	for (int round = 0; round < 200; round++) {
+		snapshot = monitor_snapshot(monitor);
+
+		// Το snapshot είναι πάντα συνεπές: τα πλήθη ανά χώρα αθροίζουν στο συνολικό
+		int count = monitor_count_records(snapshot, NULL, NULL, NULL, NULL);
+		int sum = 0;
+		for (int i = 0; i < record_no; i++) {
+			// Μετράμε κάθε χώρα μία φορά, στην πρώτη εγγραφή της
+			int first;
+			for (first = 0; strcmp(records[first].country, records[i].country) != 0; first++)
+				;
+			if (first == i)
+				sum += monitor_count_records(snapshot, NULL, records[i].country, NULL, NULL);
+		}
+		TEST_ASSERT(sum == count);
+
+		list = monitor_get_records(snapshot, NULL, NULL, "0290-01-01", NULL);
+		TEST_ASSERT(list_size(list) == monitor_count_records(snapshot, NULL, NULL, "0290-01-01", NULL));
+		list_destroy(list);
+
+		dm_free(snapshot);
+	}
+
+	done = true;
+	pthread_join(thread, NULL);
+	dm_free(monitor);
+}
+
+void test_save_load(void) {
+	String path = "DiseaseMonitor_test.dat";
+
+	dm_init();
+	for (int i = 0; i < record_no; i++)
+		dm_insert_record(&records[i]);
+	dm_insert_record(&same_id);
+	dm_remove_record(5);
+	TEST_ASSERT(dm_save(path));
+
+	DiseaseMonitor loaded = monitor_load(path);
+	TEST_ASSERT(loaded != NULL);
+
+	// Ολα τα queries δίνουν τα ίδια αποτελέσματα
+	String diseases[] = { NULL, "Grayscale", "Pale Mare", "Random", "Headache", "Unknown" };
+	String countries[] = { NULL, "Stark", "Targaryen", "Random", "Unknown" };
+	String dates[] = { NULL, "0271-01-01", "0298-01-01", "0301-01-01" };
+	for (int d = 0; d < 6; d++) {
+		for (int c = 0; c < 5; c++) {
+			for (int f = 0; f < 4; f++) {
+				for (int t = 0; t < 4; t++) {
+					TEST_ASSERT(monitor_count_records(loaded, diseases[d], countries[c], dates[f], dates[t]) ==
+								dm_count_records(diseases[d], countries[c], dates[f], dates[t]));
+				}
+			}
+		}
+
+		List top = monitor_top_diseases(loaded, 3, countries[d % 5]);
+		List expected = dm_top_diseases(3, countries[d % 5]);
+		TEST_ASSERT(list_size(top) == list_size(expected));
+		for (ListNode node = list_first(top), exp = list_first(expected); node != LIST_EOF; node = list_next(top, node), exp = list_next(expected, exp))
+			TEST_ASSERT(dm_count_records(list_node_value(top, node), countries[d % 5], NULL, NULL) ==
+						dm_count_records(list_node_value(expected, exp), countries[d % 5], NULL, NULL));
+		list_destroy(top);
+		list_destroy(expected);
+	}
+
+	// Οι εγγραφές είναι αντίγραφα με τα ίδια δεδομένα
+	List list = monitor_get_records(loaded, NULL, "Random", NULL, NULL);
+	TEST_ASSERT(list_size(list) == 1);
+	Record record = list_node_value(list, list_first(list));
+	TEST_ASSERT(record != &same_id && record->id == 1 && strcmp(record->name, "Random") == 0 && strcmp(record->date, "0292-01-01") == 0);
+	list_destroy(list);
+
+	// Το monitor που φορτώθηκε δέχεται κανονικά αλλαγές
+	TEST_ASSERT(monitor_insert_record(loaded, &records[0]));
+	TEST_ASSERT(monitor_remove_record(loaded, 2));
+	TEST_ASSERT(monitor_count_records(loaded, "Grayscale", NULL, NULL, NULL) == 9);
+	dm_free(loaded);
+
+	// Η dm_load αντικαθιστά το default monitor
+	dm_remove_record(1);
+	TEST_ASSERT(dm_load(path));
+	TEST_ASSERT(dm_count_records(NULL, "Random", NULL, NULL) == 1);
+	TEST_ASSERT(dm_count_records(NULL, NULL, NULL, NULL) == record_no - 1);
+
+	// Αρχεία που δεν υπάρχουν ή δεν είναι έγκυρα
+	TEST_ASSERT(monitor_load("does_not_exist.dat") == NULL);
+	FILE* file = fopen(path, "r+b");
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fclose(file);
+	TEST_ASSERT(truncate(path, size - 1) == 0);
+	TEST_ASSERT(!dm_load(path));
+	TEST_ASSERT(dm_count_records(NULL, NULL, NULL, NULL) == record_no - 1);
+
+	// Header με μεγέθη πινάκων μεγαλύτερα από το αρχείο (string_bytes είναι στη θέση 12)
+	TEST_ASSERT(dm_save(path));
+	uint32_t huge = UINT32_MAX;
+	file = fopen(path, "r+b");
+	fseek(file, 12, SEEK_SET);
+	fwrite(&huge, sizeof(huge), 1, file);
+	fclose(file);
+	TEST_ASSERT(monitor_load(path) == NULL);
+
+	// Ημερομηνία που δεν υπάρχει στο ημερολόγιο
+	DiseaseMonitor odd = dm_create();
+	struct record odd_records[] = {
+		{ .id = 1, .name = "Name", .date = "2000-01-01", .country = "Odd", .disease = "Flu" },
+		{ .id = 2, .name = "Name", .date = "2000-02-99", .country = "Odd", .disease = "Flu" },
+		{ .id = 3, .name = "Name", .date = "2000-03-01", .country = "Odd", .disease = "Flu" },
+	};
+	for (int i = 0; i < 3; i++)
+		monitor_insert_record(odd, &odd_records[i]);
+	TEST_ASSERT(monitor_save(odd, path));
+	TEST_ASSERT(monitor_load(path) == NULL);
+	dm_free(odd);
+
+	remove(path);
+	dm_destroy();
+}
+
+void test_ingest_csv(void) {
+	String path = "DiseaseMonitor_test.csv";
+
+	// CSV με επικεφαλίδα, CRLF, κενή γραμμή και λάθος γραμμές
+	FILE* file = fopen(path, "w");
+	fprintf(file, "id,name,disease,country,date\r\n");
+	for (int i = 0; i < record_no; i++)
+		fprintf(file, "%d,%s,%s,%s,%s%s", records[i].id, records[i].name, records[i].disease,
+				records[i].country, records[i].date, i % 2 ? "\r\n" : "\n");
+	fprintf(file, "\n");
+	fprintf(file, "x1,Bad,Grayscale,Stark,0301-01-01\n");			// μη αριθμητικό id
+	fprintf(file, "100,Bad,Grayscale,Stark\n");						// λείπει πεδίο
+	fprintf(file, "101,Bad,Grayscale,Stark,0301-01-01,extra\n");	// επιπλέον πεδίο
+	fprintf(file, "102,Bad,Grayscale,Stark,301-01-01\n");			// λάθος ημερομηνία
+	fprintf(file, "103,Bad,Grayscale,Stark,0301-13-01\n");			// μήνας εκτός ορίων
+	fprintf(file, "104,Bad,Grayscale,Stark,0300-02-29\n");			// δεν είναι δίσεκτο έτος
+	fprintf(file, "%d,%s,%s,%s,%s", same_id.id, same_id.name, same_id.disease, same_id.country, same_id.date);	// χωρίς '\n'
+	fclose(file);
+
+	dm_init();
+	DmIngestStats stats;
+	int fd = open(path, O_RDONLY);
+	TEST_ASSERT(dm_ingest_csv(fd, &stats) == record_no + 1);
+	close(fd);
+
+	TEST_ASSERT(stats.records == record_no + 1);
+	TEST_ASSERT(stats.rejected == 6);
+	TEST_ASSERT(stats.bytes > 0 && stats.read_seconds >= 0 && stats.parse_seconds >= 0 && stats.insert_seconds >= 0);
+
+	// Η τελευταία γραμμή αντικατέστησε την εγγραφή με id 1
+	TEST_ASSERT(dm_count_records(NULL, NULL, NULL, NULL) == record_no);
+	TEST_ASSERT(dm_count_records("Grayscale", NULL, NULL, NULL) == 9);
+	TEST_ASSERT(dm_count_records("Pale Mare", "Stark", "0301-01-01", NULL) == 3);
+	List list = dm_get_records("Random", "Random", NULL, NULL);
+	TEST_ASSERT(list_size(list) == 1);
+	Record record = list_node_value(list, list_first(list));
+	TEST_ASSERT(record->id == 1 && strcmp(record->name, "Random") == 0 && strcmp(record->date, "0292-01-01") == 0);
+	list_destroy(list);
+
+	// TSV, αρκετά μεγάλο ώστε οι γραμμές να μοιράζονται σε πολλά blocks
+	int big_no = 60000;
+	file = fopen(path, "w");
+	for (int i = 0; i < big_no; i++)
+		fprintf(file, "%d\tName %d\t%s\t%s\t%04d-%02d-%02d\n", 1000 + i, i, i % 3 ? "Flu" : "Cold",
+				i % 2 ? "Country, with comma" : "Other", 2000 + i % 7, 1 + i % 12, 1 + i % 28);
+	fclose(file);
+
+	DiseaseMonitor monitor = dm_create();
+	fd = open(path, O_RDONLY);
+	TEST_ASSERT(monitor_ingest_csv(monitor, fd, NULL) == big_no);
+	close(fd);
+
+	TEST_ASSERT(monitor_count_records(monitor, NULL, NULL, NULL, NULL) == big_no);
+	TEST_ASSERT(monitor_count_records(monitor, "Cold", NULL, NULL, NULL) == big_no / 3);
+	TEST_ASSERT(monitor_count_records(monitor, NULL, "Country, with comma", NULL, NULL) == big_no / 2);
+	TEST_ASSERT(monitor_remove_record(monitor, 1000 + big_no - 1));
+	dm_free(monitor);
+
+	// Σφάλμα ανάγνωσης
+	TEST_ASSERT(dm_ingest_csv(-1, NULL) == -1);
+
+	remove(path);
+	dm_destroy();
+}
+
+void test_owning(void) {
+	dm_init_owning();
+
+	// Οι εγγραφές δημιουργούνται σε buffers που αλλάζουν μετά από κάθε insert
+	char name[32], disease[32], country[32], date[11];
+	struct record record = { .name = name, .disease = disease, .country = country, .date = date };
+	for (int i = 0; i < record_no; i++) {
+		record.id = records[i].id;
+		strcpy(name, records[i].name);
+		strcpy(disease, records[i].disease);
+		strcpy(country, records[i].country);
+		strcpy(date, records[i].date);
+		TEST_ASSERT(!dm_insert_record(&record));
+	}
+	strcpy(name, "Overwritten");
+	strcpy(disease, "Overwritten");
+
+	TEST_ASSERT(dm_count_records(NULL, NULL, NULL, NULL) == record_no);
+	TEST_ASSERT(dm_count_records("Grayscale", "Lannister", NULL, NULL) == 4);
+	TEST_ASSERT(dm_count_records("Overwritten", NULL, NULL, NULL) == 0);
+
+	// Οι εγγραφές της λίστας είναι αντίγραφα, και τα κοινά strings υπάρχουν μία φορά
+	List list = dm_get_records("Grayscale", NULL, NULL, NULL);
+	TEST_ASSERT(list_size(list) == 10);
+	Record first = list_node_value(list, list_first(list));
+	for (ListNode node = list_first(list); node != LIST_EOF; node = list_next(list, node)) {
+		Record copy = list_node_value(list, node);
+		TEST_ASSERT(copy != &record && copy->disease == first->disease);
+
+		int i = copy->id - 1;
+		TEST_ASSERT(strcmp(copy->name, records[i].name) == 0 && strcmp(copy->country, records[i].country) == 0 &&
+					strcmp(copy->date, records[i].date) == 0);
+	}
+	list_destroy(list);
+
+	// Αντικατάσταση και αφαίρεση
+	TEST_ASSERT(dm_insert_record(&same_id));
+	TEST_ASSERT(dm_count_records("Random", NULL, NULL, NULL) == 1);
+	TEST_ASSERT(dm_remove_record(1));
+	TEST_ASSERT(dm_count_records(NULL, NULL, NULL, NULL) == record_no - 1);
+
+	List top = dm_top_diseases(1, NULL);
+	TEST_ASSERT(list_size(top) == 1 && strcmp(list_node_value(top, list_first(top)), "Grayscale") == 0);
+	list_destroy(top);
+
+	// Μεγάλα strings (μεγαλύτερα από ένα block του arena)
+	char long_name[100000];
+	memset(long_name, 'a', sizeof(long_name) - 1);
+	long_name[sizeof(long_name) - 1] = '\0';
+	struct record long_record = { .id = 100, .name = long_name, .disease = "Grayscale", .country = "Stark", .date = "0301-01-01" };
+	TEST_ASSERT(!dm_insert_record(&long_record));
+	list = dm_get_records(NULL, "Stark", "0301-01-01", "0301-01-01");
+	TEST_ASSERT(list_size(list) == 4);
+	list_destroy(list);
+
+	dm_destroy();
+}
+
+// Επιστρέφει αν το string είναι ένα από τα n strings του strings (αληθές για n == 0)
+
+static bool string_in(String string, String strings[], int n) {
+	for (int i = 0; i < n; i++)
+		if (strcmp(strings[i], string) == 0)
+			return true;
+	return n == 0;
+}
+
+// Ελέγχει τη dm_count_where με όλους τους συνδυασμούς ζευγαριών χωρών/ασθενειών και ημερομηνιών,
+// συγκρίνοντας με απλή διάσχιση των records που υπάρχουν (present)
+
+static void check_count_where(bool present[]) {
+	String countries[] = { "Targaryen", "Lannister", "Stark", "Unknown" };
+	String diseases[] = { "Grayscale", "Pale Mare", "Burns", "Unknown" };
+	Date dates[] = { NULL, "0281-01-01", "0299-01-01", "0301-01-01" };
+
+	for (int c = 0; c < 16; c++) {
+		for (int d = 0; d < 16; d++) {
+			for (int f = 0; f < 4; f++) {
+				for (int t = 0; t < 4; t++) {
+					// Τα bits των c, d επιλέγουν χώρες/ασθένειες
+					String filter_countries[4], filter_diseases[4];
+					int country_no = 0, disease_no = 0;
+					for (int i = 0; i < 4; i++) {
+						if (c & (1 << i))
+							filter_countries[country_no++] = countries[i];
+						if (d & (1 << i))
+							filter_diseases[disease_no++] = diseases[i];
+					}
+					DmFilter filter = { filter_countries, country_no, filter_diseases, disease_no, dates[f], dates[t] };
+
+					int expected = 0;
+					for (int i = 0; i < record_no; i++)
+						expected += present[i] &&
+							string_in(records[i].country, filter_countries, country_no) &&
+							string_in(records[i].disease, filter_diseases, disease_no) &&
+							(dates[f] == NULL || strcmp(records[i].date, dates[f]) >= 0) &&
+							(dates[t] == NULL || strcmp(records[i].date, dates[t]) <= 0);
+
+					TEST_ASSERT(dm_count_where(&filter) == expected);
+				}
+			}
+		}
+	}
+}
+
+void test_count_where(void) {
+	dm_init();
+	bool present[record_no];
+
+	// Κενό monitor
+	DmFilter filter = { 0 };
+	TEST_ASSERT(dm_count_where(&filter) == 0);
+
+	for (int i = 0; i < record_no; i++) {
+		dm_insert_record(&records[i]);
+		present[i] = true;
+	}
+	TEST_ASSERT(dm_count_where(&filter) == record_no);
+	check_count_where(present);
+
+	// Οι στήλες ενημερώνονται στις αφαιρέσεις
+	for (int i = 0; i < record_no; i += 3) {
+		dm_remove_record(records[i].id);
+		present[i] = false;
+	}
+	check_count_where(present);
+
+	// και στις προσθήκες
+	for (int i = 0; i < record_no; i += 6) {
+		dm_insert_record(&records[i]);
+		present[i] = true;
+	}
+	check_count_where(present);
+
+	// Πίνακας NULL σημαίνει χωρίς κριτήριο, ανεξάρτητα από το πλήθος
+	DmFilter no_names = { .countries = NULL, .country_no = 1000000000, .diseases = NULL, .disease_no = 3 };
+	TEST_ASSERT(dm_count_where(&no_names) == dm_count_records(NULL, NULL, NULL, NULL));
+
+	dm_destroy();
+}
+
+
+// Διαβάζει ό,τι γράφτηκε στο file (από την αρχή) σε ένα buffer
+
+static void read_all(FILE* file, char* buffer, int size) {
+	rewind(file);
+	int n = fread(buffer, 1, size - 1, file);
+	buffer[n] = '\0';
+}
+
+void test_stats_dump(void) {
+	dm_stats_reset();
+	dm_init();
+
+	for (int i = 0; i < record_no; i++)
+		dm_insert_record(&records[i]);
+	dm_count_records(NULL, NULL, NULL, NULL);
+
+	static char buffer[64 * 1024];
+
+	// JSON: όλες οι κλήσεις υπάρχουν, ακόμα και χωρίς ADT_STATS (με κενά ιστογράμματα)
+	FILE* file = tmpfile();
+	TEST_ASSERT(dm_stats_dump(fileno(file), DM_STATS_JSON));
+	read_all(file, buffer, sizeof(buffer));
+	TEST_ASSERT(buffer[0] == '{');
+	TEST_ASSERT(strstr(buffer, "\"insert_record\"") != NULL);
+	TEST_ASSERT(strstr(buffer, "\"map_rehash_ns\"") != NULL);
+#ifdef ADT_STATS
+	TEST_ASSERT(strstr(buffer, "\"enabled\": true") != NULL);
+	TEST_ASSERT(strstr(buffer, "\"insert_record\": {\"count\": 0") == NULL);
+#endif
+	fclose(file);
+
+	// Prometheus
+	file = tmpfile();
+	TEST_ASSERT(dm_stats_dump(fileno(file), DM_STATS_PROMETHEUS));
+	read_all(file, buffer, sizeof(buffer));
+	TEST_ASSERT(strstr(buffer, "dm_call_duration_ns{call=\"insert_record\",quantile=\"0.99\"}") != NULL);
+	TEST_ASSERT(strstr(buffer, "dm_call_duration_ns_count{call=\"count_records\"}") != NULL);
+	fclose(file);
+
+	// Λάθος μορφή ή fd
+	TEST_ASSERT(!dm_stats_dump(STDOUT_FILENO, 42));
+	TEST_ASSERT(!dm_stats_dump(-1, DM_STATS_JSON));
+
+	dm_destroy();
+	dm_stats_reset();
+}
+
+
 // Λίστα με όλα τα tests προς εκτέλεση
 TEST_LIST = {
 	{ "dm_init", test_init },
 	{ "dm_insert_record", test_insert },
 	{ "dm_remove_record", test_remove },
 	{ "dm_get_records", test_get_records },
+	{ "dm_records_cursor", test_records_cursor },
 	{ "dm_count_records", test_count_records },
+	{ "dm_count_records_by_day", test_count_records_by_day },
 	{ "dm_top_diseases", test_top_diseases },
+	{ "dm_top_diseases_range", test_top_diseases_range },
+	{ "dm_percentile_date", test_percentile_date },
+	{ "monitor_disease_cases", test_disease_cases },
+	{ "dm_create", test_multiple_monitors },
+	{ "dm_create_concurrent", test_concurrent },
+	{ "dm_snapshot", test_snapshot },
+	{ "dm_save_load", test_save_load },
+	{ "dm_ingest_csv", test_ingest_csv },
+	{ "dm_create_owning", test_owning },
+	{ "dm_count_where", test_count_where },
+	{ "dm_stats_dump", test_stats_dump },
 
 	{ NULL, NULL } // τερματίζουμε τη λίστα με NULL
 };
\ No newline at end of file
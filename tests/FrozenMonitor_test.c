@@ -0,0 +1,134 @@
+//////////////////////////////////////////////////////////////////
+//
+// Unit tests for FrozenMonitor.h
+//
+//////////////////////////////////////////////////////////////////
+
+#include "acutest.h"			// Απλή βιβλιοθήκη για unit testing
+#include <stdio.h>
+#include <string.h>
+
+#include "FrozenMonitor.h"
+#include "test_records.h"
+
+#define RECORD_NO 3000
+
+static char* path = "FrozenMonitor_test.dat";
+
+static struct record records[RECORD_NO];
+static char dates[RECORD_NO][11];
+
+void test_empty(void) {
+	DiseaseMonitor monitor = dm_create();
+	TEST_ASSERT(frozen_build(monitor, path));
+	dm_free(monitor);
+
+	FrozenMonitor frozen = frozen_open(path);
+	TEST_ASSERT(frozen != NULL);
+	TEST_ASSERT(frozen_count_records(frozen, NULL, NULL, NULL, NULL) == 0);
+	TEST_ASSERT(frozen_count_records(frozen, "Grayscale", "Stark", NULL, NULL) == 0);
+
+	List list = frozen_top_diseases(frozen, 3, NULL);
+	TEST_ASSERT(list_size(list) == 0);
+	list_destroy(list);
+
+	frozen_close(frozen);
+	remove(path);
+}
+
+void test_queries(void) {
+	test_records_create(records, dates, RECORD_NO);
+
+	DiseaseMonitor monitor = dm_create();
+	for (int i = 0; i < RECORD_NO; i++)
+		monitor_insert_record(monitor, &records[i]);
+	for (int i = 0; i < RECORD_NO; i += 5)
+		monitor_remove_record(monitor, i);
+
+	TEST_ASSERT(frozen_build(monitor, path));
+	FrozenMonitor frozen = frozen_open(path);
+	TEST_ASSERT(frozen != NULL);
+
+	// Μετά το build το monitor μπορεί να αλλάζει χωρίς να επηρεάζεται το αρχείο
+	monitor_insert_record(monitor, &records[0]);
+	monitor_remove_record(monitor, 0);
+
+	Date bounds[] = { NULL, "2000-01-01", "2000-06-15", "2001-02-28", "2002-12-31", "2003-01-01" };
+	int bound_no = sizeof(bounds) / sizeof(Date);
+
+	for (int c = -1; c < test_country_no; c++) {
+		String country = c == -1 ? NULL : test_countries[c];
+
+		for (int d = -1; d < test_disease_no; d++) {
+			String disease = d == -1 ? NULL : test_diseases[d];
+
+			for (int f = 0; f < bound_no; f++)
+				for (int t = 0; t < bound_no; t++)
+					TEST_ASSERT(frozen_count_records(frozen, disease, country, bounds[f], bounds[t]) ==
+								monitor_count_records(monitor, disease, country, bounds[f], bounds[t]));
+		}
+
+		// Οι ασθένειες πρέπει να είναι ταξινομημένες με τα ίδια πλήθη (με ισοβαθμίες η σειρά μπορεί να διαφέρει)
+		List top = frozen_top_diseases(frozen, 4, country);
+		List expected = monitor_top_diseases(monitor, 4, country);
+		TEST_ASSERT(list_size(top) == list_size(expected));
+
+		for (ListNode node = list_first(top), exp = list_first(expected); node != LIST_EOF;
+			 node = list_next(top, node), exp = list_next(expected, exp))
+			TEST_ASSERT(monitor_count_records(monitor, list_node_value(top, node), country, NULL, NULL) ==
+						monitor_count_records(monitor, list_node_value(expected, exp), country, NULL, NULL));
+
+		list_destroy(top);
+		list_destroy(expected);
+	}
+
+	// Αγνωστες χώρες/ασθένειες
+	TEST_ASSERT(frozen_count_records(frozen, "Unknown", NULL, NULL, NULL) == 0);
+	TEST_ASSERT(frozen_count_records(frozen, NULL, "Unknown", NULL, NULL) == 0);
+	List list = frozen_top_diseases(frozen, 3, "Unknown");
+	TEST_ASSERT(list_size(list) == 0);
+	list_destroy(list);
+
+	frozen_close(frozen);
+	dm_free(monitor);
+	remove(path);
+}
+
+void test_invalid(void) {
+	TEST_ASSERT(frozen_open("does_not_exist.dat") == NULL);
+
+	// Αρχείο που δεν είναι frozen monitor
+	FILE* file = fopen(path, "wb");
+	fputs("not a frozen monitor, just some text that is long enough for a header", file);
+	fclose(file);
+	TEST_ASSERT(frozen_open(path) == NULL);
+
+	// Κομμένο αρχείο
+	DiseaseMonitor monitor = dm_create();
+	test_records_create(records, dates, RECORD_NO);
+	for (int i = 0; i < 100; i++)
+		monitor_insert_record(monitor, &records[i]);
+	TEST_ASSERT(frozen_build(monitor, path));
+	dm_free(monitor);
+
+	file = fopen(path, "rb");
+	char buffer[16384];
+	size_t size = fread(buffer, 1, sizeof(buffer), file);
+	fclose(file);
+
+	file = fopen(path, "wb");
+	fwrite(buffer, 1, size - 4, file);
+	fclose(file);
+	TEST_ASSERT(frozen_open(path) == NULL);
+
+	remove(path);
+}
+
+
+// Λίστα με όλα τα tests προς εκτέλεση
+TEST_LIST = {
+	{ "frozen_empty", test_empty },
+	{ "frozen_queries", test_queries },
+	{ "frozen_open_invalid", test_invalid },
+	{ NULL, NULL } // τερματίζουμε τη λίστα με NULL
+};
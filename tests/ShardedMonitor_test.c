@@ -0,0 +1,144 @@
+//////////////////////////////////////////////////////////////////
+//
+// Unit tests for ShardedMonitor.h
+//
+//////////////////////////////////////////////////////////////////
+
+#include "acutest.h"			// Απλή βιβλιοθήκη για unit testing
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "ShardedMonitor.h"
+#include "test_records.h"
+
+#define RECORD_NO 4000
+#define PRODUCERS 4
+
+static struct record records[RECORD_NO];
+static char dates[RECORD_NO][11];
+
+struct producer {
+	ShardedMonitor monitor;
+	int from, to;
+};
+
+// Κάθε producer εισάγει τις εγγραφές [from, to)
+
+static void* producer_thread(void* arg) {
+	struct producer* producer = arg;
+	for (int i = producer->from; i < producer->to; i++)
+		sharded_insert_record(producer->monitor, &records[i]);
+	return NULL;
+}
+
+// Ελέγχει ότι τα queries του sharded monitor δίνουν ίδια αποτελέσματα με ένα απλό DiseaseMonitor
+
+static void compare_with(ShardedMonitor sharded, DiseaseMonitor monitor) {
+
+	for (int c = -1; c < test_country_no; c++) {
+		String country = c == -1 ? NULL : test_countries[c];
+
+		for (int d = -1; d < test_disease_no; d++) {
+			String disease = d == -1 ? NULL : test_diseases[d];
+
+			TEST_ASSERT(sharded_count_records(sharded, disease, country, NULL, NULL) ==
+						monitor_count_records(monitor, disease, country, NULL, NULL));
+			TEST_ASSERT(sharded_count_records(sharded, disease, country, "2001-01-01", "2001-06-30") ==
+						monitor_count_records(monitor, disease, country, "2001-01-01", "2001-06-30"));
+
+			List list = sharded_get_records(sharded, disease, country, "2000-03-01", NULL);
+			TEST_ASSERT(list_size(list) == monitor_count_records(monitor, disease, country, "2000-03-01", NULL));
+			list_destroy(list);
+		}
+
+		// Οι πρώτες ασθένειες πρέπει να έχουν τα ίδια πλήθη (με ισοβαθμίες η σειρά μπορεί να διαφέρει)
+		List top = sharded_top_diseases(sharded, 3, country);
+		List expected = monitor_top_diseases(monitor, 3, country);
+		TEST_ASSERT(list_size(top) == list_size(expected));
+
+		for (ListNode node = list_first(top), exp = list_first(expected); node != LIST_EOF;
+			 node = list_next(top, node), exp = list_next(expected, exp))
+			TEST_ASSERT(monitor_count_records(monitor, list_node_value(top, node), country, NULL, NULL) ==
+						monitor_count_records(monitor, list_node_value(expected, exp), country, NULL, NULL));
+
+		list_destroy(top);
+		list_destroy(expected);
+	}
+}
+
+void test_create(void) {
+	ShardedMonitor sharded = sharded_create(4);
+	TEST_ASSERT(sharded != NULL);
+	TEST_ASSERT(sharded_shards(sharded) == 4);
+
+	sharded_flush(sharded);
+	TEST_ASSERT(sharded_count_records(sharded, NULL, NULL, NULL, NULL) == 0);
+
+	List list = sharded_top_diseases(sharded, 3, NULL);
+	TEST_ASSERT(list_size(list) == 0);
+	list_destroy(list);
+
+	sharded_destroy(sharded);
+}
+
+void test_insert(void) {
+	test_records_create(records, dates, RECORD_NO);
+
+	ShardedMonitor sharded = sharded_create(3);
+	DiseaseMonitor monitor = dm_create();
+
+	// Εισαγωγή από πολλά threads ταυτόχρονα
+	pthread_t threads[PRODUCERS];
+	struct producer producers[PRODUCERS];
+	for (int i = 0; i < PRODUCERS; i++) {
+		producers[i] = (struct producer) { sharded, i * RECORD_NO / PRODUCERS, (i + 1) * RECORD_NO / PRODUCERS };
+		pthread_create(&threads[i], NULL, producer_thread, &producers[i]);
+	}
+	for (int i = 0; i < PRODUCERS; i++)
+		pthread_join(threads[i], NULL);
+
+	for (int i = 0; i < RECORD_NO; i++)
+		monitor_insert_record(monitor, &records[i]);
+
+	sharded_flush(sharded);
+	TEST_ASSERT(sharded_count_records(sharded, NULL, NULL, NULL, NULL) == RECORD_NO);
+	compare_with(sharded, monitor);
+
+	sharded_destroy(sharded);
+	dm_free(monitor);
+}
+
+void test_remove(void) {
+	test_records_create(records, dates, RECORD_NO);
+
+	ShardedMonitor sharded = sharded_create(5);
+	DiseaseMonitor monitor = dm_create();
+
+	for (int i = 0; i < RECORD_NO; i++) {
+		sharded_insert_record(sharded, &records[i]);
+		monitor_insert_record(monitor, &records[i]);
+	}
+
+	// Οι αφαιρέσεις εφαρμόζονται μετά τις προσθήκες του ίδιου shard
+	for (int i = 0; i < RECORD_NO; i += 3) {
+		sharded_remove_record(sharded, i);
+		monitor_remove_record(monitor, i);
+	}
+
+	sharded_flush(sharded);
+	TEST_ASSERT(sharded_count_records(sharded, NULL, NULL, NULL, NULL) == RECORD_NO - (RECORD_NO + 2) / 3);
+	compare_with(sharded, monitor);
+
+	sharded_destroy(sharded);
+	dm_free(monitor);
+}
+
+
+// Λίστα με όλα τα tests προς εκτέλεση
+TEST_LIST = {
+	{ "sharded_create", test_create },
+	{ "sharded_insert_record", test_insert },
+	{ "sharded_remove_record", test_remove },
+	{ NULL, NULL } // τερματίζουμε τη λίστα με NULL
+};
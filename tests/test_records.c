@@ -0,0 +1,30 @@
+//////////////////////////////////////////////////////////////////
+//
+// Κοινές εγγραφές για τα tests των monitors
+//
+//////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "test_records.h"
+
+String test_countries[] = { "Targaryen", "Lannister", "Stark", "Greyjoy", "Martell", "Baratheon", "Mormont" };
+int test_country_no = sizeof(test_countries) / sizeof(String);
+
+String test_diseases[] = { "Grayscale", "Pale Mare", "Headache", "Madness", "Burns" };
+int test_disease_no = sizeof(test_diseases) / sizeof(String);
+
+void test_records_create(struct record records[], char dates[][11], int n) {
+	srand(1);
+	for (int i = 0; i < n; i++) {
+		sprintf(dates[i], "%04d-%02d-%02d", 2000 + rand() % 3, 1 + rand() % 12, 1 + rand() % 28);
+		records[i] = (struct record) {
+			.id = i,
+			.name = "Name",
+			.country = test_countries[rand() % test_country_no],
+			.disease = test_diseases[rand() % test_disease_no],
+			.date = dates[i],
+		};
+	}
+}
@@ -0,0 +1,25 @@
+//////////////////////////////////////////////////////////////////
+//
+// Κοινές εγγραφές για τα tests των monitors (ShardedMonitor,
+// FrozenMonitor), που χρειάζονται πολλές εγγραφές με ποικιλία
+// χωρών, ασθενειών και ημερομηνιών.
+//
+//////////////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include "DiseaseMonitor.h"
+
+// Οι χώρες και οι ασθένειες από τις οποίες επιλέγονται οι εγγραφές
+
+extern String test_countries[];
+extern int test_country_no;
+
+extern String test_diseases[];
+extern int test_disease_no;
+
+// Γεμίζει τον πίνακα records με n εγγραφές (ids 0 μέχρι n-1) με ψευδοτυχαία χώρα, ασθένεια και
+// ημερομηνία (2000-2002). Οι ημερομηνίες γράφονται στον πίνακα dates, επίσης με n θέσεις. Οι
+// εγγραφές είναι ίδιες σε κάθε κλήση.
+
+void test_records_create(struct record records[], char dates[][11], int n);